@@ -0,0 +1,306 @@
+#include "AnimationCache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+
+static_assert(sizeof(AnimationCacheHeader) == 40 && sizeof(AnimationCacheIndexEntry) == 16, "animation cache header/index layout changed (bump s_VERSION)");
+
+
+namespace {
+	char const s_MAGIC[8] = { 'C', 'A', 'G', 'E', 'A', 'N', 'I', 'M' };
+	uint32_t const s_VERSION = 1;
+	float const s_QUANTIZATION_STEPS = 65535.0f; // 16 bits per component
+
+	// chunk header: frame count (uint32), then the quantization box min/max (2 vec3)
+	size_t const s_CHUNK_HEADER_SIZE = sizeof(uint32_t) + 2 * sizeof(glm::vec3);
+
+	// small magnitudes (of either sign) become small unsigned values: 0, -1, 1, -2, 2... -> 0, 1, 2, 3, 4...
+	uint32_t zigzag(int32_t const value) {
+		return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+	}
+
+	int32_t unzigzag(uint32_t const value) {
+		return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+	}
+
+	// 7 bits per byte, the high bit marks that more bytes follow
+	void writeVarint(uint32_t value, std::vector<uint8_t> &out_bytes) {
+		while (value >= 0x80) {
+			out_bytes.push_back((uint8_t)(value | 0x80));
+			value >>= 7;
+		}
+		out_bytes.push_back((uint8_t)value);
+	}
+
+	// RETURNS nullptr if the varint runs past end (or is longer than a uint32 can be)
+	uint8_t const* readVarint(uint8_t const* in, uint8_t const* const end, uint32_t &out_value) {
+		out_value = 0;
+		for (unsigned int shift = 0; shift < 35 && in < end; shift += 7) {
+			uint8_t const byte = *in++;
+			out_value |= (uint32_t)(byte & 0x7F) << shift;
+			if (0 == (byte & 0x80)) return in;
+		}
+		return nullptr;
+	}
+}
+
+
+bool AnimationCacheWriter::open(std::string const& filePath, unsigned int const vertCount, unsigned int const framesPerChunk) {
+	close();
+	if (0 == vertCount || 0 == framesPerChunk) return false;
+
+	m_file = fopen(filePath.c_str(), "wbx"); // like the exporters, existing files never get overwritten
+	if (nullptr == m_file) return false;
+
+	// placeholder header, the real one gets written by close()
+	AnimationCacheHeader header = {};
+	if (1 != fwrite(&header, sizeof(header), 1, m_file)) {
+		fclose(m_file);
+		m_file = nullptr;
+		return false;
+	}
+
+	m_vertCount = vertCount;
+	m_framesPerChunk = framesPerChunk;
+	m_frameCount = 0;
+	m_chunk = Chunk();
+	m_chunk.m_verts.reserve((size_t)vertCount * framesPerChunk);
+
+	m_queue.clear();
+	m_isClosing = false;
+	m_isFailed = false;
+	m_index.clear();
+	m_fileSize = sizeof(header);
+	m_encoder = std::thread(&AnimationCacheWriter::encodeLoop, this);
+	return true;
+}
+
+
+bool AnimationCacheWriter::addFrame(std::vector<glm::vec3> const& verts) {
+	if (!isOpen() || verts.size() != m_vertCount) return false;
+
+	m_chunk.m_verts.insert(m_chunk.m_verts.end(), verts.begin(), verts.end());
+	++m_chunk.m_frameCount;
+	++m_frameCount;
+
+	if (m_chunk.m_frameCount == m_framesPerChunk) queueChunk();
+	return true;
+}
+
+
+void AnimationCacheWriter::queueChunk() {
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_condition.wait(lock, [this]() { return m_queue.size() < s_MAX_QUEUED_CHUNKS; });
+		m_queue.push_back(std::move(m_chunk));
+	}
+	m_condition.notify_all();
+
+	m_chunk = Chunk();
+	m_chunk.m_verts.reserve((size_t)m_vertCount * m_framesPerChunk);
+}
+
+
+bool AnimationCacheWriter::close() {
+	if (!isOpen()) return false;
+
+	// 1. let the encoder finish every chunk...
+	if (0 != m_chunk.m_frameCount) queueChunk();
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_isClosing = true;
+	}
+	m_condition.notify_all();
+	m_encoder.join();
+
+	// 2. ...then append the index and fill in the header
+	AnimationCacheHeader header = {};
+	std::memcpy(header.m_magic, s_MAGIC, sizeof(s_MAGIC));
+	header.m_version = s_VERSION;
+	header.m_vertCount = m_vertCount;
+	header.m_frameCount = m_frameCount;
+	header.m_framesPerChunk = m_framesPerChunk;
+	header.m_chunkCount = (uint32_t)m_index.size();
+	header.m_indexOffset = m_fileSize;
+
+	bool isWritten = !m_isFailed;
+	if (!m_index.empty()) isWritten = isWritten && m_index.size() == fwrite(m_index.data(), sizeof(AnimationCacheIndexEntry), m_index.size(), m_file);
+	isWritten = isWritten && 0 == fseek(m_file, 0, SEEK_SET);
+	isWritten = isWritten && 1 == fwrite(&header, sizeof(header), 1, m_file);
+	bool const isClosed = 0 == fclose(m_file);
+
+	m_file = nullptr;
+	m_chunk = Chunk();
+	m_index.clear();
+	return isWritten && isClosed;
+}
+
+
+void AnimationCacheWriter::encodeLoop() {
+	std::vector<uint8_t> bytes;
+	while (true) {
+		Chunk chunk;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_condition.wait(lock, [this]() { return !m_queue.empty() || m_isClosing; });
+			if (m_queue.empty()) return; // closing, and nothing left to encode
+
+			chunk = std::move(m_queue.front());
+			m_queue.pop_front();
+		}
+		m_condition.notify_all(); // there is room in the queue again
+
+		encodeChunk(chunk, bytes);
+
+		//NOTE: only this thread touches m_file/m_index/m_fileSize/m_isFailed until close() joins it
+		if (m_isFailed) continue;
+		if (bytes.size() != fwrite(bytes.data(), 1, bytes.size(), m_file)) {
+			m_isFailed = true;
+			continue;
+		}
+		m_index.push_back(AnimationCacheIndexEntry{ m_fileSize, bytes.size() });
+		m_fileSize += bytes.size();
+	}
+}
+
+
+void AnimationCacheWriter::encodeChunk(Chunk const& chunk, std::vector<uint8_t> &out_bytes) const {
+	// 1. quantization box over all frames of the chunk...
+	glm::vec3 minCorner = chunk.m_verts.at(0);
+	glm::vec3 maxCorner = chunk.m_verts.at(0);
+	for (glm::vec3 const& vert : chunk.m_verts) {
+		minCorner = glm::min(minCorner, vert);
+		maxCorner = glm::max(maxCorner, vert);
+	}
+	glm::vec3 const extent = maxCorner - minCorner;
+
+	out_bytes.resize(s_CHUNK_HEADER_SIZE);
+	uint32_t const frameCount = chunk.m_frameCount;
+	std::memcpy(out_bytes.data(), &frameCount, sizeof(uint32_t));
+	std::memcpy(out_bytes.data() + sizeof(uint32_t), &minCorner, sizeof(glm::vec3));
+	std::memcpy(out_bytes.data() + sizeof(uint32_t) + sizeof(glm::vec3), &maxCorner, sizeof(glm::vec3));
+
+	// 2. every frame, 1 component at a time (x of every vert, then y, then z)...
+	//NOTE: the prediction of a value is the same vert in the previous frame, or (in the chunk's first frame) the previous vert
+	std::vector<int32_t> previousFrame(3 * (size_t)m_vertCount, 0);
+	for (unsigned int f = 0; f < chunk.m_frameCount; ++f) {
+		glm::vec3 const* frame = chunk.m_verts.data() + (size_t)f * m_vertCount;
+
+		for (int c = 0; c < 3; ++c) {
+			float const scale = (extent[c] > 0.0f) ? s_QUANTIZATION_STEPS / extent[c] : 0.0f;
+			int32_t *previous = previousFrame.data() + (size_t)c * m_vertCount;
+
+			int32_t previousVert = 0;
+			for (unsigned int v = 0; v < m_vertCount; ++v) {
+				int32_t const value = (int32_t)std::lround((frame[v][c] - minCorner[c]) * scale);
+				int32_t const prediction = (0 == f) ? previousVert : previous[v];
+				writeVarint(zigzag(value - prediction), out_bytes);
+
+				previous[v] = value;
+				previousVert = value;
+			}
+		}
+	}
+}
+
+
+bool AnimationCacheReader::open(std::string const& filePath) {
+	close();
+	if (!m_file.open(filePath)) return false;
+
+	// header + index (everything is bounds checked, so a truncated/unfinished cache just fails to open)...
+	if (m_file.getSize() < sizeof(AnimationCacheHeader)) {
+		close();
+		return false;
+	}
+	std::memcpy(&m_header, m_file.getData(), sizeof(AnimationCacheHeader));
+	bool isValid = 0 == std::memcmp(m_header.m_magic, s_MAGIC, sizeof(s_MAGIC)) && s_VERSION == m_header.m_version;
+	isValid = isValid && 0 != m_header.m_vertCount && 0 != m_header.m_framesPerChunk;
+	isValid = isValid && m_header.m_chunkCount == (m_header.m_frameCount + m_header.m_framesPerChunk - 1) / m_header.m_framesPerChunk;
+	isValid = isValid && sizeof(AnimationCacheHeader) <= m_header.m_indexOffset && m_header.m_indexOffset <= m_file.getSize();
+	isValid = isValid && (m_file.getSize() - m_header.m_indexOffset) / sizeof(AnimationCacheIndexEntry) >= m_header.m_chunkCount;
+	if (!isValid) {
+		close();
+		return false;
+	}
+
+	m_index.resize(m_header.m_chunkCount);
+	if (!m_index.empty()) std::memcpy(m_index.data(), m_file.getData() + m_header.m_indexOffset, m_index.size() * sizeof(AnimationCacheIndexEntry));
+	for (AnimationCacheIndexEntry const& entry : m_index) {
+		if (entry.m_offset > m_header.m_indexOffset || entry.m_size > m_header.m_indexOffset - entry.m_offset || entry.m_size < s_CHUNK_HEADER_SIZE) {
+			close();
+			return false;
+		}
+	}
+
+	m_values.assign(3 * (size_t)m_header.m_vertCount, 0);
+	return true;
+}
+
+
+void AnimationCacheReader::close() {
+	m_file.close();
+	m_header = AnimationCacheHeader();
+	m_index.clear();
+	m_decodedChunk = 0xFFFFFFFF;
+	m_values.clear();
+}
+
+
+bool AnimationCacheReader::readFrame(unsigned int const frame, std::vector<glm::vec3> &out_verts) {
+	if (!isOpen() || frame >= m_header.m_frameCount) return false;
+
+	unsigned int const chunk = frame / m_header.m_framesPerChunk;
+	unsigned int const frameInChunk = frame % m_header.m_framesPerChunk;
+	AnimationCacheIndexEntry const& entry = m_index[chunk];
+	uint8_t const* const chunkBegin = (uint8_t const*)m_file.getData() + entry.m_offset;
+	uint8_t const* const chunkEnd = chunkBegin + entry.m_size;
+
+	uint32_t chunkFrameCount = 0;
+	glm::vec3 minCorner;
+	glm::vec3 maxCorner;
+	std::memcpy(&chunkFrameCount, chunkBegin, sizeof(uint32_t));
+	std::memcpy(&minCorner, chunkBegin + sizeof(uint32_t), sizeof(glm::vec3));
+	std::memcpy(&maxCorner, chunkBegin + sizeof(uint32_t) + sizeof(glm::vec3), sizeof(glm::vec3));
+	if (frameInChunk >= chunkFrameCount) return false;
+
+	// 1. continue from the last decoded frame if it is an earlier frame of the same chunk, otherwise start at the chunk's first frame...
+	if (chunk != m_decodedChunk || frameInChunk < m_decodedFrame) {
+		m_decodedChunk = 0xFFFFFFFF;
+		m_decodedFrame = 0;
+		m_decodedBytes = s_CHUNK_HEADER_SIZE;
+	}
+
+	uint8_t const* in = chunkBegin + m_decodedBytes;
+	for (unsigned int f = (0xFFFFFFFF == m_decodedChunk) ? 0 : m_decodedFrame + 1; f <= frameInChunk; ++f) {
+		for (int c = 0; c < 3; ++c) {
+			int32_t *values = m_values.data() + (size_t)c * m_header.m_vertCount;
+
+			int32_t previousVert = 0;
+			for (unsigned int v = 0; v < m_header.m_vertCount; ++v) {
+				uint32_t delta = 0;
+				in = readVarint(in, chunkEnd, delta);
+				if (nullptr == in) {
+					m_decodedChunk = 0xFFFFFFFF;
+					return false;
+				}
+
+				values[v] = ((0 == f) ? previousVert : values[v]) + unzigzag(delta);
+				previousVert = values[v];
+			}
+		}
+		m_decodedChunk = chunk;
+		m_decodedFrame = f;
+		m_decodedBytes = in - chunkBegin;
+	}
+
+	// 2. dequantize...
+	glm::vec3 const step = (maxCorner - minCorner) / s_QUANTIZATION_STEPS;
+	out_verts.resize(m_header.m_vertCount);
+	for (unsigned int v = 0; v < m_header.m_vertCount; ++v) {
+		for (int c = 0; c < 3; ++c) out_verts[v][c] = minCorner[c] + (float)m_values[(size_t)c * m_header.m_vertCount + v] * step[c];
+	}
+	return true;
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "MappedFile.h"
+
+
+// chunked binary cache of a vertex animation (every frame of a deformation sequence), e.g. for offline rendering
+// layout: header, chunks, then an index of where every chunk is in the file (so any frame can be found without scanning)
+// every chunk holds up to framesPerChunk frames, encoded as...
+// 1. positions quantized to 16 bits per component, relative to the bounding box of the chunk's frames
+// 2. the first frame delta encoded vert to vert, every later frame delta encoded against the previous frame
+// 3. the deltas zigzag + varint coded (coherent motion makes most of them fit in 1 byte instead of 2)
+//NOTE: frames only depend on frames of their own chunk, so random access decodes at most framesPerChunk frames
+//NOTE: native (little-endian) byte order, like MeshCache
+struct AnimationCacheHeader {
+	char m_magic[8];
+	uint32_t m_version;
+	uint32_t m_vertCount;
+	uint32_t m_frameCount;
+	uint32_t m_framesPerChunk;
+	uint32_t m_chunkCount;
+	uint32_t m_padding;
+	uint64_t m_indexOffset; // bytes from the start of the file (0 until the cache is closed)
+};
+
+// where a chunk is in the file
+struct AnimationCacheIndexEntry {
+	uint64_t m_offset; // bytes from the start of the file
+	uint64_t m_size; // bytes
+};
+
+
+// encodes + writes the frames on a background thread, so recording barely slows down the deformation producing them
+class AnimationCacheWriter {
+
+public:
+	AnimationCacheWriter() = default;
+	~AnimationCacheWriter() { close(); }
+
+	AnimationCacheWriter(AnimationCacheWriter const&) = delete;
+	AnimationCacheWriter& operator=(AnimationCacheWriter const&) = delete;
+
+	// RETURNS false if the file could not be created (or already exists)
+	bool open(std::string const& filePath, unsigned int const vertCount, unsigned int const framesPerChunk = 32);
+
+	// RETURNS false if the writer isn't open or verts doesn't have vertCount verts
+	//NOTE: the frame gets copied, the caller can change verts right away (this only blocks if the encoder falls s_MAX_QUEUED_CHUNKS behind)
+	bool addFrame(std::vector<glm::vec3> const& verts);
+
+	// encodes whatever is left, then writes the index and the final header
+	// RETURNS false if anything failed to be written (the file is then incomplete)
+	bool close();
+
+	bool isOpen() const { return nullptr != m_file; }
+	unsigned int getFrameCount() const { return m_frameCount; }
+
+private:
+	static size_t const s_MAX_QUEUED_CHUNKS = 4;
+
+	struct Chunk {
+		std::vector<glm::vec3> m_verts; // frame after frame
+		unsigned int m_frameCount = 0;
+	};
+
+	FILE *m_file = nullptr;
+	unsigned int m_vertCount = 0;
+	unsigned int m_framesPerChunk = 0;
+	unsigned int m_frameCount = 0;
+	Chunk m_chunk; // being filled by addFrame
+
+	// handed over to (and only touched by) the encoder thread...
+	std::thread m_encoder;
+	std::mutex m_mutex;
+	std::condition_variable m_condition; // signalled when a chunk is queued, dequeued, or the writer is closing
+	std::deque<Chunk> m_queue;
+	bool m_isClosing = false;
+	bool m_isFailed = false;
+	std::vector<AnimationCacheIndexEntry> m_index;
+	uint64_t m_fileSize = 0;
+
+	void queueChunk();
+	void encodeLoop();
+	void encodeChunk(Chunk const& chunk, std::vector<uint8_t> &out_bytes) const;
+};
+
+
+// random access to the frames of an animation cache (memory mapped)
+//NOTE: the last decoded frame is kept, so stepping forward through a chunk (playback, scrubbing) only decodes 1 frame per step
+class AnimationCacheReader {
+
+public:
+	// RETURNS false if the file isn't a (complete) animation cache
+	bool open(std::string const& filePath);
+	void close();
+
+	bool isOpen() const { return m_file.isOpen(); }
+	unsigned int getFrameCount() const { return m_header.m_frameCount; }
+	unsigned int getVertexCount() const { return m_header.m_vertCount; }
+
+	// RETURNS false if frame is out of range or its chunk is corrupt
+	bool readFrame(unsigned int const frame, std::vector<glm::vec3> &out_verts);
+
+private:
+	MappedFile m_file;
+	AnimationCacheHeader m_header = {};
+	std::vector<AnimationCacheIndexEntry> m_index;
+
+	// decoder state (quantized values of the last decoded frame)...
+	unsigned int m_decodedChunk = 0xFFFFFFFF;
+	unsigned int m_decodedFrame = 0; // within m_decodedChunk
+	size_t m_decodedBytes = 0; // of m_decodedChunk's data
+	std::vector<int32_t> m_values; // x of every vert, then y, then z
+};
@@ -0,0 +1,427 @@
+#include "BVH.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include "ParallelTools.h"
+
+namespace {
+	unsigned int const s_MAX_DEPTH = 64; // deeper ranges become leaves, so a traversal stack of s_MAX_DEPTH + 1 entries never overflows
+	unsigned int const s_MIN_PARALLEL_SUBTREE_SIZE = 4096; // smaller subtrees aren't worth splitting off on the calling thread
+
+	// entry distance of the ray into box (> maxT if it misses)
+	float intersectBox(glm::vec3 const& origin, glm::vec3 const& inverseDirection, glm::vec3 const& boxMin, glm::vec3 const& boxMax, float const maxT) {
+		glm::vec3 const t0 = (boxMin - origin) * inverseDirection;
+		glm::vec3 const t1 = (boxMax - origin) * inverseDirection;
+		glm::vec3 const tNear = glm::min(t0, t1);
+		glm::vec3 const tFar = glm::max(t0, t1);
+		float const entry = glm::max(glm::max(tNear.x, tNear.y), glm::max(tNear.z, 0.0f));
+		float const exit = glm::min(glm::min(tFar.x, tFar.y), glm::min(tFar.z, maxT));
+		//NOTE: NaNs (0 * inf for rays in the plane of a box side) fail both comparisons, so such boxes count as hit
+		return entry > exit ? std::numeric_limits<float>::max() : entry;
+	}
+}
+
+
+bool BVH::build(std::vector<glm::vec3> const& verts, std::vector<unsigned int> const& faceIndices, unsigned int const maxLeafSize) {
+	m_nodes.clear();
+	m_faceIndices = faceIndices;
+	m_faceOrder.clear();
+	m_triangleVerts.clear();
+
+	unsigned int const faceCount = (unsigned int)(faceIndices.size() / 3);
+	if (0 == faceCount) return false;
+
+	// 1. per face bounds + centroids...
+	std::vector<AABB> faceBounds(faceCount);
+	std::vector<glm::vec3> faceCentroids(faceCount);
+	ParallelTools::parallelFor(faceCount, [&](size_t const f) {
+		AABB box;
+		for (unsigned int c = 0; c < 3; ++c) box.grow(verts[faceIndices[3 * f + c]]);
+		faceBounds[f] = box;
+		faceCentroids[f] = 0.5f * (box.m_min + box.m_max);
+	});
+
+	m_faceOrder.resize(faceCount);
+	std::iota(m_faceOrder.begin(), m_faceOrder.end(), 0u);
+
+	m_nodes.reserve(2 * faceCount);
+	m_nodes.push_back(Node());
+	setBounds(m_nodes.at(0), 0, faceCount, faceBounds);
+
+	// 2. top of the tree (largest range first, until there is enough work for every thread)...
+	struct Range {
+		unsigned int m_nodeIndex;
+		unsigned int m_first;
+		unsigned int m_count;
+		unsigned int m_depth;
+	};
+	std::vector<Range> ranges = { { 0, 0, faceCount, 0 } };
+	size_t const targetRangeCount = ParallelTools::getThreadCount() > 1 ? 4 * ParallelTools::getThreadCount() : 1;
+	while (ranges.size() < targetRangeCount) {
+		auto const largest = std::max_element(ranges.begin(), ranges.end(), [](Range const& r0, Range const& r1) { return r0.m_count < r1.m_count; });
+		if (largest->m_count < s_MIN_PARALLEL_SUBTREE_SIZE) break;
+
+		Range const range = *largest;
+		unsigned int leftCount = 0;
+		if (!splitRange(range.m_first, range.m_count, faceBounds, faceCentroids, maxLeafSize, leftCount)) break; // left to the subtree build, which turns it into a leaf
+
+		ranges.erase(largest);
+		unsigned int const childIndex = (unsigned int)m_nodes.size();
+		m_nodes.at(range.m_nodeIndex).m_offset = childIndex;
+		m_nodes.at(range.m_nodeIndex).m_count = 0;
+		m_nodes.push_back(Node());
+		m_nodes.push_back(Node());
+		setBounds(m_nodes.at(childIndex), range.m_first, leftCount, faceBounds);
+		setBounds(m_nodes.at(childIndex + 1), range.m_first + leftCount, range.m_count - leftCount, faceBounds);
+		ranges.push_back({ childIndex, range.m_first, leftCount, range.m_depth + 1 });
+		ranges.push_back({ childIndex + 1, range.m_first + leftCount, range.m_count - leftCount, range.m_depth + 1 });
+	}
+
+	// 3. subtrees in parallel (each into its own node vector, rooted at index 0)...
+	std::vector<std::vector<Node>> subtrees(ranges.size());
+	ParallelTools::parallelFor(ranges.size(), [&](size_t const r) {
+		Range const& range = ranges[r];
+		subtrees[r].push_back(m_nodes[range.m_nodeIndex]);
+		buildSubtree(subtrees[r], 0, range.m_first, range.m_count, range.m_depth, faceBounds, faceCentroids, maxLeafSize);
+	}, 1);
+
+	// ...appended behind the top of the tree (subtree node k > 0 ends up at base + k - 1)
+	for (size_t r = 0; r < ranges.size(); ++r) {
+		std::vector<Node> &subtree = subtrees.at(r);
+		unsigned int const base = (unsigned int)m_nodes.size();
+		for (Node &node : subtree) {
+			if (!node.isLeaf()) node.m_offset = base + node.m_offset - 1;
+		}
+		m_nodes.at(ranges.at(r).m_nodeIndex) = subtree.at(0);
+		m_nodes.insert(m_nodes.end(), subtree.begin() + 1, subtree.end());
+	}
+
+	// 4. triangle verts in leaf order...
+	m_triangleVerts.resize(3 * faceCount);
+	ParallelTools::parallelFor(faceCount, [&](size_t const slot) {
+		for (unsigned int c = 0; c < 3; ++c) m_triangleVerts[3 * slot + c] = verts[faceIndices[3 * m_faceOrder[slot] + c]];
+	});
+	return true;
+}
+
+
+void BVH::buildSubtree(std::vector<Node> &nodes, unsigned int const nodeIndex, unsigned int const first, unsigned int const count, unsigned int const depth, std::vector<AABB> const& faceBounds, std::vector<glm::vec3> const& faceCentroids, unsigned int const maxLeafSize) {
+	struct Range {
+		unsigned int m_nodeIndex;
+		unsigned int m_first;
+		unsigned int m_count;
+		unsigned int m_depth;
+	};
+	std::vector<Range> stack = { { nodeIndex, first, count, depth } };
+	while (!stack.empty()) {
+		Range const range = stack.back();
+		stack.pop_back();
+
+		unsigned int leftCount = 0;
+		if (range.m_depth + 1 >= s_MAX_DEPTH || !splitRange(range.m_first, range.m_count, faceBounds, faceCentroids, maxLeafSize, leftCount)) {
+			nodes.at(range.m_nodeIndex).m_offset = range.m_first;
+			nodes.at(range.m_nodeIndex).m_count = range.m_count;
+			continue;
+		}
+
+		unsigned int const childIndex = (unsigned int)nodes.size();
+		nodes.at(range.m_nodeIndex).m_offset = childIndex;
+		nodes.at(range.m_nodeIndex).m_count = 0;
+		nodes.push_back(Node());
+		nodes.push_back(Node());
+		setBounds(nodes.at(childIndex), range.m_first, leftCount, faceBounds);
+		setBounds(nodes.at(childIndex + 1), range.m_first + leftCount, range.m_count - leftCount, faceBounds);
+		stack.push_back({ childIndex + 1, range.m_first + leftCount, range.m_count - leftCount, range.m_depth + 1 });
+		stack.push_back({ childIndex, range.m_first, leftCount, range.m_depth + 1 });
+	}
+}
+
+
+bool BVH::splitRange(unsigned int const first, unsigned int const count, std::vector<AABB> const& faceBounds, std::vector<glm::vec3> const& faceCentroids, unsigned int const maxLeafSize, unsigned int &out_leftCount) {
+	if (count <= 1) return false;
+
+	AABB centroidBounds;
+	AABB bounds;
+	for (unsigned int i = first; i < first + count; ++i) {
+		centroidBounds.grow(faceCentroids[m_faceOrder[i]]);
+		bounds.grow(faceBounds[m_faceOrder[i]]);
+	}
+	glm::vec3 const extent = centroidBounds.m_max - centroidBounds.m_min;
+	unsigned int const axis = (extent.x >= extent.y && extent.x >= extent.z) ? 0 : (extent.y >= extent.z ? 1 : 2);
+
+	auto splitInHalf = [&]() {
+		out_leftCount = count / 2;
+		std::nth_element(m_faceOrder.begin() + first, m_faceOrder.begin() + first + out_leftCount, m_faceOrder.begin() + first + count, [&faceCentroids, axis](unsigned int const f0, unsigned int const f1) {
+			return faceCentroids[f0][axis] < faceCentroids[f1][axis];
+		});
+		return true;
+	};
+
+	// all centroids in one spot - nothing for the SAH to choose from
+	if (extent[axis] <= 0.0f) {
+		if (count <= maxLeafSize) return false;
+		return splitInHalf();
+	}
+
+	// 1. bin the faces by centroid...
+	AABB binBounds[s_BIN_COUNT];
+	unsigned int binCounts[s_BIN_COUNT] = {};
+	float const binScale = s_BIN_COUNT / extent[axis];
+	auto toBin = [&](unsigned int const f) {
+		return glm::min(s_BIN_COUNT - 1, (unsigned int)((faceCentroids[f][axis] - centroidBounds.m_min[axis]) * binScale));
+	};
+	for (unsigned int i = first; i < first + count; ++i) {
+		unsigned int const f = m_faceOrder[i];
+		unsigned int const bin = toBin(f);
+		binBounds[bin].grow(faceBounds[f]);
+		++binCounts[bin];
+	}
+
+	// 2. SAH cost of the s_BIN_COUNT - 1 splits between the bins (left sweep, then right sweep)...
+	float leftCosts[s_BIN_COUNT - 1];
+	AABB leftBounds;
+	unsigned int leftCount = 0;
+	for (unsigned int b = 0; b + 1 < s_BIN_COUNT; ++b) {
+		leftBounds.grow(binBounds[b]);
+		leftCount += binCounts[b];
+		leftCosts[b] = leftBounds.getHalfArea() * leftCount;
+	}
+
+	float bestCost = std::numeric_limits<float>::max();
+	unsigned int bestSplit = 0;
+	AABB rightBounds;
+	unsigned int rightCount = 0;
+	for (unsigned int b = s_BIN_COUNT - 1; b > 0; --b) {
+		rightBounds.grow(binBounds[b]);
+		rightCount += binCounts[b];
+		if (0 == rightCount || rightCount == count) continue; // one side empty
+		float const cost = leftCosts[b - 1] + rightBounds.getHalfArea() * rightCount;
+		if (cost < bestCost) {
+			bestCost = cost;
+			bestSplit = b;
+		}
+	}
+
+	//NOTE: traversal and intersection costs are both taken as 1, so a leaf costs count and a split costs 1 + the child costs scaled by the chance of a ray hitting them
+	float const parentArea = bounds.getHalfArea();
+	float const leafCost = (float)count;
+	float const splitCost = 1.0f + (parentArea > 0.0f ? bestCost / parentArea : 0.0f);
+	if (0 == bestSplit) return count <= maxLeafSize ? false : splitInHalf();
+	if (count <= maxLeafSize && leafCost <= splitCost) return false;
+
+	// 3. partition...
+	auto const middle = std::partition(m_faceOrder.begin() + first, m_faceOrder.begin() + first + count, [&](unsigned int const f) { return toBin(f) < bestSplit; });
+	out_leftCount = (unsigned int)(middle - (m_faceOrder.begin() + first));
+	return true;
+}
+
+
+void BVH::setBounds(Node &node, unsigned int const first, unsigned int const count, std::vector<AABB> const& faceBounds) const {
+	AABB box;
+	for (unsigned int i = first; i < first + count; ++i) box.grow(faceBounds[m_faceOrder[i]]);
+	node.m_min = box.m_min;
+	node.m_max = box.m_max;
+}
+
+
+void BVH::refit(std::vector<glm::vec3> const& verts) {
+	if (m_nodes.empty()) return;
+
+	unsigned int const slotCount = (unsigned int)m_faceOrder.size();
+	ParallelTools::parallelFor(slotCount, [&](size_t const slot) {
+		for (unsigned int c = 0; c < 3; ++c) m_triangleVerts[3 * slot + c] = verts[m_faceIndices[3 * m_faceOrder[slot] + c]];
+	});
+
+	// leaves in parallel, then the inner nodes bottom up (children always come after their parent)
+	ParallelTools::parallelFor(m_nodes.size(), [&](size_t const n) {
+		Node &node = m_nodes[n];
+		if (!node.isLeaf()) return;
+		AABB box;
+		for (unsigned int i = 3 * node.m_offset; i < 3 * (node.m_offset + node.m_count); ++i) box.grow(m_triangleVerts[i]);
+		node.m_min = box.m_min;
+		node.m_max = box.m_max;
+	});
+	for (size_t n = m_nodes.size(); n-- > 0;) {
+		Node &node = m_nodes[n];
+		if (node.isLeaf()) continue;
+		node.m_min = glm::min(m_nodes[node.m_offset].m_min, m_nodes[node.m_offset + 1].m_min);
+		node.m_max = glm::max(m_nodes[node.m_offset].m_max, m_nodes[node.m_offset + 1].m_max);
+	}
+}
+
+
+bool BVH::intersectRay(glm::vec3 const& origin, glm::vec3 const& direction, float const maxT, RayHit &out_hit) const {
+	if (m_nodes.empty()) return false;
+
+	glm::vec3 const inverseDirection = 1.0f / direction;
+	float closestT = maxT;
+	bool isHit = false;
+
+	// (node, entry distance) pairs, the nearer child is always popped first
+	std::pair<unsigned int, float> stack[s_MAX_DEPTH + 1];
+	unsigned int stackSize = 0;
+	float const rootEntry = intersectBox(origin, inverseDirection, m_nodes[0].m_min, m_nodes[0].m_max, closestT);
+	if (rootEntry <= closestT) stack[stackSize++] = std::make_pair(0u, rootEntry);
+
+	while (stackSize > 0) {
+		std::pair<unsigned int, float> const entry = stack[--stackSize];
+		if (entry.second > closestT) continue; // a closer hit was found since it got pushed
+
+		Node const& node = m_nodes[entry.first];
+		if (node.isLeaf()) {
+			for (unsigned int slot = node.m_offset; slot < node.m_offset + node.m_count; ++slot) {
+				float t;
+				glm::vec2 barycentric;
+				if (intersectTriangle(origin, direction, m_triangleVerts[3 * slot], m_triangleVerts[3 * slot + 1], m_triangleVerts[3 * slot + 2], t, barycentric) && t <= closestT) {
+					closestT = t;
+					isHit = true;
+					out_hit.m_t = t;
+					out_hit.m_face = m_faceOrder[slot];
+					out_hit.m_barycentric = barycentric;
+				}
+			}
+			continue;
+		}
+
+		float const t0 = intersectBox(origin, inverseDirection, m_nodes[node.m_offset].m_min, m_nodes[node.m_offset].m_max, closestT);
+		float const t1 = intersectBox(origin, inverseDirection, m_nodes[node.m_offset + 1].m_min, m_nodes[node.m_offset + 1].m_max, closestT);
+		unsigned int const nearChild = t0 <= t1 ? node.m_offset : node.m_offset + 1;
+		unsigned int const farChild = t0 <= t1 ? node.m_offset + 1 : node.m_offset;
+		if (glm::max(t0, t1) <= closestT) stack[stackSize++] = std::make_pair(farChild, glm::max(t0, t1));
+		if (glm::min(t0, t1) <= closestT) stack[stackSize++] = std::make_pair(nearChild, glm::min(t0, t1));
+	}
+	return isHit;
+}
+
+
+bool BVH::findClosestPoint(glm::vec3 const& p, float const maxDistance, ClosestPoint &out_closest) const {
+	if (m_nodes.empty()) return false;
+
+	float closestDistanceSq = maxDistance * maxDistance;
+	bool isFound = false;
+
+	// (node, squared distance to its bounds) pairs, the nearer child is always popped first
+	std::pair<unsigned int, float> stack[s_MAX_DEPTH + 1];
+	unsigned int stackSize = 0;
+	stack[stackSize++] = std::make_pair(0u, m_nodes[0].getBounds().getDistanceSq(p));
+
+	while (stackSize > 0) {
+		std::pair<unsigned int, float> const entry = stack[--stackSize];
+		if (entry.second > closestDistanceSq) continue;
+
+		Node const& node = m_nodes[entry.first];
+		if (node.isLeaf()) {
+			for (unsigned int slot = node.m_offset; slot < node.m_offset + node.m_count; ++slot) {
+				TriangleRegion region;
+				glm::vec3 const q = closestPointOnTriangle(p, m_triangleVerts[3 * slot], m_triangleVerts[3 * slot + 1], m_triangleVerts[3 * slot + 2], region);
+				float const distanceSq = glm::dot(p - q, p - q);
+				if (distanceSq <= closestDistanceSq) {
+					closestDistanceSq = distanceSq;
+					isFound = true;
+					out_closest.m_point = q;
+					out_closest.m_distanceSq = distanceSq;
+					out_closest.m_face = m_faceOrder[slot];
+				}
+			}
+			continue;
+		}
+
+		float const d0 = m_nodes[node.m_offset].getBounds().getDistanceSq(p);
+		float const d1 = m_nodes[node.m_offset + 1].getBounds().getDistanceSq(p);
+		unsigned int const nearChild = d0 <= d1 ? node.m_offset : node.m_offset + 1;
+		unsigned int const farChild = d0 <= d1 ? node.m_offset + 1 : node.m_offset;
+		if (glm::max(d0, d1) <= closestDistanceSq) stack[stackSize++] = std::make_pair(farChild, glm::max(d0, d1));
+		if (glm::min(d0, d1) <= closestDistanceSq) stack[stackSize++] = std::make_pair(nearChild, glm::min(d0, d1));
+	}
+	return isFound;
+}
+
+
+void BVH::queryOverlap(AABB const& box, std::vector<unsigned int> &out_faces) const {
+	if (m_nodes.empty()) return;
+
+	unsigned int stack[s_MAX_DEPTH + 1];
+	unsigned int stackSize = 0;
+	stack[stackSize++] = 0;
+	while (stackSize > 0) {
+		Node const& node = m_nodes[stack[--stackSize]];
+		if (!node.getBounds().overlaps(box)) continue;
+
+		if (node.isLeaf()) {
+			for (unsigned int slot = node.m_offset; slot < node.m_offset + node.m_count; ++slot) {
+				AABB triangleBox;
+				for (unsigned int c = 0; c < 3; ++c) triangleBox.grow(m_triangleVerts[3 * slot + c]);
+				if (triangleBox.overlaps(box)) out_faces.push_back(m_faceOrder[slot]);
+			}
+			continue;
+		}
+		stack[stackSize++] = node.m_offset + 1;
+		stack[stackSize++] = node.m_offset;
+	}
+}
+
+
+glm::vec3 BVH::closestPointOnTriangle(glm::vec3 const& p, glm::vec3 const& a, glm::vec3 const& b, glm::vec3 const& c, TriangleRegion &out_region) {
+	glm::vec3 const ab = b - a;
+	glm::vec3 const ac = c - a;
+	glm::vec3 const ap = p - a;
+	float const d1 = glm::dot(ab, ap);
+	float const d2 = glm::dot(ac, ap);
+	if (d1 <= 0.0f && d2 <= 0.0f) { out_region = TriangleRegion::VERTEX_A; return a; }
+
+	glm::vec3 const bp = p - b;
+	float const d3 = glm::dot(ab, bp);
+	float const d4 = glm::dot(ac, bp);
+	if (d3 >= 0.0f && d4 <= d3) { out_region = TriangleRegion::VERTEX_B; return b; }
+
+	float const vc = d1 * d4 - d3 * d2;
+	if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) {
+		out_region = TriangleRegion::EDGE_AB;
+		return a + (d1 / (d1 - d3)) * ab;
+	}
+
+	glm::vec3 const cp = p - c;
+	float const d5 = glm::dot(ab, cp);
+	float const d6 = glm::dot(ac, cp);
+	if (d6 >= 0.0f && d5 <= d6) { out_region = TriangleRegion::VERTEX_C; return c; }
+
+	float const vb = d5 * d2 - d1 * d6;
+	if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) {
+		out_region = TriangleRegion::EDGE_CA;
+		return a + (d2 / (d2 - d6)) * ac;
+	}
+
+	float const va = d3 * d6 - d5 * d4;
+	if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) {
+		out_region = TriangleRegion::EDGE_BC;
+		return b + ((d4 - d3) / ((d4 - d3) + (d5 - d6))) * (c - b);
+	}
+
+	float const denom = 1.0f / (va + vb + vc);
+	out_region = TriangleRegion::FACE;
+	return a + ab * (vb * denom) + ac * (vc * denom);
+}
+
+
+bool BVH::intersectTriangle(glm::vec3 const& origin, glm::vec3 const& direction, glm::vec3 const& a, glm::vec3 const& b, glm::vec3 const& c, float &out_t, glm::vec2 &out_barycentric) {
+	glm::vec3 const e1 = b - a;
+	glm::vec3 const e2 = c - a;
+	glm::vec3 const pv = glm::cross(direction, e2);
+	float const det = glm::dot(e1, pv);
+	if (0.0f == det) return false; // parallel (nearly parallel rays end up far outside the triangle below)
+
+	float const inverseDet = 1.0f / det;
+	glm::vec3 const tv = origin - a;
+	float const u = glm::dot(tv, pv) * inverseDet;
+	if (u < 0.0f || u > 1.0f) return false;
+
+	glm::vec3 const qv = glm::cross(tv, e1);
+	float const v = glm::dot(direction, qv) * inverseDet;
+	if (v < 0.0f || u + v > 1.0f) return false;
+
+	out_t = glm::dot(e2, qv) * inverseDet;
+	if (out_t <= 0.0f) return false;
+	out_barycentric = glm::vec2(u, v);
+	return true;
+}
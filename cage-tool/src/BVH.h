@@ -0,0 +1,120 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <limits>
+#include <vector>
+
+
+// axis aligned bounding box
+struct AABB {
+	glm::vec3 m_min = glm::vec3(std::numeric_limits<float>::max());
+	glm::vec3 m_max = glm::vec3(std::numeric_limits<float>::lowest());
+
+	void grow(glm::vec3 const& p) { m_min = glm::min(m_min, p); m_max = glm::max(m_max, p); }
+	void grow(AABB const& box) { m_min = glm::min(m_min, box.m_min); m_max = glm::max(m_max, box.m_max); }
+
+	bool isEmpty() const { return m_min.x > m_max.x; }
+	bool overlaps(AABB const& box) const { return glm::all(glm::lessThanEqual(m_min, box.m_max)) && glm::all(glm::lessThanEqual(box.m_min, m_max)); }
+
+	// half the surface area (the SAH only compares ratios)
+	float getHalfArea() const {
+		if (isEmpty()) return 0.0f;
+		glm::vec3 const e = m_max - m_min;
+		return e.x * e.y + e.y * e.z + e.z * e.x;
+	}
+
+	// squared distance from p to the box (0 inside)
+	float getDistanceSq(glm::vec3 const& p) const {
+		glm::vec3 const d = glm::max(glm::vec3(0.0f), glm::max(m_min - p, p - m_max));
+		return glm::dot(d, d);
+	}
+};
+
+
+// bounding volume hierarchy over the triangles of a mesh (e.g. the drawVerts/drawFaces of a MeshObject)
+// reference: Wald - On fast Construction of SAH-based Bounding Volume Hierarchies (2007) - binned SAH
+// 1. per triangle bounds + centroids (parallel)
+// 2. the top of the tree is split on the calling thread until there are enough subtrees to keep every hardware thread busy, the subtrees are then built in parallel and appended
+// 3. every split is the cheapest of s_BIN_COUNT binned SAH candidates along the longest axis of the centroid bounds
+//NOTE: the triangle verts are copied into leaf order, so a leaf's triangles are contiguous in memory (refit re-gathers them)
+class BVH {
+
+public:
+	// 32 byte node, the 2 children of an inner node are always next to each other
+	struct Node {
+		glm::vec3 m_min;
+		unsigned int m_offset; // leaves - first triangle slot, inner nodes - index of the 1st child (the 2nd child is m_offset + 1)
+		glm::vec3 m_max;
+		unsigned int m_count; // triangle count of a leaf, 0 for inner nodes
+
+		bool isLeaf() const { return m_count > 0; }
+		AABB getBounds() const { AABB box; box.m_min = m_min; box.m_max = m_max; return box; }
+	};
+
+	struct RayHit {
+		float m_t = std::numeric_limits<float>::max(); // hit = origin + m_t * direction
+		unsigned int m_face = 0; // face index (into the faces passed to build)
+		glm::vec2 m_barycentric = glm::vec2(0.0f); // weights of the 2nd and 3rd vert of the face
+	};
+
+	struct ClosestPoint {
+		glm::vec3 m_point = glm::vec3(0.0f);
+		float m_distanceSq = std::numeric_limits<float>::max();
+		unsigned int m_face = 0;
+	};
+
+	// closest feature of a triangle to a point
+	enum TriangleRegion {
+		FACE = 0,
+		VERTEX_A = 1, VERTEX_B = 2, VERTEX_C = 3,
+		EDGE_AB = 4, EDGE_BC = 5, EDGE_CA = 6,
+	};
+
+	// RETURNS false if there are no faces
+	//NOTE: faces are 3 indices in a row into verts
+	bool build(std::vector<glm::vec3> const& verts, std::vector<unsigned int> const& faceIndices, unsigned int const maxLeafSize = 4);
+
+	// updates the bounds for moved verts (same faces as the last build), the tree topology is kept so its quality degrades with large deformations
+	void refit(std::vector<glm::vec3> const& verts);
+
+	bool isEmpty() const { return m_nodes.empty(); }
+
+	// closest hit along the ray within (0, maxT], RETURNS false if nothing was hit
+	bool intersectRay(glm::vec3 const& origin, glm::vec3 const& direction, float const maxT, RayHit &out_hit) const;
+
+	// closest point on the mesh within maxDistance of p, RETURNS false if there is none
+	bool findClosestPoint(glm::vec3 const& p, float const maxDistance, ClosestPoint &out_closest) const;
+
+	// appends every face whose bounds overlap box
+	//NOTE: this is a bounds test only, callers that need exact triangle-box overlap have to test the returned faces themselves
+	void queryOverlap(AABB const& box, std::vector<unsigned int> &out_faces) const;
+
+	// for custom traversals (m_nodes[0] is the root, children always come after their parent)...
+	std::vector<Node> const& getNodes() const { return m_nodes; }
+	unsigned int getFace(unsigned int const slot) const { return m_faceOrder[slot]; }
+	glm::vec3 const& getTriangleVert(unsigned int const slot, unsigned int const corner) const { return m_triangleVerts[3 * slot + corner]; }
+
+	// reference: Ericson - Real-Time Collision Detection (2005), 5.1.5 Closest Point on Triangle to Point
+	static glm::vec3 closestPointOnTriangle(glm::vec3 const& p, glm::vec3 const& a, glm::vec3 const& b, glm::vec3 const& c, TriangleRegion &out_region);
+
+	// reference: Moller, Trumbore - Fast, Minimum Storage Ray/Triangle Intersection (1997)
+	// RETURNS false if the ray misses (or is parallel to) the triangle, both sides of the triangle are hit
+	static bool intersectTriangle(glm::vec3 const& origin, glm::vec3 const& direction, glm::vec3 const& a, glm::vec3 const& b, glm::vec3 const& c, float &out_t, glm::vec2 &out_barycentric);
+
+private:
+	static unsigned int const s_BIN_COUNT = 12;
+
+	std::vector<Node> m_nodes;
+	std::vector<unsigned int> m_faceIndices; // copy of the faces from the last build (for refit)
+	std::vector<unsigned int> m_faceOrder; // face of every triangle slot
+	std::vector<glm::vec3> m_triangleVerts; // 3 per triangle slot
+
+	// splits the node at nodeIndex of nodes (whose bounds are already set) down to leaves, appending the new nodes to nodes
+	//NOTE: only touches the slots [first, first + count) of m_faceOrder, so subtrees over disjoint ranges can be built in parallel
+	void buildSubtree(std::vector<Node> &nodes, unsigned int const nodeIndex, unsigned int const first, unsigned int const count, unsigned int const depth, std::vector<AABB> const& faceBounds, std::vector<glm::vec3> const& faceCentroids, unsigned int const maxLeafSize);
+
+	// RETURNS false if the range should become a leaf, otherwise partitions it and sets out_leftCount
+	bool splitRange(unsigned int const first, unsigned int const count, std::vector<AABB> const& faceBounds, std::vector<glm::vec3> const& faceCentroids, unsigned int const maxLeafSize, unsigned int &out_leftCount);
+
+	void setBounds(Node &node, unsigned int const first, unsigned int const count, std::vector<AABB> const& faceBounds) const;
+};
@@ -0,0 +1,29 @@
+#include "BackgroundJob.h"
+
+
+bool BackgroundJob::start(std::function<void(BackgroundJob&)> task) {
+	if (m_isStarted) return false;
+
+	m_isStarted = true;
+	m_isComplete = false;
+	setProgress(0.0f, "");
+	m_thread = std::thread([this, task]() {
+		task(*this);
+		m_isComplete = true;
+	});
+	return true;
+}
+
+
+bool BackgroundJob::finish() {
+	if (!m_isStarted || !m_isComplete) return false;
+
+	wait(); // the task has returned, this only joins the thread
+	m_isStarted = false;
+	return true;
+}
+
+
+void BackgroundJob::wait() {
+	if (m_thread.joinable()) m_thread.join();
+}
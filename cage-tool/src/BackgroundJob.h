@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <thread>
+
+
+// runs 1 task on a worker thread (e.g. loading a mesh) while the GL thread keeps drawing frames
+// the task reports how far it is through setProgress, the GL thread polls finish() once per frame and then does the part that needs the GL context (e.g. uploading buffers)
+//NOTE: the task must not make any GL calls (the context is only current on the GL thread)
+class BackgroundJob {
+
+public:
+	BackgroundJob() = default;
+	~BackgroundJob() { wait(); }
+
+	BackgroundJob(BackgroundJob const&) = delete;
+	BackgroundJob& operator=(BackgroundJob const&) = delete;
+
+	// RETURNS false if the previous task hasn't been finished yet
+	bool start(std::function<void(BackgroundJob&)> task);
+
+	// RETURNS true (once per task) when the task has completed - everything it wrote can then be used by the caller
+	bool finish();
+
+	// blocks until the task has completed (finish() still has to be called afterwards)
+	void wait();
+
+	bool isBusy() const { return m_isStarted; } // started and not finished yet
+
+	// called by the task - progress in [0, 1] and a short description of the current step
+	//NOTE: step is only pointed to, so it has to outlive the task (e.g. a string literal)
+	void setProgress(float const progress, char const* step) {
+		m_step = step;
+		m_progress = progress;
+	}
+	float getProgress() const { return m_progress; }
+	char const* getStep() const { return m_step; }
+
+private:
+	std::thread m_thread;
+	bool m_isStarted = false;
+	std::atomic<bool> m_isComplete{ false };
+	std::atomic<float> m_progress{ 0.0f };
+	std::atomic<char const*> m_step{ "" };
+};
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+
+// byte order helpers for the binary mesh formats (PLY can be either little or big endian, STL is always little endian)
+//NOTE: values are read/written with memcpy, so unaligned pointers into a file mapping are fine
+class ByteOrder {
+
+public:
+	static bool isHostLittleEndian() {
+		uint16_t const one = 1;
+		unsigned char firstByte;
+		std::memcpy(&firstByte, &one, 1);
+		return 1 == firstByte;
+	}
+
+	// reverses the bytes of a value of size bytes in place
+	static void swap(void *value, size_t const size) {
+		unsigned char *bytes = (unsigned char*)value;
+		for (size_t i = 0; i < size / 2; ++i) std::swap(bytes[i], bytes[size - 1 - i]);
+	}
+
+	template <typename T>
+	static T read(char const* in, bool const isSwapped) {
+		T value;
+		std::memcpy(&value, in, sizeof(T));
+		if (isSwapped) swap(&value, sizeof(T));
+		return value;
+	}
+
+	// RETURNS the end of the written value
+	template <typename T>
+	static char* write(char *out, T value, bool const isSwapped) {
+		if (isSwapped) swap(&value, sizeof(T));
+		std::memcpy(out, &value, sizeof(T));
+		return out + sizeof(T);
+	}
+};
@@ -0,0 +1,271 @@
+#include "CagePicker.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "ParallelTools.h"
+
+
+void CagePicker::update(std::vector<glm::vec3> const& cageVerts, glm::mat4 const& cageModel, glm::mat4 const& view, glm::mat4 const& projection, glm::ivec2 const& viewportSize) {
+	if (m_isValid && cageVerts.size() == m_windowPositions.size() && cageModel == m_cageModel && view == m_view && projection == m_projection && viewportSize == m_viewportSize) return;
+
+	m_isValid = true;
+	m_cageModel = cageModel;
+	m_view = view;
+	m_projection = projection;
+	m_viewportSize = viewportSize;
+	m_eye = glm::vec3(glm::inverse(view)[3]);
+
+	// 1. project...
+	size_t const vertCount = cageVerts.size();
+	m_worldPositions.resize(vertCount);
+	m_windowPositions.resize(vertCount);
+	m_isOnScreen.resize(vertCount);
+
+	glm::mat4 const viewProjection = projection * view;
+	glm::vec2 const size(viewportSize);
+	ParallelTools::parallelFor(vertCount, [&](size_t const v) {
+		glm::vec3 const world = glm::vec3(cageModel * glm::vec4(cageVerts[v], 1.0f));
+		glm::vec4 const clip = viewProjection * glm::vec4(world, 1.0f);
+		m_worldPositions[v] = world;
+
+		if (clip.w <= 0.0f) { // behind the eye
+			m_windowPositions[v] = glm::vec3(-1.0f, -1.0f, 1.0f);
+			m_isOnScreen[v] = 0;
+			return;
+		}
+		glm::vec3 const ndc = glm::vec3(clip) / clip.w;
+		glm::vec3 const window((0.5f * ndc.x + 0.5f) * size.x, (0.5f - 0.5f * ndc.y) * size.y, 0.5f * ndc.z + 0.5f);
+		m_windowPositions[v] = window;
+		m_isOnScreen[v] = (window.x >= 0.0f && window.x < size.x && window.y >= 0.0f && window.y < size.y && window.z >= 0.0f && window.z <= 1.0f) ? 1 : 0;
+	});
+
+	// 2. bin into the screen grid (counting sort)...
+	m_cellCounts = glm::max(glm::ivec2(1, 1), (viewportSize + glm::ivec2(s_CELL_SIZE - 1)) / glm::ivec2(s_CELL_SIZE));
+	m_cellStarts.assign((size_t)m_cellCounts.x * m_cellCounts.y + 1, 0);
+	for (size_t v = 0; v < vertCount; ++v) {
+		if (m_isOnScreen[v]) ++m_cellStarts[toCell(m_windowPositions[v]) + 1];
+	}
+	for (size_t c = 1; c < m_cellStarts.size(); ++c) m_cellStarts[c] += m_cellStarts[c - 1];
+
+	m_cellVerts.resize(m_cellStarts.back());
+	std::vector<unsigned int> cellFill(m_cellStarts.begin(), m_cellStarts.end() - 1);
+	for (size_t v = 0; v < vertCount; ++v) {
+		if (m_isOnScreen[v]) m_cellVerts[cellFill[toCell(m_windowPositions[v])]++] = (unsigned int)v;
+	}
+}
+
+
+unsigned int CagePicker::toCell(glm::vec3 const& windowPosition) const {
+	int const x = glm::clamp((int)windowPosition.x / (int)s_CELL_SIZE, 0, m_cellCounts.x - 1);
+	int const y = glm::clamp((int)windowPosition.y / (int)s_CELL_SIZE, 0, m_cellCounts.y - 1);
+	return (unsigned int)(y * m_cellCounts.x + x);
+}
+
+
+unsigned int CagePicker::pick(glm::vec2 const& cursor, float const pickRadius, BVH const* occluder, glm::mat4 const& occluderModel) const {
+	if (!m_isValid || m_cellStarts.empty()) return s_NONE;
+
+	// candidates from the cells overlapping the pick circle...
+	std::vector<std::pair<float, unsigned int>> candidates; // (squared distance on screen, vert)
+	glm::ivec2 const minCell = glm::clamp(glm::ivec2(glm::floor((cursor - pickRadius) / (float)s_CELL_SIZE)), glm::ivec2(0), m_cellCounts - 1);
+	glm::ivec2 const maxCell = glm::clamp(glm::ivec2(glm::floor((cursor + pickRadius) / (float)s_CELL_SIZE)), glm::ivec2(0), m_cellCounts - 1);
+	for (int y = minCell.y; y <= maxCell.y; ++y) {
+		for (int x = minCell.x; x <= maxCell.x; ++x) {
+			unsigned int const c = (unsigned int)(y * m_cellCounts.x + x);
+			for (unsigned int i = m_cellStarts[c]; i < m_cellStarts[c + 1]; ++i) {
+				unsigned int const v = m_cellVerts[i];
+				glm::vec2 const d = glm::vec2(m_windowPositions[v]) - cursor;
+				float const distanceSq = glm::dot(d, d);
+				if (distanceSq <= pickRadius * pickRadius) candidates.push_back(std::make_pair(distanceSq, v));
+			}
+		}
+	}
+
+	// ...closest first, the first one that isn't hidden wins
+	//NOTE: ties (e.g. verts behind each other) go to the vert closer to the eye
+	std::sort(candidates.begin(), candidates.end(), [this](std::pair<float, unsigned int> const& c0, std::pair<float, unsigned int> const& c1) {
+		if (c0.first != c1.first) return c0.first < c1.first;
+		return m_windowPositions[c0.second].z < m_windowPositions[c1.second].z;
+	});
+	for (std::pair<float, unsigned int> const& candidate : candidates) {
+		if (!isOccluded(candidate.second, occluder, occluderModel)) return candidate.second;
+	}
+	return s_NONE;
+}
+
+
+void CagePicker::queryRect(glm::vec2 const& corner0, glm::vec2 const& corner1, BVH const* occluder, glm::mat4 const& occluderModel, std::vector<unsigned int> &out_verts) const {
+	out_verts.clear();
+	if (!m_isValid || m_cellStarts.empty()) return;
+
+	glm::vec2 const rectMin = glm::min(corner0, corner1);
+	glm::vec2 const rectMax = glm::max(corner0, corner1);
+	glm::ivec2 const minCell = glm::clamp(glm::ivec2(glm::floor(rectMin / (float)s_CELL_SIZE)), glm::ivec2(0), m_cellCounts - 1);
+	glm::ivec2 const maxCell = glm::clamp(glm::ivec2(glm::floor(rectMax / (float)s_CELL_SIZE)), glm::ivec2(0), m_cellCounts - 1);
+	for (int y = minCell.y; y <= maxCell.y; ++y) {
+		for (int x = minCell.x; x <= maxCell.x; ++x) {
+			unsigned int const c = (unsigned int)(y * m_cellCounts.x + x);
+			glm::vec2 const cellMin = glm::vec2(x, y) * (float)s_CELL_SIZE;
+			glm::vec2 const cellMax = cellMin + (float)s_CELL_SIZE;
+
+			// cell entirely inside the rectangle...
+			if (cellMin.x >= rectMin.x && cellMin.y >= rectMin.y && cellMax.x <= rectMax.x && cellMax.y <= rectMax.y) {
+				appendCell(c, out_verts);
+				continue;
+			}
+
+			// ...otherwise test its verts
+			for (unsigned int i = m_cellStarts[c]; i < m_cellStarts[c + 1]; ++i) {
+				unsigned int const v = m_cellVerts[i];
+				glm::vec2 const p = glm::vec2(m_windowPositions[v]);
+				if (p.x >= rectMin.x && p.y >= rectMin.y && p.x <= rectMax.x && p.y <= rectMax.y) out_verts.push_back(v);
+			}
+		}
+	}
+
+	removeOccluded(occluder, occluderModel, out_verts);
+}
+
+
+// 1. every polygon edge marks the cells it passes through as border cells
+// 2. a border-free cell is either entirely inside or entirely outside, a scanline through the centre of its row tells which
+// 3. the verts of border cells get a point in polygon test each
+void CagePicker::queryLasso(std::vector<glm::vec2> const& polygon, BVH const* occluder, glm::mat4 const& occluderModel, std::vector<unsigned int> &out_verts) const {
+	out_verts.clear();
+	if (!m_isValid || m_cellStarts.empty() || polygon.size() < 3) return;
+
+	float const cellSize = (float)s_CELL_SIZE;
+
+	glm::vec2 polygonMin = polygon.front();
+	glm::vec2 polygonMax = polygon.front();
+	for (glm::vec2 const& p : polygon) {
+		polygonMin = glm::min(polygonMin, p);
+		polygonMax = glm::max(polygonMax, p);
+	}
+	glm::ivec2 const minCell = glm::clamp(glm::ivec2(glm::floor(polygonMin / cellSize)), glm::ivec2(0), m_cellCounts - 1);
+	glm::ivec2 const maxCell = glm::clamp(glm::ivec2(glm::floor(polygonMax / cellSize)), glm::ivec2(0), m_cellCounts - 1);
+	glm::ivec2 const cellCounts = maxCell - minCell + 1; // cells of the polygon's bounding box
+
+	// x coord where edge (a, b) crosses the horizontal line at y
+	auto crossingX = [](glm::vec2 const& a, glm::vec2 const& b, float const y) {
+		return a.x + (y - a.y) * (b.x - a.x) / (b.y - a.y);
+	};
+
+	// 1. mark border cells, row by row...
+	std::vector<unsigned char> isBorder((size_t)cellCounts.x * cellCounts.y, 0);
+	for (size_t e = 0; e < polygon.size(); ++e) {
+		glm::vec2 const& a = polygon[e];
+		glm::vec2 const& b = polygon[(e + 1) % polygon.size()];
+		float const edgeMinY = glm::min(a.y, b.y);
+		float const edgeMaxY = glm::max(a.y, b.y);
+
+		int const rowBegin = glm::max((int)glm::floor(edgeMinY / cellSize), minCell.y);
+		int const rowEnd = glm::min((int)glm::floor(edgeMaxY / cellSize), maxCell.y);
+		for (int y = rowBegin; y <= rowEnd; ++y) {
+			// x extent of the part of the edge within this row
+			float x0 = glm::min(a.x, b.x);
+			float x1 = glm::max(a.x, b.x);
+			if (a.y != b.y) {
+				float const xTop = crossingX(a, b, glm::clamp(y * cellSize, edgeMinY, edgeMaxY));
+				float const xBottom = crossingX(a, b, glm::clamp((y + 1) * cellSize, edgeMinY, edgeMaxY));
+				x0 = glm::min(xTop, xBottom);
+				x1 = glm::max(xTop, xBottom);
+			}
+			int const columnBegin = glm::max((int)glm::floor(x0 / cellSize), minCell.x);
+			int const columnEnd = glm::min((int)glm::floor(x1 / cellSize), maxCell.x);
+			for (int x = columnBegin; x <= columnEnd; ++x) {
+				isBorder[(size_t)(y - minCell.y) * cellCounts.x + (x - minCell.x)] = 1;
+			}
+		}
+	}
+
+	std::vector<std::pair<glm::vec2, glm::vec2>> rowEdges; // edges overlapping the current row (only these can cross a horizontal line within it)
+	std::vector<float> crossings;
+
+	// even-odd rule - crossings of the horizontal line through p (to the left of p)
+	//NOTE: p has to be within the current row
+	auto isInside = [&rowEdges](glm::vec2 const& p) {
+		bool inside = false;
+		for (std::pair<glm::vec2, glm::vec2> const& edge : rowEdges) {
+			glm::vec2 const& a = edge.first;
+			glm::vec2 const& b = edge.second;
+			if ((a.y > p.y) != (b.y > p.y) && p.x < a.x + (p.y - a.y) * (b.x - a.x) / (b.y - a.y)) inside = !inside;
+		}
+		return inside;
+	};
+
+	for (int y = minCell.y; y <= maxCell.y; ++y) {
+		float const rowMinY = y * cellSize;
+		float const rowMaxY = (y + 1) * cellSize;
+		rowEdges.clear();
+		for (size_t e = 0, prev = polygon.size() - 1; e < polygon.size(); prev = e++) {
+			glm::vec2 const& a = polygon[prev];
+			glm::vec2 const& b = polygon[e];
+			if (glm::max(a.y, b.y) >= rowMinY && glm::min(a.y, b.y) <= rowMaxY) rowEdges.push_back(std::make_pair(a, b));
+		}
+
+		// 2. crossings of the scanline through the row's centre...
+		float const scanY = (y + 0.5f) * cellSize;
+		crossings.clear();
+		for (std::pair<glm::vec2, glm::vec2> const& edge : rowEdges) {
+			if ((edge.first.y > scanY) != (edge.second.y > scanY)) crossings.push_back(crossingX(edge.first, edge.second, scanY));
+		}
+		std::sort(crossings.begin(), crossings.end());
+
+		for (int x = minCell.x; x <= maxCell.x; ++x) {
+			unsigned int const c = (unsigned int)(y * m_cellCounts.x + x);
+			if (m_cellStarts[c] == m_cellStarts[c + 1]) continue; // empty
+
+			if (0 == isBorder[(size_t)(y - minCell.y) * cellCounts.x + (x - minCell.x)]) {
+				float const scanX = (x + 0.5f) * cellSize;
+				size_t const crossingsBefore = std::lower_bound(crossings.begin(), crossings.end(), scanX) - crossings.begin();
+				if (1 == crossingsBefore % 2) appendCell(c, out_verts);
+				continue;
+			}
+
+			// 3. border cell...
+			for (unsigned int i = m_cellStarts[c]; i < m_cellStarts[c + 1]; ++i) {
+				unsigned int const v = m_cellVerts[i];
+				if (isInside(glm::vec2(m_windowPositions[v]))) out_verts.push_back(v);
+			}
+		}
+	}
+
+	removeOccluded(occluder, occluderModel, out_verts);
+}
+
+
+void CagePicker::appendCell(unsigned int const c, std::vector<unsigned int> &out_verts) const {
+	out_verts.insert(out_verts.end(), m_cellVerts.begin() + m_cellStarts[c], m_cellVerts.begin() + m_cellStarts[c + 1]);
+}
+
+
+// the ray casts are independent, so they run in parallel
+void CagePicker::removeOccluded(BVH const* occluder, glm::mat4 const& occluderModel, std::vector<unsigned int> &out_verts) const {
+	if (nullptr == occluder || occluder->isEmpty() || out_verts.empty()) return;
+
+	std::vector<unsigned char> isHidden(out_verts.size(), 0);
+	ParallelTools::parallelFor(out_verts.size(), [&](size_t const i) {
+		isHidden[i] = isOccluded(out_verts[i], occluder, occluderModel) ? 1 : 0;
+	}, 64);
+
+	size_t visibleCount = 0;
+	for (size_t i = 0; i < out_verts.size(); ++i) {
+		if (0 == isHidden[i]) out_verts[visibleCount++] = out_verts[i];
+	}
+	out_verts.resize(visibleCount);
+}
+
+
+bool CagePicker::isOccluded(unsigned int const v, BVH const* occluder, glm::mat4 const& occluderModel) const {
+	if (nullptr == occluder || occluder->isEmpty()) return false;
+
+	// eye -> vert segment in the occluder's object space (the direction is left unnormalized so that t = 1 is the vert)
+	//NOTE: hits right at the vert are ignored, so verts lying on the occluder's surface stay pickable
+	glm::mat4 const toObject = glm::inverse(occluderModel);
+	glm::vec3 const origin = glm::vec3(toObject * glm::vec4(m_eye, 1.0f));
+	glm::vec3 const target = glm::vec3(toObject * glm::vec4(m_worldPositions[v], 1.0f));
+	BVH::RayHit hit;
+	return occluder->intersectRay(origin, target - origin, 1.0f - 1e-4f, hit);
+}
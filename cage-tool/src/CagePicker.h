@@ -0,0 +1,68 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "BVH.h"
+
+
+// picks cage verts under the cursor on the CPU (no GPU round trips, so it also works without a window/GL context)
+// 1. every cage vert is projected to window coords (in parallel) and binned into a uniform grid of s_CELL_SIZE pixel cells - cached until the view, the viewport or the cage changes
+// 2. a pick visits the cells around the cursor, candidates within the pick radius are tested closest (on screen) first
+// 3. a candidate is hidden if the ray from the eye to it hits the occluder (the model) first
+// box/lasso queries only test the verts of cells on the region's border, cells entirely inside the region are taken as a whole
+//NOTE: window coords are in pixels with +y pointing down (same as the cursor positions from glfw), depth is in [0, 1]
+class CagePicker {
+
+public:
+	static unsigned int const s_NONE = 0xFFFFFFFF;
+
+	// re-projects the cage verts if the matrices/viewport changed, or invalidate was called since the last update
+	void update(std::vector<glm::vec3> const& cageVerts, glm::mat4 const& cageModel, glm::mat4 const& view, glm::mat4 const& projection, glm::ivec2 const& viewportSize);
+
+	// has to be called whenever the cage verts move (or the cage is replaced)
+	void invalidate() { m_isValid = false; }
+
+	// RETURNS the closest (on screen) visible cage vert within pickRadius pixels of cursor, s_NONE if there is none
+	//NOTE: occluder is a BVH in the occluder's object space (nullptr if nothing can hide the cage verts)
+	unsigned int pick(glm::vec2 const& cursor, float const pickRadius, BVH const* occluder, glm::mat4 const& occluderModel) const;
+
+	// RETURNS (in out_verts) every on screen cage vert inside the window rectangle spanned by 2 opposite corners
+	//NOTE: occluder works as in pick (hidden verts are left out), nullptr to also get hidden verts
+	void queryRect(glm::vec2 const& corner0, glm::vec2 const& corner1, BVH const* occluder, glm::mat4 const& occluderModel, std::vector<unsigned int> &out_verts) const;
+	// same as queryRect, but inside a closed polygon (even-odd rule, the last point connects back to the first)
+	void queryLasso(std::vector<glm::vec2> const& polygon, BVH const* occluder, glm::mat4 const& occluderModel, std::vector<unsigned int> &out_verts) const;
+
+	// is cage vert v hidden behind the occluder (as seen from the eye of the last update)?
+	bool isOccluded(unsigned int const v, BVH const* occluder, glm::mat4 const& occluderModel) const;
+
+	// is cage vert v in front of the eye and inside the viewport (as of the last update)?
+	bool isOnScreen(unsigned int const v) const { return 0 != m_isOnScreen[v]; }
+	glm::vec3 const& getWindowPosition(unsigned int const v) const { return m_windowPositions[v]; }
+	unsigned int getVertexCount() const { return (unsigned int)m_windowPositions.size(); }
+
+private:
+	static unsigned int const s_CELL_SIZE = 32; // pixels
+
+	bool m_isValid = false;
+
+	// inputs of the last update...
+	glm::mat4 m_cageModel = glm::mat4();
+	glm::mat4 m_view = glm::mat4();
+	glm::mat4 m_projection = glm::mat4();
+	glm::ivec2 m_viewportSize = glm::ivec2(0, 0);
+
+	glm::vec3 m_eye = glm::vec3(0.0f, 0.0f, 0.0f); // world space
+	std::vector<glm::vec3> m_worldPositions;
+	std::vector<glm::vec3> m_windowPositions;
+	std::vector<unsigned char> m_isOnScreen;
+
+	// screen grid - the verts of cell c are m_cellVerts[m_cellStarts[c], m_cellStarts[c + 1]) (on screen verts only)
+	glm::ivec2 m_cellCounts = glm::ivec2(0, 0);
+	std::vector<unsigned int> m_cellStarts;
+	std::vector<unsigned int> m_cellVerts;
+
+	unsigned int toCell(glm::vec3 const& windowPosition) const;
+	void appendCell(unsigned int const c, std::vector<unsigned int> &out_verts) const;
+	void removeOccluded(BVH const* occluder, glm::mat4 const& occluderModel, std::vector<unsigned int> &out_verts) const;
+};
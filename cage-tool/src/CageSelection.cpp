@@ -0,0 +1,57 @@
+#include "CageSelection.h"
+
+#include <algorithm>
+
+
+void CageSelection::reset(unsigned int const vertCount) {
+	m_vertCount = vertCount;
+	m_bits.assign((vertCount + 63) / 64, 0);
+	m_selected.clear();
+	m_selectedSlots.assign(vertCount, s_NONE);
+
+	m_changedBegin = s_NONE;
+	m_changedEnd = 0;
+}
+
+
+void CageSelection::select(unsigned int const v) {
+	if (v >= m_vertCount || isSelected(v)) return;
+
+	m_bits[v >> 6] |= uint64_t(1) << (v & 63);
+	m_selectedSlots[v] = (unsigned int)m_selected.size();
+	m_selected.push_back(v);
+	markChanged(v);
+}
+
+
+void CageSelection::unselect(unsigned int const v) {
+	if (v >= m_vertCount || !isSelected(v)) return;
+
+	m_bits[v >> 6] &= ~(uint64_t(1) << (v & 63));
+
+	// swap with the last selected vert, then pop...
+	unsigned int const slot = m_selectedSlots[v];
+	unsigned int const last = m_selected.back();
+	m_selected[slot] = last;
+	m_selectedSlots[last] = slot;
+	m_selected.pop_back();
+	m_selectedSlots[v] = s_NONE;
+	markChanged(v);
+}
+
+
+void CageSelection::markChanged(unsigned int const v) {
+	m_changedBegin = std::min(m_changedBegin, v);
+	m_changedEnd = std::max(m_changedEnd, v + 1);
+}
+
+
+bool CageSelection::takeChangedRange(unsigned int &out_first, unsigned int &out_count) {
+	if (m_changedBegin >= m_changedEnd) return false;
+
+	out_first = m_changedBegin;
+	out_count = m_changedEnd - m_changedBegin;
+	m_changedBegin = s_NONE;
+	m_changedEnd = 0;
+	return true;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+
+// selected cage verts - a bitset (O(1) membership tests) + a dense list of the selected verts (O(selected) iteration)
+//NOTE: every change widens a changed range, so callers only have to refresh that part of the colour buffer (see takeChangedRange)
+class CageSelection {
+
+public:
+	// nothing selected, nothing changed (the caller is expected to colour a freshly loaded cage itself)
+	void reset(unsigned int const vertCount);
+
+	unsigned int getVertexCount() const { return m_vertCount; }
+	bool isSelected(unsigned int const v) const { return 0 != ((m_bits[v >> 6] >> (v & 63)) & 1); }
+
+	// selected verts, in no particular order
+	std::vector<unsigned int> const& getSelected() const { return m_selected; }
+
+	void select(unsigned int const v);
+	void unselect(unsigned int const v);
+	void toggle(unsigned int const v) { if (isSelected(v)) unselect(v); else select(v); }
+
+	// RETURNS false if nothing changed since the last call, otherwise [out_first, out_first + out_count) covers every vert that changed
+	bool takeChangedRange(unsigned int &out_first, unsigned int &out_count);
+
+private:
+	static unsigned int const s_NONE = 0xFFFFFFFF;
+
+	unsigned int m_vertCount = 0;
+	std::vector<uint64_t> m_bits;
+	std::vector<unsigned int> m_selected;
+	std::vector<unsigned int> m_selectedSlots; // position of every selected vert in m_selected (so unselect can swap it with the last one)
+
+	unsigned int m_changedBegin = s_NONE;
+	unsigned int m_changedEnd = 0;
+
+	void markChanged(unsigned int const v);
+};
@@ -0,0 +1,332 @@
+#include "CageWelder.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+
+namespace {
+	// axis aligned direction of a face normal, encoded as 2 * axis + (1 if positive), or -1 for degenerate / non axis aligned faces
+	//NOTE: every face the welder produces (and every face it keeps after a collapse) lies in an axis aligned plane, so this is exact
+	int normalDirection(std::vector<glm::ivec3> const& verts, glm::uvec3 const& face) {
+		glm::ivec3 const& p0 = verts[face[0]];
+		glm::ivec3 const& p1 = verts[face[1]];
+		glm::ivec3 const& p2 = verts[face[2]];
+		int64_t const e1[3] = { (int64_t)p1.x - p0.x, (int64_t)p1.y - p0.y, (int64_t)p1.z - p0.z };
+		int64_t const e2[3] = { (int64_t)p2.x - p0.x, (int64_t)p2.y - p0.y, (int64_t)p2.z - p0.z };
+		int64_t const n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+
+		int direction = -1;
+		for (unsigned int a = 0; a < 3; ++a) {
+			if (0 == n[a]) continue;
+			if (-1 != direction) return -1; // not axis aligned
+			direction = 2 * a + (n[a] > 0 ? 1 : 0);
+		}
+		return direction;
+	}
+
+	// position of v in the face (or 3 if it isn't in there)
+	unsigned int cornerOf(glm::uvec3 const& face, unsigned int const v) {
+		for (unsigned int c = 0; c < 3; ++c) {
+			if (face[c] == v) return c;
+		}
+		return 3;
+	}
+}
+
+
+MeshTree CageWelder::weld(std::vector<LeafBox> const& leafBoxes) {
+	MeshTree welded;
+	if (leafBoxes.empty()) return welded;
+
+	// 1. global (compressed) grid lines along each axis...
+	std::vector<unsigned int> gridLines[3];
+	for (LeafBox const& box : leafBoxes) {
+		for (unsigned int a = 0; a < 3; ++a) {
+			gridLines[a].push_back(box.m_min[a]);
+			gridLines[a].push_back(box.m_max[a] + 1); //NOTE: must add 1 to max index to handle ceiling of bounding volume
+		}
+	}
+	for (unsigned int a = 0; a < 3; ++a) {
+		std::sort(gridLines[a].begin(), gridLines[a].end());
+		gridLines[a].erase(std::unique(gridLines[a].begin(), gridLines[a].end()), gridLines[a].end());
+	}
+
+	auto compressedIndex = [&gridLines](unsigned int const axis, unsigned int const coord) -> unsigned int {
+		return (unsigned int)(std::lower_bound(gridLines[axis].begin(), gridLines[axis].end(), coord) - gridLines[axis].begin());
+	};
+
+	// welding map (packed compressed grid index -> vert index)...
+	std::vector<glm::ivec3> verts;
+	std::vector<glm::uvec3> faces;
+	std::unordered_map<uint64_t, unsigned int> vertLookup;
+
+	auto weldVert = [&](glm::uvec3 const& gridIndex) -> unsigned int {
+		uint64_t const key = ((uint64_t)gridIndex.x << 42) | ((uint64_t)gridIndex.y << 21) | (uint64_t)gridIndex.z;
+		auto it = vertLookup.find(key);
+		if (vertLookup.end() != it) return it->second;
+
+		unsigned int const v = (unsigned int)verts.size();
+		verts.push_back(glm::ivec3(gridLines[0][gridIndex.x], gridLines[1][gridIndex.y], gridLines[2][gridIndex.z]));
+		vertLookup.emplace(key, v);
+		return v;
+	};
+
+	// 2. register the box faces plane by plane...
+	//NOTE: (a, u, v) is a cyclic permutation of (V1, V2, V3), so u x v = a and a quad wound u then v is CCW when seen from +a
+	struct PlaneRect {
+		unsigned int m_minU, m_maxU, m_minV, m_maxV; // compressed cell range [min, max)
+		int m_side; // +1 for a face looking along +a (max face of its box), -1 for a face looking along -a (min face of its box)
+	};
+
+	std::vector<int> coverage;
+	for (unsigned int a = 0; a < 3; ++a) {
+		unsigned int const u = (a + 1) % 3;
+		unsigned int const v = (a + 2) % 3;
+
+		std::vector<std::vector<PlaneRect>> planes(gridLines[a].size());
+		for (LeafBox const& box : leafBoxes) {
+			PlaneRect rect;
+			rect.m_minU = compressedIndex(u, box.m_min[u]);
+			rect.m_maxU = compressedIndex(u, box.m_max[u] + 1);
+			rect.m_minV = compressedIndex(v, box.m_min[v]);
+			rect.m_maxV = compressedIndex(v, box.m_max[v] + 1);
+
+			rect.m_side = -1;
+			planes.at(compressedIndex(a, box.m_min[a])).push_back(rect);
+			rect.m_side = 1;
+			planes.at(compressedIndex(a, box.m_max[a] + 1)).push_back(rect);
+		}
+
+		for (unsigned int plane = 0; plane < planes.size(); ++plane) {
+			std::vector<PlaneRect> const& rects = planes.at(plane);
+			if (rects.empty()) continue;
+
+			// net coverage of each cell (the boxes are disjoint, so a cell is covered by at most 1 box from each side and the 2 sides cancel out)...
+			unsigned int minU = rects.front().m_minU, maxU = rects.front().m_maxU, minV = rects.front().m_minV, maxV = rects.front().m_maxV;
+			for (PlaneRect const& rect : rects) {
+				minU = glm::min(minU, rect.m_minU);
+				maxU = glm::max(maxU, rect.m_maxU);
+				minV = glm::min(minV, rect.m_minV);
+				maxV = glm::max(maxV, rect.m_maxV);
+			}
+			unsigned int const nU = maxU - minU;
+			unsigned int const nV = maxV - minV;
+			coverage.assign((size_t)nU * nV, 0);
+			for (PlaneRect const& rect : rects) {
+				for (unsigned int cv = rect.m_minV; cv < rect.m_maxV; ++cv) {
+					for (unsigned int cu = rect.m_minU; cu < rect.m_maxU; ++cu) {
+						coverage[(size_t)(cv - minV) * nU + (cu - minU)] += rect.m_side;
+					}
+				}
+			}
+
+			// every remaining cell is an outer face...
+			for (unsigned int cv = minV; cv < maxV; ++cv) {
+				for (unsigned int cu = minU; cu < maxU; ++cu) {
+					int const side = coverage[(size_t)(cv - minV) * nU + (cu - minU)];
+					if (0 == side) continue;
+
+					glm::uvec3 corners[4];
+					unsigned int const cornerUV[4][2] = { { cu, cv }, { cu + 1, cv }, { cu + 1, cv + 1 }, { cu, cv + 1 } };
+					for (unsigned int c = 0; c < 4; ++c) {
+						corners[c][a] = plane;
+						corners[c][u] = cornerUV[c][0];
+						corners[c][v] = cornerUV[c][1];
+					}
+
+					unsigned int quad[4];
+					for (unsigned int c = 0; c < 4; ++c) quad[c] = weldVert(corners[c]);
+					if (side < 0) std::swap(quad[1], quad[3]); // flip to face along -a
+
+					faces.push_back(glm::uvec3(quad[0], quad[1], quad[2]));
+					faces.push_back(glm::uvec3(quad[0], quad[2], quad[3]));
+				}
+			}
+		}
+	}
+
+	// 3. get rid of the verts that were only added by the cutting...
+	removeRedundantVerts(verts, faces);
+
+	// 4. compact...
+	std::vector<unsigned int> remap(verts.size(), (unsigned int)-1);
+	for (glm::uvec3 const& face : faces) {
+		for (unsigned int c = 0; c < 3; ++c) {
+			if ((unsigned int)-1 == remap[face[c]]) {
+				remap[face[c]] = (unsigned int)welded.m_vertexCoords.size();
+				welded.m_vertexCoords.push_back(glm::uvec3(verts[face[c]]));
+			}
+			welded.m_faceIndices.push_back(remap[face[c]]);
+		}
+	}
+	welded.m_leafBoxes = leafBoxes;
+
+	return welded;
+}
+
+
+// a vert v can be collapsed onto a neighbour w without changing the surface if...
+// - all the faces around v lie in 1 plane (flat vert), or in 2 planes with v sitting in the middle of the straight crease between them (w must then be on that crease)
+// - the faces around v form a single closed fan (manifold vert)
+// - v and w only share the 2 neighbours opposite their common edge (link condition, otherwise the collapse would pinch the surface)
+// - none of the moved faces flips or degenerates
+// reference: https://www.cs.cmu.edu/~./garland/Papers/quadrics.pdf (edge contraction)
+void CageWelder::removeRedundantVerts(std::vector<glm::ivec3> &verts, std::vector<glm::uvec3> &faces) {
+	std::vector<bool> faceAlive(faces.size(), true);
+	std::vector<std::vector<unsigned int>> vertFaces(verts.size());
+	for (unsigned int f = 0; f < faces.size(); ++f) {
+		for (unsigned int c = 0; c < 3; ++c) vertFaces[faces[f][c]].push_back(f);
+	}
+
+	std::vector<unsigned int> worklist(verts.size());
+	std::vector<bool> queued(verts.size(), true);
+	for (unsigned int v = 0; v < verts.size(); ++v) worklist[v] = (unsigned int)verts.size() - 1 - v;
+
+	std::unordered_map<unsigned int, unsigned int> fanByFirst; // link vert a -> face (v, a, b) of the fan
+	std::vector<unsigned int> link;
+	std::vector<unsigned int> candidates;
+	std::vector<unsigned int> neighboursW;
+
+	while (!worklist.empty()) {
+		unsigned int const v = worklist.back();
+		worklist.pop_back();
+		queued[v] = false;
+
+		// 1. alive faces around v...
+		std::vector<unsigned int> &star = vertFaces[v];
+		star.erase(std::remove_if(star.begin(), star.end(), [&faceAlive](unsigned int const f) { return !faceAlive[f]; }), star.end());
+		if (star.size() < 3) continue;
+
+		// 2. they must form a single closed fan...
+		fanByFirst.clear();
+		bool manifold = true;
+		for (unsigned int f : star) {
+			unsigned int const c = cornerOf(faces[f], v);
+			if (!fanByFirst.emplace(faces[f][(c + 1) % 3], f).second) manifold = false;
+		}
+		if (!manifold) continue;
+
+		link.clear();
+		unsigned int f = star.front();
+		do {
+			unsigned int const c = cornerOf(faces[f], v);
+			link.push_back(faces[f][(c + 1) % 3]);
+			auto it = fanByFirst.find(faces[f][(c + 2) % 3]);
+			if (fanByFirst.end() == it) break;
+			f = it->second;
+		} while (f != star.front() && link.size() <= star.size());
+		if (f != star.front() || link.size() != star.size()) continue;
+
+		// 3. classify v by the planes around it...
+		int directions[2] = { -1, -1 };
+		unsigned int directionCount = 0;
+		for (unsigned int sf : star) {
+			int const direction = normalDirection(verts, faces[sf]);
+			if (-1 == direction) {
+				directionCount = 3;
+				break;
+			}
+			if (0 < directionCount && direction == directions[0]) continue;
+			if (1 < directionCount && direction == directions[1]) continue;
+			if (2 == directionCount) {
+				directionCount = 3;
+				break;
+			}
+			directions[directionCount++] = direction;
+		}
+
+		candidates.clear();
+		if (1 == directionCount) { // flat
+			candidates = link;
+		}
+		else if (2 == directionCount && directions[0] / 2 != directions[1] / 2) { // crease (the 2 planes have to be perpendicular)
+			// crease neighbours are the ones whose 2 faces (v, w, x) and (v, y, w) lie in different planes
+			for (unsigned int w : link) {
+				unsigned int const faceAfter = fanByFirst.at(w);
+				unsigned int faceBefore = faceAfter;
+				for (unsigned int sf : star) {
+					unsigned int const c = cornerOf(faces[sf], v);
+					if (w == faces[sf][(c + 2) % 3]) faceBefore = sf;
+				}
+				if (normalDirection(verts, faces[faceAfter]) != normalDirection(verts, faces[faceBefore])) candidates.push_back(w);
+			}
+			if (2 != candidates.size()) continue;
+
+			// v must be in the middle of a straight crease...
+			glm::ivec3 const d1 = verts[candidates[0]] - verts[v];
+			glm::ivec3 const d2 = verts[candidates[1]] - verts[v];
+			int64_t const crossX = (int64_t)d1.y * d2.z - (int64_t)d1.z * d2.y;
+			int64_t const crossY = (int64_t)d1.z * d2.x - (int64_t)d1.x * d2.z;
+			int64_t const crossZ = (int64_t)d1.x * d2.y - (int64_t)d1.y * d2.x;
+			int64_t const dot = (int64_t)d1.x * d2.x + (int64_t)d1.y * d2.y + (int64_t)d1.z * d2.z;
+			if (0 != crossX || 0 != crossY || 0 != crossZ || dot >= 0) continue;
+		}
+		else { // corner (or something weirder) - keep
+			continue;
+		}
+
+		// 4. find a neighbour that v can be collapsed onto...
+		for (unsigned int w : candidates) {
+			// 4.1. link condition...
+			neighboursW.clear();
+			for (unsigned int wf : vertFaces[w]) {
+				if (!faceAlive[wf]) continue;
+				for (unsigned int c = 0; c < 3; ++c) neighboursW.push_back(faces[wf][c]);
+			}
+			std::sort(neighboursW.begin(), neighboursW.end());
+			neighboursW.erase(std::unique(neighboursW.begin(), neighboursW.end()), neighboursW.end());
+
+			unsigned int shared = 0;
+			for (unsigned int l : link) {
+				if (l != w && std::binary_search(neighboursW.begin(), neighboursW.end(), l)) ++shared;
+			}
+			if (2 != shared) continue;
+
+			// 4.2. no flipped or degenerate faces...
+			bool valid = true;
+			for (unsigned int sf : star) {
+				if (3 != cornerOf(faces[sf], w)) continue; // this face collapses away
+				glm::uvec3 moved = faces[sf];
+				moved[cornerOf(moved, v)] = w;
+				if (normalDirection(verts, moved) != normalDirection(verts, faces[sf])) {
+					valid = false;
+					break;
+				}
+			}
+			if (!valid) continue;
+
+			// 4.3. collapse v onto w...
+			for (unsigned int sf : star) {
+				if (3 != cornerOf(faces[sf], w)) {
+					faceAlive[sf] = false;
+				}
+				else {
+					faces[sf][cornerOf(faces[sf], v)] = w;
+					vertFaces[w].push_back(sf);
+				}
+			}
+			star.clear();
+
+			// the neighbourhood changed, so these might be collapsible now
+			if (!queued[w]) {
+				queued[w] = true;
+				worklist.push_back(w);
+			}
+			for (unsigned int l : link) {
+				if (!queued[l]) {
+					queued[l] = true;
+					worklist.push_back(l);
+				}
+			}
+			break;
+		}
+	}
+
+	// drop the dead faces...
+	std::vector<glm::uvec3> aliveFaces;
+	aliveFaces.reserve(faces.size());
+	for (unsigned int f = 0; f < faces.size(); ++f) {
+		if (faceAlive[f]) aliveFaces.push_back(faces[f]);
+	}
+	faces.swap(aliveFaces);
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "MeshTree.h"
+
+
+// turns the leaf OBBs of a MeshTree into a single watertight cage surface (internal face culling + face registration)
+// 1. every box face is cut along the global grid lines (all box coordinates on the other 2 axes), so faces on a split plane are registered against each other cell by cell
+// 2. cells covered from both sides of a split plane cancel (internal faces), the rest become outward facing quads - partially overlapping faces are thus re-triangulated for free
+// 3. coincident grid coordinates are welded through a hash map
+// 4. the extra verts introduced by the cutting are collapsed away again (flat verts and verts in the middle of a straight crease), leaving the union's corners
+//NOTE: since every face is cut at every global grid line crossing it, no vert can lie in the middle of another face's edge, so the result has no T-junctions
+class CageWelder {
+
+public:
+	// output coords are integer grid coordinates (same convention as MeshTree::m_vertexCoords), faces are CCW when seen from outside (in the V1, V2, V3 index space)
+	static MeshTree weld(std::vector<LeafBox> const& leafBoxes);
+
+private:
+	// edge collapses that don't change the surface (see step 4)
+	static void removeRedundantVerts(std::vector<glm::ivec3> &verts, std::vector<glm::uvec3> &faces);
+};
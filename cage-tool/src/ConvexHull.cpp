@@ -0,0 +1,382 @@
+#include "ConvexHull.h"
+
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+
+#include "ParallelTools.h"
+
+namespace {
+	// working face of the quickhull (everything is done in double precision to keep the plane tests stable)
+	//NOTE: edge e goes from m_v[e] to m_v[(e + 1) % 3] and m_neighbours[e] is the face on the other side of that edge
+	struct QuickhullFace {
+		unsigned int m_v[3] = {};
+		unsigned int m_neighbours[3] = {};
+		glm::dvec3 m_normal;
+		double m_offset;
+		std::vector<unsigned int> m_outside; // points above this face (conflict list)
+		unsigned int m_visitMark = 0;
+		bool m_deleted = false;
+
+		double distance(glm::dvec3 const& p) const { return glm::dot(m_normal, p) - m_offset; }
+	};
+
+	// index of the edge (from, to) in face f (or 3 if f doesn't have that edge)
+	unsigned int findEdge(QuickhullFace const& f, unsigned int const from, unsigned int const to) {
+		for (unsigned int e = 0; e < 3; ++e) {
+			if (f.m_v[e] == from && f.m_v[(e + 1) % 3] == to) return e;
+		}
+		return 3;
+	}
+
+	void computePlane(QuickhullFace &f, std::vector<glm::dvec3> const& pts) {
+		glm::dvec3 const& a = pts[f.m_v[0]];
+		glm::dvec3 const normal = glm::cross(pts[f.m_v[1]] - a, pts[f.m_v[2]] - a);
+		double const normalLength = glm::length(normal);
+		if (normalLength > 0.0) f.m_normal = normal / normalLength; //NOTE: a sliver face keeps whatever normal it was given (e.g. the one of the face it replaces)
+		f.m_offset = glm::dot(f.m_normal, a);
+	}
+}
+
+
+HullMesh ConvexHull::computeHull(std::vector<glm::vec3> const& points) {
+	// 1. throw away the points that clearly can't be on the hull...
+	std::vector<glm::vec3> const candidates = reduceToCandidates(points);
+
+	// small sets aren't worth splitting up
+	size_t const minChunkSize = 4096;
+	unsigned int const threadCount = ParallelTools::getThreadCount();
+	if (threadCount <= 1 || candidates.size() < 2 * minChunkSize) return quickhull(candidates);
+
+	// 2. hull of every chunk (in parallel)...
+	std::vector<std::vector<glm::vec3>> chunkHullVertices(threadCount);
+
+	ParallelTools::parallelForRange(candidates.size(), [&candidates, &chunkHullVertices](size_t const begin, size_t const end, unsigned int const threadIndex) {
+		std::vector<glm::vec3> const chunk(candidates.begin() + begin, candidates.begin() + end);
+		chunkHullVertices[threadIndex] = quickhull(chunk).m_vertices;
+	}, minChunkSize);
+
+	// 3. merge...
+	std::vector<glm::vec3> mergedVertices;
+	for (std::vector<glm::vec3> const& vertices : chunkHullVertices) mergedVertices.insert(mergedVertices.end(), vertices.begin(), vertices.end());
+
+	return quickhull(mergedVertices);
+}
+
+
+HullMesh ConvexHull::quickhull(std::vector<glm::vec3> const& points) {
+	HullMesh hull;
+	hull.m_vertices = points; // degenerate fallback (see HullMesh)
+	if (points.size() < 4) return hull;
+
+	std::vector<glm::dvec3> pts(points.size());
+	double maxAbs[3] = { 0.0, 0.0, 0.0 };
+	for (size_t i = 0; i < points.size(); ++i) {
+		pts[i] = glm::dvec3(points[i]);
+		for (unsigned int a = 0; a < 3; ++a) maxAbs[a] = glm::max(maxAbs[a], glm::abs(pts[i][a]));
+	}
+
+	// plane distance tolerance, scaled to the magnitude of the input (the points were floats, so anything closer than a few float ulps is considered coplanar)
+	double const epsilon = (maxAbs[0] + maxAbs[1] + maxAbs[2]) * 4.0 * std::numeric_limits<float>::epsilon();
+
+	// 1. initial tetrahedron...
+	// 1.1. pick the 2 furthest apart of the 6 axis-extreme points
+	unsigned int extremes[6] = { 0, 0, 0, 0, 0, 0 }; // minX, maxX, minY, maxY, minZ, maxZ
+	for (unsigned int i = 0; i < pts.size(); ++i) {
+		for (unsigned int a = 0; a < 3; ++a) {
+			if (pts[i][a] < pts[extremes[2 * a]][a]) extremes[2 * a] = i;
+			if (pts[i][a] > pts[extremes[2 * a + 1]][a]) extremes[2 * a + 1] = i;
+		}
+	}
+
+	unsigned int simplex[4] = { 0, 0, 0, 0 };
+	double maxDist = -1.0;
+	for (unsigned int e1 = 0; e1 < 6; ++e1) {
+		for (unsigned int e2 = e1 + 1; e2 < 6; ++e2) {
+			double const dist = glm::length(pts[extremes[e1]] - pts[extremes[e2]]);
+			if (dist > maxDist) {
+				maxDist = dist;
+				simplex[0] = extremes[e1];
+				simplex[1] = extremes[e2];
+			}
+		}
+	}
+	if (maxDist <= epsilon) return hull;
+
+	// 1.2. the point furthest from that line
+	glm::dvec3 const lineDir = glm::normalize(pts[simplex[1]] - pts[simplex[0]]);
+	maxDist = -1.0;
+	for (unsigned int i = 0; i < pts.size(); ++i) {
+		double const dist = glm::length(glm::cross(pts[i] - pts[simplex[0]], lineDir));
+		if (dist > maxDist) {
+			maxDist = dist;
+			simplex[2] = i;
+		}
+	}
+	if (maxDist <= epsilon) return hull;
+
+	// 1.3. the point furthest from that plane
+	glm::dvec3 const baseNormal = glm::normalize(glm::cross(pts[simplex[1]] - pts[simplex[0]], pts[simplex[2]] - pts[simplex[0]]));
+	maxDist = -1.0;
+	for (unsigned int i = 0; i < pts.size(); ++i) {
+		double const dist = glm::abs(glm::dot(pts[i] - pts[simplex[0]], baseNormal));
+		if (dist > maxDist) {
+			maxDist = dist;
+			simplex[3] = i;
+		}
+	}
+	if (maxDist <= epsilon) return hull;
+
+	// 1.4. build the 4 faces, each wound so that the opposite simplex vertex is below it...
+	std::vector<QuickhullFace> faces;
+	unsigned int const tetraFaces[4][4] = { { 0, 1, 2, 3 }, { 0, 1, 3, 2 }, { 0, 2, 3, 1 }, { 1, 2, 3, 0 } }; // 3 face verts + the opposite vert
+	for (unsigned int t = 0; t < 4; ++t) {
+		QuickhullFace f;
+		f.m_v[0] = simplex[tetraFaces[t][0]];
+		f.m_v[1] = simplex[tetraFaces[t][1]];
+		f.m_v[2] = simplex[tetraFaces[t][2]];
+		computePlane(f, pts);
+		if (f.distance(pts[simplex[tetraFaces[t][3]]]) > 0.0) {
+			std::swap(f.m_v[1], f.m_v[2]);
+			computePlane(f, pts);
+		}
+		faces.push_back(f);
+	}
+	for (unsigned int f = 0; f < 4; ++f) {
+		for (unsigned int e = 0; e < 3; ++e) {
+			for (unsigned int g = 0; g < 4; ++g) {
+				if (g != f && 3 != findEdge(faces[g], faces[f].m_v[(e + 1) % 3], faces[f].m_v[e])) faces[f].m_neighbours[e] = g;
+			}
+		}
+	}
+
+	// 1.5. give every point to the first face it is above (points that aren't above any face are inside and gone for good)...
+	for (unsigned int i = 0; i < pts.size(); ++i) {
+		for (QuickhullFace &f : faces) {
+			if (f.distance(pts[i]) > epsilon) {
+				f.m_outside.push_back(i);
+				break;
+			}
+		}
+	}
+
+	// 2. keep pushing the hull out to the furthest conflict point of a face until no conflict points are left...
+	unsigned int visitMark = 0;
+	std::vector<unsigned int> visible;
+	std::vector<unsigned int> stack;
+	struct HorizonEdge {
+		unsigned int m_from;
+		unsigned int m_to;
+		unsigned int m_outerFace; // non-visible face on the other side
+	};
+	std::vector<HorizonEdge> horizon;
+	std::unordered_map<unsigned int, unsigned int> horizonByFrom;
+	std::unordered_map<unsigned int, unsigned int> horizonByTo;
+
+	for (unsigned int f = 0; f < faces.size(); ++f) {
+		while (!faces[f].m_deleted && !faces[f].m_outside.empty()) {
+			// 2.1. eye point = furthest conflict point...
+			std::vector<unsigned int> &conflicts = faces[f].m_outside;
+			unsigned int eyeSlot = 0;
+			for (unsigned int c = 1; c < conflicts.size(); ++c) {
+				if (faces[f].distance(pts[conflicts[c]]) > faces[f].distance(pts[conflicts[eyeSlot]])) eyeSlot = c;
+			}
+			unsigned int const eye = conflicts[eyeSlot];
+			glm::dvec3 const& eyePoint = pts[eye];
+
+			// 2.2. flood out the faces that can see the eye point...
+			++visitMark;
+			visible.clear();
+			stack.clear();
+			faces[f].m_visitMark = visitMark;
+			stack.push_back(f);
+			while (!stack.empty()) {
+				unsigned int const v = stack.back();
+				stack.pop_back();
+				visible.push_back(v);
+				for (unsigned int e = 0; e < 3; ++e) {
+					unsigned int const n = faces[v].m_neighbours[e];
+					if (visitMark != faces[n].m_visitMark && faces[n].distance(eyePoint) > epsilon) {
+						faces[n].m_visitMark = visitMark;
+						stack.push_back(n);
+					}
+				}
+			}
+
+			// 2.3. the horizon is every edge between a visible and a non-visible face...
+			horizon.clear();
+			horizonByFrom.clear();
+			horizonByTo.clear();
+			for (unsigned int v : visible) {
+				for (unsigned int e = 0; e < 3; ++e) {
+					unsigned int const n = faces[v].m_neighbours[e];
+					if (visitMark != faces[n].m_visitMark) {
+						HorizonEdge h;
+						h.m_from = faces[v].m_v[e];
+						h.m_to = faces[v].m_v[(e + 1) % 3];
+						h.m_outerFace = n;
+						horizonByFrom[h.m_from] = (unsigned int)horizon.size();
+						horizonByTo[h.m_to] = (unsigned int)horizon.size();
+						horizon.push_back(h);
+					}
+				}
+			}
+
+			//NOTE: with round-off the visible region can (very rarely) stop being a disk, which would give more than 1 horizon loop
+			//NOTE: the eye point is within round-off of the hull in that case anyway, so it is just dropped
+			bool singleLoop = horizon.size() >= 3 && horizonByFrom.size() == horizon.size() && horizonByTo.size() == horizon.size();
+			if (singleLoop) {
+				unsigned int loopLength = 0;
+				unsigned int h = 0;
+				do {
+					auto it = horizonByFrom.find(horizon[h].m_to);
+					if (horizonByFrom.end() == it) break;
+					h = it->second;
+					++loopLength;
+				} while (0 != h && loopLength <= horizon.size());
+				singleLoop = 0 == h && loopLength == horizon.size();
+			}
+			if (!singleLoop) {
+				conflicts.erase(conflicts.begin() + eyeSlot);
+				continue;
+			}
+
+			// 2.4. replace the visible faces with a cone of new faces from the horizon to the eye point...
+			unsigned int const firstNewFace = (unsigned int)faces.size();
+			for (unsigned int h = 0; h < horizon.size(); ++h) {
+				QuickhullFace newFace;
+				newFace.m_v[0] = horizon[h].m_from;
+				newFace.m_v[1] = horizon[h].m_to;
+				newFace.m_v[2] = eye;
+				newFace.m_normal = faces[f].m_normal;
+				computePlane(newFace, pts);
+
+				newFace.m_neighbours[0] = horizon[h].m_outerFace;
+				newFace.m_neighbours[1] = firstNewFace + horizonByFrom[horizon[h].m_to]; // across (to, eye)
+				newFace.m_neighbours[2] = firstNewFace + horizonByTo[horizon[h].m_from]; // across (eye, from)
+
+				// re-link the outer face to the new face...
+				QuickhullFace &outer = faces[horizon[h].m_outerFace];
+				outer.m_neighbours[findEdge(outer, horizon[h].m_to, horizon[h].m_from)] = firstNewFace + h;
+
+				faces.push_back(newFace);
+			}
+
+			// 2.5. hand the conflict points of the visible faces over to the new faces...
+			for (unsigned int v : visible) {
+				for (unsigned int p : faces[v].m_outside) {
+					if (eye == p) continue;
+					for (unsigned int n = firstNewFace; n < faces.size(); ++n) {
+						if (faces[n].distance(pts[p]) > epsilon) {
+							faces[n].m_outside.push_back(p);
+							break;
+						}
+					}
+				}
+				faces[v].m_deleted = true;
+				std::vector<unsigned int>().swap(faces[v].m_outside);
+			}
+		}
+	}
+
+	// 3. compact the surviving faces + the verts they use...
+	hull.m_vertices.clear();
+	std::vector<unsigned int> remap(pts.size(), std::numeric_limits<unsigned int>::max());
+	for (QuickhullFace const& f : faces) {
+		if (f.m_deleted) continue;
+		glm::uvec3 face;
+		for (unsigned int c = 0; c < 3; ++c) {
+			if (std::numeric_limits<unsigned int>::max() == remap[f.m_v[c]]) {
+				remap[f.m_v[c]] = (unsigned int)hull.m_vertices.size();
+				hull.m_vertices.push_back(points[f.m_v[c]]);
+			}
+			face[c] = remap[f.m_v[c]];
+		}
+		hull.m_faces.push_back(face);
+	}
+
+	return hull;
+}
+
+
+// AKL-TOUSSAINT HEURISTIC...
+// the 6 axis-extreme points span an octahedron that lies inside the convex hull, so any point strictly inside that octahedron can't be a hull vertex and is thrown away
+// reference: https://en.wikipedia.org/wiki/Convex_hull_algorithms#Akl%E2%80%93Toussaint_heuristic
+//NOTE: if the octahedron is degenerate (e.g. flat model) no points are thrown away
+std::vector<glm::vec3> ConvexHull::reduceToCandidates(std::vector<glm::vec3> const& points) {
+	if (points.size() < 8) return points;
+
+	// 1. find the 6 extreme points (min/max along x, y, z)...
+	unsigned int const threadCount = ParallelTools::getThreadCount();
+	std::vector<size_t> partialExtremes(6 * threadCount, 0);
+
+	ParallelTools::parallelForRange(points.size(), [&](size_t const begin, size_t const end, unsigned int const threadIndex) {
+		size_t extremes[6] = { begin, begin, begin, begin, begin, begin }; // minX, maxX, minY, maxY, minZ, maxZ
+		for (size_t i = begin; i < end; ++i) {
+			for (unsigned int a = 0; a < 3; ++a) {
+				if (points[i][a] < points[extremes[2 * a]][a]) extremes[2 * a] = i;
+				if (points[i][a] > points[extremes[2 * a + 1]][a]) extremes[2 * a + 1] = i;
+			}
+		}
+		for (unsigned int e = 0; e < 6; ++e) partialExtremes[6 * threadIndex + e] = extremes[e];
+	});
+
+	size_t extremes[6] = { 0, 0, 0, 0, 0, 0 };
+	for (unsigned int t = 0; t < threadCount; ++t) {
+		for (unsigned int a = 0; a < 3; ++a) {
+			size_t const minCandidate = partialExtremes[6 * t + 2 * a];
+			size_t const maxCandidate = partialExtremes[6 * t + 2 * a + 1];
+			if (points[minCandidate][a] < points[extremes[2 * a]][a]) extremes[2 * a] = minCandidate;
+			if (points[maxCandidate][a] > points[extremes[2 * a + 1]][a]) extremes[2 * a + 1] = maxCandidate;
+		}
+	}
+
+	// 2. build the 8 (outward facing) planes of the octahedron...
+	glm::vec3 centre = glm::vec3(0.0f, 0.0f, 0.0f);
+	for (unsigned int e = 0; e < 6; ++e) centre += points[extremes[e]];
+	centre /= 6.0f;
+
+	float const diagonal = glm::length(glm::vec3(points[extremes[1]].x - points[extremes[0]].x, points[extremes[3]].y - points[extremes[2]].y, points[extremes[5]].z - points[extremes[4]].z));
+	float const epsilon = diagonal * 1e-5f; // only throw away points that are clearly inside
+
+	glm::vec3 planeNormals[8];
+	float planeOffsets[8];
+	for (unsigned int p = 0; p < 8; ++p) {
+		glm::vec3 const& a = points[extremes[0 + ((p >> 0) & 1)]];
+		glm::vec3 const& b = points[extremes[2 + ((p >> 1) & 1)]];
+		glm::vec3 const& c = points[extremes[4 + ((p >> 2) & 1)]];
+
+		glm::vec3 normal = glm::cross(b - a, c - a);
+		float const normalLength = glm::length(normal);
+		if (normalLength <= epsilon * epsilon) return points; // degenerate face
+
+		normal /= normalLength;
+		if (glm::dot(normal, centre - a) > 0.0f) normal = -normal; // make it face outwards
+
+		// the centre has to be clearly inside, otherwise the octahedron is flat
+		if (glm::dot(normal, centre - a) > -epsilon) return points;
+
+		planeNormals[p] = normal;
+		planeOffsets[p] = glm::dot(normal, a);
+	}
+
+	// 3. keep everything that isn't strictly inside all 8 planes (order preserving)...
+	std::vector<std::vector<glm::vec3>> partialCandidates(threadCount);
+
+	ParallelTools::parallelForRange(points.size(), [&](size_t const begin, size_t const end, unsigned int const threadIndex) {
+		std::vector<glm::vec3> &candidates = partialCandidates[threadIndex];
+		for (size_t i = begin; i < end; ++i) {
+			glm::vec3 const& q = points[i];
+			bool inside = true;
+			for (unsigned int p = 0; p < 8 && inside; ++p) {
+				inside = glm::dot(planeNormals[p], q) - planeOffsets[p] < -epsilon;
+			}
+			if (!inside) candidates.push_back(q);
+		}
+	});
+
+	std::vector<glm::vec3> candidates;
+	for (std::vector<glm::vec3> const& partial : partialCandidates) candidates.insert(candidates.end(), partial.begin(), partial.end());
+
+	return candidates;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+
+
+// triangulated convex hull
+//NOTE: faces are wound counter-clockwise when seen from the outside (so cross(b - a, c - a) is the outward normal)
+//NOTE: if the input is degenerate (less than 4 points, or all points (nearly) coplanar) there are no faces and m_vertices just holds the candidate points
+struct HullMesh {
+	std::vector<glm::vec3> m_vertices;
+	std::vector<glm::uvec3> m_faces; // indices into m_vertices
+};
+
+
+// 3D convex hull of a point set (QUICKHULL)
+// reference: https://en.wikipedia.org/wiki/Quickhull
+// reference: http://media.steampowered.com/apps/valve/2014/DirkGregorius_ImplementingQuickHull.pdf
+class ConvexHull {
+
+public:
+	// parallel quickhull...
+	// 1. the Akl-Toussaint filter throws away the bulk of the interior points
+	// 2. the remaining candidates are split into one chunk per thread and each chunk gets its own hull
+	// 3. the final hull is the hull of the union of the chunk hull vertices (the hull of a union is the hull of the union of the hulls)
+	static HullMesh computeHull(std::vector<glm::vec3> const& points);
+
+	// subset of the points that still contains every convex hull vertex
+	static std::vector<glm::vec3> reduceToCandidates(std::vector<glm::vec3> const& points);
+
+private:
+	// serial quickhull of the given points
+	static HullMesh quickhull(std::vector<glm::vec3> const& points);
+};
@@ -0,0 +1,212 @@
+#include "HalfEdgeMesh.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+
+
+bool HalfEdgeMesh::build(std::vector<glm::vec3> const& verts, std::vector<unsigned int> const& faceIndices) {
+	unsigned int const faceCount = (unsigned int)(faceIndices.size() / 3);
+
+	m_positions = verts;
+	m_vertexHalfEdges.assign(verts.size(), s_INVALID);
+	m_faceHalfEdges.assign(faceCount, s_INVALID);
+	m_halfEdges.assign(3 * faceCount, HalfEdge());
+	m_isVertexRemoved.assign(verts.size(), false);
+	m_isFaceRemoved.assign(faceCount, false);
+	m_isHalfEdgeRemoved.assign(3 * faceCount, false);
+
+	// 1. half-edges (half-edge 3f + c goes from corner c to corner c + 1 of face f)...
+	auto edgeKey = [](unsigned int const from, unsigned int const to) -> uint64_t {
+		return ((uint64_t)from << 32) | to;
+	};
+	std::unordered_map<uint64_t, unsigned int> directedEdges;
+	directedEdges.reserve(3 * faceCount);
+
+	std::vector<unsigned int> outgoingCounts(verts.size(), 0);
+	for (unsigned int f = 0; f < faceCount; ++f) {
+		m_faceHalfEdges.at(f) = 3 * f;
+		for (unsigned int c = 0; c < 3; ++c) {
+			unsigned int const from = faceIndices.at(3 * f + c);
+			unsigned int const to = faceIndices.at(3 * f + (c + 1) % 3);
+			if (from == to || from >= verts.size() || to >= verts.size()) return false; // degenerate face
+
+			unsigned int const h = 3 * f + c;
+			m_halfEdges.at(h).m_vertex = to;
+			m_halfEdges.at(h).m_next = 3 * f + (c + 1) % 3;
+			m_halfEdges.at(h).m_face = f;
+			m_vertexHalfEdges.at(from) = h;
+			++outgoingCounts.at(from);
+
+			// the same directed edge twice means either an inconsistent orientation or more than 2 faces on the edge
+			if (!directedEdges.emplace(edgeKey(from, to), h).second) return false;
+		}
+	}
+
+	// 2. twins (every edge needs one, or the surface has a boundary)...
+	for (unsigned int h = 0; h < m_halfEdges.size(); ++h) {
+		auto const it = directedEdges.find(edgeKey(m_halfEdges.at(h).m_vertex, from(h)));
+		if (directedEdges.end() == it) return false;
+		m_halfEdges.at(h).m_twin = it->second;
+	}
+
+	// 3. every vert must have a single fan of faces around it (otherwise it's a non-manifold vert)...
+	m_vertexCount = 0;
+	for (unsigned int v = 0; v < verts.size(); ++v) {
+		if (s_INVALID == m_vertexHalfEdges.at(v)) {
+			m_isVertexRemoved.at(v) = true; // unreferenced
+			continue;
+		}
+
+		unsigned int fanSize = 0;
+		unsigned int h = m_vertexHalfEdges.at(v);
+		do {
+			++fanSize;
+			h = nextOutgoing(h);
+		} while (h != m_vertexHalfEdges.at(v) && fanSize <= outgoingCounts.at(v));
+		if (fanSize != outgoingCounts.at(v)) return false;
+
+		++m_vertexCount;
+	}
+	m_faceCount = faceCount;
+
+	return true;
+}
+
+
+
+void HalfEdgeMesh::toTriangles(std::vector<glm::vec3> &out_verts, std::vector<unsigned int> &out_faceIndices) const {
+	out_verts.clear();
+	out_faceIndices.clear();
+	out_verts.reserve(m_vertexCount);
+	out_faceIndices.reserve(3 * m_faceCount);
+
+	std::vector<unsigned int> remap(m_positions.size(), s_INVALID);
+	for (unsigned int v = 0; v < m_positions.size(); ++v) {
+		if (m_isVertexRemoved.at(v)) continue;
+		remap.at(v) = (unsigned int)out_verts.size();
+		out_verts.push_back(m_positions.at(v));
+	}
+
+	for (unsigned int f = 0; f < m_faceHalfEdges.size(); ++f) {
+		if (m_isFaceRemoved.at(f)) continue;
+		unsigned int h = m_faceHalfEdges.at(f);
+		for (unsigned int c = 0; c < 3; ++c) {
+			out_faceIndices.push_back(remap.at(from(h)));
+			h = m_halfEdges.at(h).m_next;
+		}
+	}
+}
+
+
+
+void HalfEdgeMesh::getOneRing(unsigned int const v, std::vector<unsigned int> &out_verts) const {
+	out_verts.clear();
+	unsigned int const start = m_vertexHalfEdges.at(v);
+	unsigned int h = start;
+	do {
+		out_verts.push_back(m_halfEdges.at(h).m_vertex);
+		h = nextOutgoing(h);
+	} while (h != start);
+}
+
+
+
+void HalfEdgeMesh::getFaceRing(unsigned int const v, std::vector<unsigned int> &out_faces) const {
+	out_faces.clear();
+	unsigned int const start = m_vertexHalfEdges.at(v);
+	unsigned int h = start;
+	do {
+		out_faces.push_back(m_halfEdges.at(h).m_face);
+		h = nextOutgoing(h);
+	} while (h != start);
+}
+
+
+
+glm::dvec3 HalfEdgeMesh::getFaceAreaNormal(unsigned int const f) const {
+	unsigned int const h0 = m_faceHalfEdges.at(f);
+	unsigned int const h1 = m_halfEdges.at(h0).m_next;
+	glm::dvec3 const p0 = m_positions.at(from(h0));
+	glm::dvec3 const p1 = m_positions.at(m_halfEdges.at(h0).m_vertex);
+	glm::dvec3 const p2 = m_positions.at(m_halfEdges.at(h1).m_vertex);
+	return glm::cross(p1 - p0, p2 - p0);
+}
+
+
+
+bool HalfEdgeMesh::isCollapseValid(unsigned int const h) const {
+	//NOTE: a tetrahedron is the smallest closed surface, it can't lose any more verts
+	if (m_vertexCount <= 4) return false;
+
+	unsigned int const t = m_halfEdges.at(h).m_twin;
+	unsigned int const a = from(h);
+	unsigned int const b = m_halfEdges.at(h).m_vertex;
+	unsigned int const c = m_halfEdges.at(m_halfEdges.at(h).m_next).m_vertex;
+	unsigned int const d = m_halfEdges.at(m_halfEdges.at(t).m_next).m_vertex;
+	if (c == d) return false;
+
+	// link condition: a and b may only share the 2 verts opposite the edge, otherwise the collapse pinches the surface
+	// reference: Dey, Edelsbrunner, Guha, Nekhayev - Topology preserving edge contraction (1999)
+	std::vector<unsigned int> ringA;
+	std::vector<unsigned int> ringB;
+	getOneRing(a, ringA);
+	getOneRing(b, ringB);
+	std::sort(ringA.begin(), ringA.end());
+	for (unsigned int const w : ringB) {
+		if (w == c || w == d) continue;
+		if (std::binary_search(ringA.begin(), ringA.end(), w)) return false;
+	}
+
+	return true;
+}
+
+
+
+void HalfEdgeMesh::collapse(unsigned int const h, glm::vec3 const& newPosition) {
+	// h = a -> b in face (a, b, c), its twin t = b -> a in face (b, a, d)
+	unsigned int const h1 = m_halfEdges.at(h).m_next; // b -> c
+	unsigned int const h2 = m_halfEdges.at(h1).m_next; // c -> a
+	unsigned int const t = m_halfEdges.at(h).m_twin;
+	unsigned int const g1 = m_halfEdges.at(t).m_next; // a -> d
+	unsigned int const g2 = m_halfEdges.at(g1).m_next; // d -> b
+
+	unsigned int const a = from(h);
+	unsigned int const b = m_halfEdges.at(h).m_vertex;
+	unsigned int const c = m_halfEdges.at(h1).m_vertex;
+	unsigned int const d = m_halfEdges.at(g1).m_vertex;
+
+	unsigned int const th1 = m_halfEdges.at(h1).m_twin; // c -> b
+	unsigned int const th2 = m_halfEdges.at(h2).m_twin; // a -> c
+	unsigned int const tg1 = m_halfEdges.at(g1).m_twin; // d -> a
+	unsigned int const tg2 = m_halfEdges.at(g2).m_twin; // b -> d
+
+	// 1. everything that pointed to a now points to b...
+	unsigned int e = h;
+	do {
+		m_halfEdges.at(m_halfEdges.at(e).m_twin).m_vertex = b;
+		e = nextOutgoing(e);
+	} while (e != h);
+
+	// 2. the 2 removed faces leave their outer edges unpaired, so pair those up with each other...
+	m_halfEdges.at(th1).m_twin = th2;
+	m_halfEdges.at(th2).m_twin = th1;
+	m_halfEdges.at(tg1).m_twin = tg2;
+	m_halfEdges.at(tg2).m_twin = tg1;
+
+	// 3. the outgoing half-edges of b, c, d might have been removed...
+	m_vertexHalfEdges.at(b) = tg2;
+	m_vertexHalfEdges.at(c) = th1;
+	m_vertexHalfEdges.at(d) = tg1;
+
+	// 4. remove a and the 2 faces...
+	for (unsigned int const removed : { h, h1, h2, t, g1, g2 }) m_isHalfEdgeRemoved.at(removed) = true;
+	m_isFaceRemoved.at(m_halfEdges.at(h).m_face) = true;
+	m_isFaceRemoved.at(m_halfEdges.at(t).m_face) = true;
+	m_isVertexRemoved.at(a) = true;
+	m_vertexHalfEdges.at(a) = s_INVALID;
+
+	m_positions.at(b) = newPosition;
+	--m_vertexCount;
+	m_faceCount -= 2;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+
+
+// closed, manifold triangle mesh with half-edge connectivity (supports edge collapses in place)
+// reference: https://en.wikipedia.org/wiki/Doubly_connected_edge_list
+//NOTE: removed verts/faces/half-edges are only flagged, so indices stay stable until toTriangles compacts the mesh
+class HalfEdgeMesh {
+
+public:
+	static constexpr unsigned int s_INVALID = 0xFFFFFFFF;
+
+	struct HalfEdge {
+		unsigned int m_vertex = s_INVALID; // vert this half-edge points to
+		unsigned int m_next = s_INVALID; // next half-edge around the same face (CCW)
+		unsigned int m_twin = s_INVALID; // opposite half-edge (in the neighbouring face)
+		unsigned int m_face = s_INVALID;
+	};
+
+	std::vector<glm::vec3> m_positions;
+	std::vector<unsigned int> m_vertexHalfEdges; // one outgoing half-edge per vert
+	std::vector<unsigned int> m_faceHalfEdges; // one half-edge per face
+	std::vector<HalfEdge> m_halfEdges;
+
+	std::vector<bool> m_isVertexRemoved;
+	std::vector<bool> m_isFaceRemoved;
+	std::vector<bool> m_isHalfEdgeRemoved;
+
+	// RETURNS false if the faces don't describe a closed, consistently oriented, manifold surface
+	//NOTE: faces are 3 indices in a row into verts (CCW when seen from outside), coincident verts must already be merged
+	bool build(std::vector<glm::vec3> const& verts, std::vector<unsigned int> const& faceIndices);
+
+	// compacted copy of the surviving verts/faces (3 indices in a row per face)
+	void toTriangles(std::vector<glm::vec3> &out_verts, std::vector<unsigned int> &out_faceIndices) const;
+
+	unsigned int getVertexCount() const { return m_vertexCount; }
+	unsigned int getFaceCount() const { return m_faceCount; }
+
+	unsigned int prev(unsigned int const h) const { return m_halfEdges[m_halfEdges[h].m_next].m_next; }
+	unsigned int from(unsigned int const h) const { return m_halfEdges[prev(h)].m_vertex; }
+
+	// next outgoing half-edge of the same vert (CCW around the vert)
+	unsigned int nextOutgoing(unsigned int const h) const { return m_halfEdges[prev(h)].m_twin; }
+
+	// verts around v (in order)
+	void getOneRing(unsigned int const v, std::vector<unsigned int> &out_verts) const;
+	// faces around v (in order)
+	void getFaceRing(unsigned int const v, std::vector<unsigned int> &out_faces) const;
+
+	// outward normal of a face scaled by twice its area
+	glm::dvec3 getFaceAreaNormal(unsigned int const f) const;
+
+	// would collapsing h keep the mesh manifold? (link condition + the mesh doesn't shrink below a tetrahedron)
+	bool isCollapseValid(unsigned int const h) const;
+
+	// collapses half-edge h (from -> to): 'from' and the 2 faces next to the edge are removed, 'to' moves to newPosition
+	//NOTE: caller must check isCollapseValid first
+	void collapse(unsigned int const h, glm::vec3 const& newPosition);
+
+private:
+	unsigned int m_vertexCount = 0;
+	unsigned int m_faceCount = 0;
+};
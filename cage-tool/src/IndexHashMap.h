@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+
+// open addressing (linear probing) hash map from a small tuple of integers (e.g. glm::ivec3 of obj v/vt/vn indices) to an index
+// used for deduplicating index tuples in linear time - there is no erase, and the table only grows
+//NOTE: Key must be tightly packed 32 bit integers (glm::ivec2/3/4, glm::uvec2/3/4, int, ...) and comparable with ==
+template <typename Key>
+class IndexHashMap {
+
+	static_assert(0 == sizeof(Key) % sizeof(uint32_t), "IndexHashMap keys have to be made of 32 bit integers");
+
+public:
+	static constexpr unsigned int s_NONE = 0xFFFFFFFF;
+
+	explicit IndexHashMap(size_t const expectedCount = 0) { reserve(expectedCount); }
+
+	// makes room for expectedCount keys without rehashing
+	void reserve(size_t const expectedCount) {
+		size_t capacity = 16;
+		while (capacity < 2 * expectedCount) capacity *= 2; // keep the load factor <= 0.5
+		if (capacity > m_values.size()) rehash(capacity);
+	}
+
+	size_t size() const { return m_count; }
+
+	// RETURNS the value stored for key, s_NONE if there is none
+	unsigned int find(Key const& key) const {
+		for (size_t slot = hash(key) & m_mask; ; slot = (slot + 1) & m_mask) {
+			if (s_NONE == m_values[slot]) return s_NONE;
+			if (m_keys[slot] == key) return m_values[slot];
+		}
+	}
+
+	// RETURNS the value already stored for key, otherwise stores (and returns) value
+	//NOTE: out_isNew tells which of the 2 happened
+	unsigned int findOrInsert(Key const& key, unsigned int const value, bool &out_isNew) {
+		if (2 * (m_count + 1) > m_values.size()) rehash(2 * m_values.size());
+
+		size_t slot = hash(key) & m_mask;
+		for (; s_NONE != m_values[slot]; slot = (slot + 1) & m_mask) {
+			if (m_keys[slot] == key) {
+				out_isNew = false;
+				return m_values[slot];
+			}
+		}
+
+		m_keys[slot] = key;
+		m_values[slot] = value;
+		++m_count;
+		out_isNew = true;
+		return value;
+	}
+
+private:
+	std::vector<Key> m_keys;
+	std::vector<unsigned int> m_values; // s_NONE marks an empty slot
+	size_t m_mask = 0; // capacity - 1 (capacity is a power of 2)
+	size_t m_count = 0;
+
+	// every 32 bit word of the key gets mixed in, then a final avalanche (splitmix64) so that nearby tuples spread over the table
+	static size_t hash(Key const& key) {
+		uint32_t words[sizeof(Key) / sizeof(uint32_t)];
+		std::memcpy(words, &key, sizeof(Key));
+
+		uint64_t h = 0;
+		for (uint32_t const word : words) {
+			h = (h ^ word) * 0x9E3779B97F4A7C15ull;
+		}
+		h ^= h >> 30;
+		h *= 0xBF58476D1CE4E5B9ull;
+		h ^= h >> 27;
+		h *= 0x94D049BB133111EBull;
+		h ^= h >> 31;
+		return (size_t)h;
+	}
+
+	void rehash(size_t const capacity) {
+		std::vector<Key> oldKeys;
+		std::vector<unsigned int> oldValues;
+		oldKeys.swap(m_keys);
+		oldValues.swap(m_values);
+
+		m_keys.resize(capacity);
+		m_values.assign(capacity, s_NONE);
+		m_mask = capacity - 1;
+
+		for (size_t i = 0; i < oldValues.size(); ++i) {
+			if (s_NONE == oldValues[i]) continue;
+
+			size_t slot = hash(oldKeys[i]) & m_mask;
+			while (s_NONE != m_values[slot]) slot = (slot + 1) & m_mask;
+			m_keys[slot] = oldKeys[i];
+			m_values[slot] = oldValues[i];
+		}
+	}
+};
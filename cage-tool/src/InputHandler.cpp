@@ -34,6 +34,10 @@ void InputHandler::key(GLFWwindow *window, int key, int scancode, int action, in
 		} else if (GLFW_KEY_Q == key) {
 			program->translateSelectedCageVerts(glm::vec3(0.0f, 0.0f, -delta));
 		} else if (GLFW_KEY_ESCAPE == key) glfwSetWindowShouldClose(window, GL_TRUE);
+	} else if (GLFW_RELEASE == action) {
+		if (GLFW_KEY_W == key || GLFW_KEY_S == key || GLFW_KEY_D == key || GLFW_KEY_A == key || GLFW_KEY_E == key || GLFW_KEY_Q == key) {
+			program->finishCageTranslation();
+		}
 	}
 }
 
@@ -43,55 +47,29 @@ void InputHandler::mouse(GLFWwindow *window, int button, int action, int mods) {
 	Program *program = (Program*)glfwGetWindowUserPointer(window);
 
 	if (GLFW_MOUSE_BUTTON_RIGHT == button && GLFW_PRESS == action && nullptr != program->m_cage) {
+		double xpos, ypos;
+		glfwGetCursorPos(window, &xpos, &ypos);
 
-		// COLOUR PICKING (back buffer querying)...
-		// reference: http://www.opengl-tutorial.org/miscellaneous/clicking-on-objects/picking-with-an-opengl-hack/
-		// reference: https://github.com/opengl-tutorials/ogl/blob/master/misc05_picking/misc05_picking_slow_easy.cpp
-
-		// save...
-		PolygonMode const prevCagePolygonMode = program->m_cage->m_polygonMode; // should be LINE
-		ColourMode const prevCageColourMode = program->m_cage->m_colourMode; // should be NORMAL
-		
-		// update...
-		program->m_cage->m_polygonMode = PolygonMode::POINT; // must render cage as points for picking
-		// update cage colour buffer to use pickingColours
-		program->m_cage->m_colourMode = ColourMode::PICKING;
-		renderEngine->updateBuffers(*(program->m_cage), false, false, false, true);
-
-		// render...
-		if (nullptr != program->m_model) renderEngine->renderPicking({program->m_model, program->m_cage}); // render the model as well, to act as an occluder
-		else renderEngine->renderPicking({program->m_cage});
-		
-		// reset...
-		program->m_cage->m_polygonMode = prevCagePolygonMode;
-		program->m_cage->m_colourMode = prevCageColourMode;
-		// update cage colour buffer to use original colours (should be the normal colours vector)
-		renderEngine->updateBuffers(*(program->m_cage), false, false, false, true);
-
+		// dragging makes it a box (or a lasso with SHIFT) selection, see release below
+		program->beginCageRegionSelection(glm::vec2((float)xpos, (float)ypos), 0 != (mods & GLFW_MOD_SHIFT));
+	}
 
-		// PROCESS DATA...
+	if (GLFW_MOUSE_BUTTON_RIGHT == button && GLFW_RELEASE == action && nullptr != program->m_cage) {
 		double xpos, ypos;
 		glfwGetCursorPos(window, &xpos, &ypos);
 
 		int width, height;
 		glfwGetWindowSize(window, &width, &height);
 
-		ypos = (height - 1) - ypos; // flip the y-coord (readpixels expects the +y axis to point upwards, rather than downwards like window)
+		// BOX/LASSO SELECTION (CTRL unselects)...
+		bool const wasDragged = program->endCageRegionSelection(glm::ivec2(width, height), 0 != (mods & GLFW_MOD_CONTROL));
 
-		glFlush();
-		glFinish();
-
-		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-
-		unsigned char rgba[4] = {0, 0, 0, 0};
-		glReadPixels(xpos, ypos, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, rgba);
-
-		unsigned int const pickedID = rgba[0] + (rgba[1] << 8) + (rgba[2] << 16);
-
-
-		// only handle picked colours belonging to cage vert picking range...
-		if (pickedID < program->m_cage->pickingColours.size()) {
-			program->toggleCageVerts(pickedID, 1);
+		// ...otherwise it was a click, CPU PICKING (see CagePicker)
+		if (!wasDragged) {
+			unsigned int const pickedVert = program->pickCageVert(glm::vec2((float)xpos, (float)ypos), glm::ivec2(width, height));
+			if (CagePicker::s_NONE != pickedVert) {
+				program->toggleCageVerts(pickedVert, 1);
+			}
 		}
 
 		//TODO: modify above method for key-control to no longer move light source, but instead move all selected verts in 6 axes (+ve and -ve)
@@ -122,6 +100,11 @@ void InputHandler::motion(GLFWwindow *window, double x, double y) {
 		camera->updateLatitudeRotation(dy * 0.5);
 	}
 
+	if (glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_RIGHT)) {
+		Program *program = (Program*)glfwGetWindowUserPointer(window);
+		program->updateCageRegionSelection(glm::vec2((float)x, (float)y));
+	}
+
 	mouseOldX = x;
 	mouseOldY = y;
 }
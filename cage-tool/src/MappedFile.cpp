@@ -0,0 +1,98 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+#ifdef _WIN32
+
+bool MappedFile::open(std::string const& filePath) {
+	close();
+
+	HANDLE const file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (INVALID_HANDLE_VALUE == file) return false;
+	m_file = file;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size)) {
+		close();
+		return false;
+	}
+	m_size = (size_t)size.QuadPart;
+	m_isOpen = true;
+	if (0 == m_size) return true; // empty files can't be mapped
+
+	//NOTE: both handles stay open until close() (the view needs the mapping)
+	m_mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (nullptr == m_mapping) {
+		close();
+		return false;
+	}
+	m_data = (char const*)MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+	if (nullptr == m_data) {
+		close();
+		return false;
+	}
+	return true;
+}
+
+
+void MappedFile::close() {
+	if (nullptr != m_data) UnmapViewOfFile(m_data);
+	if (nullptr != m_mapping) CloseHandle(m_mapping);
+	if (nullptr != m_file) CloseHandle(m_file);
+
+	m_isOpen = false;
+	m_data = nullptr;
+	m_size = 0;
+	m_mapping = nullptr;
+	m_file = nullptr;
+}
+
+#else
+
+bool MappedFile::open(std::string const& filePath) {
+	close();
+
+	m_file = ::open(filePath.c_str(), O_RDONLY);
+	if (-1 == m_file) return false;
+
+	struct stat status;
+	if (0 != fstat(m_file, &status) || !S_ISREG(status.st_mode)) {
+		close();
+		return false;
+	}
+	m_size = (size_t)status.st_size;
+	m_isOpen = true;
+	if (0 == m_size) return true; // empty files can't be mapped
+
+	void *data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_file, 0);
+	if (MAP_FAILED == data) {
+		close();
+		return false;
+	}
+	madvise(data, m_size, MADV_SEQUENTIAL);
+	m_data = (char const*)data;
+	return true;
+}
+
+
+void MappedFile::close() {
+	if (nullptr != m_data) munmap((void*)m_data, m_size);
+	if (-1 != m_file) ::close(m_file);
+
+	m_isOpen = false;
+	m_data = nullptr;
+	m_size = 0;
+	m_file = -1;
+}
+
+#endif
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+
+// read-only memory mapped file - the OS pages the contents in on demand, so parsers can scan it in place (no copies, no per-line strings)
+//NOTE: the contents are NOT null terminated, always use getSize()
+//NOTE: non-copyable, the mapping is released in close() or on destruction
+class MappedFile {
+
+public:
+	MappedFile() = default;
+	~MappedFile() { close(); }
+
+	MappedFile(MappedFile const&) = delete;
+	MappedFile& operator=(MappedFile const&) = delete;
+
+	// RETURNS false if the file could not be opened or mapped
+	//NOTE: an empty file opens fine (getData() is then nullptr)
+	bool open(std::string const& filePath);
+	void close();
+
+	bool isOpen() const { return m_isOpen; }
+	char const* getData() const { return m_data; }
+	size_t getSize() const { return m_size; }
+
+private:
+	bool m_isOpen = false;
+	char const* m_data = nullptr;
+	size_t m_size = 0;
+
+#ifdef _WIN32
+	void *m_file = nullptr; // HANDLE
+	void *m_mapping = nullptr; // HANDLE
+#else
+	int m_file = -1;
+#endif
+};
@@ -0,0 +1,130 @@
+#include "MeanValueCoordinates.h"
+
+#include <glm/gtc/constants.hpp>
+
+#include <algorithm>
+
+
+bool MeanValueCoordinates::computeWeights(glm::vec3 const& x, std::vector<glm::vec3> const& cageVerts, std::vector<unsigned int> const& cageFaces, std::vector<float> &out_weights) {
+
+	// init the cage vert weights vector for model vert i (x is the sphere origin)...
+	out_weights.assign(cageVerts.size(), 0.0f);
+
+	// foreach triangle face in cage mesh...
+	for (unsigned int f = 0; f < cageFaces.size(); f += 3) {
+
+		// save the 3 cage vert indices making up cage face f...
+		unsigned int const p1_index = cageFaces.at(f);
+		unsigned int const p2_index = cageFaces.at(f+1);
+		unsigned int const p3_index = cageFaces.at(f+2);
+
+		// get the 3 cage vert positions...
+		glm::vec3 const p1 = cageVerts.at(p1_index);
+		glm::vec3 const p2 = cageVerts.at(p2_index);
+		glm::vec3 const p3 = cageVerts.at(p3_index);
+
+		float const d1 = glm::length(p1 - x);
+		float const d2 = glm::length(p2 - x);
+		float const d3 = glm::length(p3 - x);
+
+		//TODO: ...
+		//TODO: ... (i'm thinking give it a weight of 1 and enter a special mode (if mode is false, then set true) - since this cage vert is basically located at model vert, it should get highest influence
+		// PREVENTS DIVIDE BY ZERO (since we would be trying to normalize the zero vector which is undefined)
+		if (d1 < glm::epsilon<float>()) {
+			//return? or continue? or something else?
+			return false;
+		}
+		if (d2 < glm::epsilon<float>()) {
+			//return? or continue? or something else?
+			return false;
+		}
+		if (d3 < glm::epsilon<float>()) {
+			//return? or continue? or something else?
+			return false;
+		}
+
+		glm::vec3 const u1 = (p1 - x) / d1; // p1 projected on unit sphere centered at x
+		glm::vec3 const u2 = (p2 - x) / d2; // p2 projected on unit sphere centered at x
+		glm::vec3 const u3 = (p3 - x) / d3; // p3 projected on unit sphere centered at x
+
+		// side-lengths of planar triangle t
+		//NOTE: I believe the length would vary from 0 to 2 (e.g. 2 points on opposite side of unit sphere = R+R = 1+1 = 2)
+		float const l1 = glm::length(u2 - u3);
+		float const l2 = glm::length(u3 - u1);
+		float const l3 = glm::length(u1 - u2);
+
+		// arc-lengths of spherical triangle t_sph (equivalent to angles since R=1)
+		//NOTE: I believe these angles/lengths will be between 0 and pi
+		float const theta1 = 2 * glm::asin(l1 / 2);
+		float const theta2 = 2 * glm::asin(l2 / 2);
+		float const theta3 = 2 * glm::asin(l3 / 2);
+
+		// safety (handle if a length happens to be very small (< 2*epsilon) (I guess the area would be 0 and thus influence by this face would be 0, thus just continue?))
+		// PREVENTS DIVIDE BY ZERO (since asin(0/2) = 0, thus theta = 0, which then cause a sin(0) in denominator for a c_i calculation
+		if (theta1 < glm::epsilon<float>() || theta2 < glm::epsilon<float>() || theta3 < glm::epsilon<float>()) continue;
+
+		// half-angle (Beyer)
+		//NOTE: assume a scenario where u1,u2,u3 form a planar triangle that cuts through the center (x) of the unit sphere (and recall that they are all on the surface of the sphere at R=1).
+		//NOTE: now assume we have a configuration like
+		// u1-R-x-R-u3
+		//   \  |  /
+		//    \ R /
+		//     \|/
+		//     u2
+		// the planar triangle lengths would be l1 = l3 = sqrt(2*R^2) = sqrt(2) and l2 = 2*R = 2
+		// thus, we would get theta1 + theta2 + theta3 = 2 * [asin(sqrt(2) / 2) + asin(1) + asin(sqrt(2) / 2)] = 2 * [pi/4 + pi/2 + pi/4] = 2 * [pi]
+		//NOTE: thus, I think h will be in range [1.5 * epsilon, pi]
+		float const h = (theta1 + theta2 + theta3) / 2;
+		if (glm::pi<float>() - h < glm::epsilon<float>()) {
+			// center of sphere point x lies on triangle t (use 2D barycentric coords)
+
+			std::fill(out_weights.begin(), out_weights.end(), 0.0f); // reset weights vector back to all zeros
+
+			//NOTE: only this face will have an influence on model vert_i (x)
+			out_weights.at(p1_index) = glm::sin(theta1) * d3 * d2;
+			out_weights.at(p2_index) = glm::sin(theta2) * d1 * d3;
+			out_weights.at(p3_index) = glm::sin(theta3) * d2 * d1;
+			break; // no need to check any other faces
+		}
+
+		//NOTE: I was having a bug where some faces were missing due to one of these cosines (c1,c2,c3) being something like 1.000024 which squared is > 1 and thus causes a sqrt(<0) at one of s1,s2,s3 resulting in a -nan
+		//FIX: clamp the cosines between the mathmetical range of -1 to 1
+		//NOTE: I'm not sure if clamping is the right thing to do, or if it should be an error or something, but I think its just float imprecision causing it and the program seems to work...
+		
+		// cosines of the spherical triangle angles (diheral angles)
+		float const c1 = glm::clamp((2 * glm::sin(h)*glm::sin(h - theta1)) / (glm::sin(theta2)*glm::sin(theta3)) - 1, -1.0f, 1.0f);
+		float const c2 = glm::clamp((2 * glm::sin(h)*glm::sin(h - theta2)) / (glm::sin(theta3)*glm::sin(theta1)) - 1, -1.0f, 1.0f);
+		float const c3 = glm::clamp((2 * glm::sin(h)*glm::sin(h - theta3)) / (glm::sin(theta1)*glm::sin(theta2)) - 1, -1.0f, 1.0f);
+
+		//TODO: add any error checking or comments for below???
+		glm::mat3 const uMat = glm::mat3(u1, u2, u3);
+		float const det = glm::determinant(uMat);
+		
+		float const s1 = glm::sign(det) * glm::sqrt(1 - c1 * c1);
+		float const s2 = glm::sign(det) * glm::sqrt(1 - c2 * c2);
+		float const s3 = glm::sign(det) * glm::sqrt(1 - c3 * c3);
+
+		// if sphere origin (x) lies on same plane as triangle t, but lies outside triangle, then we ignore this face (since projection would be a curve of zero area and thus have 0 weight)
+		if (glm::abs(s1) <= glm::epsilon<float>() || glm::abs(s2) <= glm::epsilon<float>() || glm::abs(s3) <= glm::epsilon<float>()) continue; // continue to next face
+
+		// update the weights of each of the 3 cage verts making up this face affecting the model vert_i (x) by accumulation
+		out_weights.at(p1_index) += (theta1 - c2 * theta3 - c3 * theta2) / (d1 * glm::sin(theta2) * s3);
+		out_weights.at(p2_index) += (theta2 - c3 * theta1 - c1 * theta3) / (d2 * glm::sin(theta3) * s1);
+		out_weights.at(p3_index) += (theta3 - c1 * theta2 - c2 * theta1) / (d3 * glm::sin(theta1) * s2);
+	}
+
+	// 6. normalize the weights vector (sum of all elements = 1) for affine property
+
+	//TODO: since, we can have negative weights, isn't it possible that totalW could be 0?
+
+	float totalW = 0.0f;
+	for (unsigned int j = 0; j < out_weights.size(); ++j) {
+		totalW += out_weights.at(j);
+	}
+
+	for (unsigned int j = 0; j < out_weights.size(); ++j) {
+		out_weights.at(j) /= totalW;
+	}
+
+	return true;
+}
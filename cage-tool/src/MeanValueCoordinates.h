@@ -0,0 +1,17 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+
+
+// mean value coordinates of a point with respect to a closed triangle cage (1 weight per cage vert, summing up to 1)
+// reference: Ju, Schaefer, Warren - Mean Value Coordinates for Closed Triangular Meshes (2005)
+//NOTE: only reads the cage, so any number of threads can compute weights at the same time (each with its own out_weights)
+class MeanValueCoordinates {
+
+public:
+	// out_weights gets resized to cageVerts.size()
+	// RETURNS false if x lies on a cage vert (the weights are then incomplete)
+	//NOTE: cageFaces are 3 indices in a row into cageVerts
+	static bool computeWeights(glm::vec3 const& x, std::vector<glm::vec3> const& cageVerts, std::vector<unsigned int> const& cageFaces, std::vector<float> &out_weights);
+};
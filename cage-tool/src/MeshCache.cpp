@@ -0,0 +1,223 @@
+#include "MeshCache.h"
+
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include "MappedFile.h"
+
+
+static_assert(sizeof(glm::vec3) == 3 * sizeof(float) && sizeof(glm::vec2) == 2 * sizeof(float), "mesh cache arrays are expected to be tightly packed floats");
+
+
+namespace {
+	char const s_MAGIC[8] = { 'C', 'A', 'G', 'E', 'M', 'S', 'H', '\0' };
+
+	size_t alignUp(size_t const offset, size_t const alignment) {
+		return (offset + alignment - 1) / alignment * alignment;
+	}
+
+	// copies a section's array out of the mapping (1 bulk copy, no parsing)
+	template <typename T>
+	void copySection(char const* data, uint64_t const offset, uint64_t const count, std::vector<T> &out_array) {
+		out_array.resize((size_t)count);
+		if (0 != count) std::memcpy(out_array.data(), data + offset, (size_t)count * sizeof(T));
+	}
+}
+
+
+bool MeshCache::getSourceKey(std::string const& filePath, SourceKey &out_key) {
+	std::error_code error;
+	uintmax_t const size = std::filesystem::file_size(filePath, error);
+	if (error) return false;
+	std::filesystem::file_time_type const modifiedTime = std::filesystem::last_write_time(filePath, error);
+	if (error) return false;
+
+	out_key.m_size = (uint64_t)size;
+	out_key.m_modifiedTime = (int64_t)modifiedTime.time_since_epoch().count();
+	return true;
+}
+
+
+// 8 bytes at a time, multiply-xorshift mixing (only has to tell different versions of the same obj apart, not be cryptographic)
+bool MeshCache::hashFile(std::string const& filePath, uint64_t &out_hash) {
+	MappedFile file;
+	if (!file.open(filePath)) return false;
+
+	uint64_t hash = 0x9E3779B97F4A7C15ull ^ (uint64_t)file.getSize();
+	auto mix = [&hash](uint64_t const word) {
+		hash = (hash ^ word) * 0xBF58476D1CE4E5B9ull;
+		hash ^= hash >> 29;
+	};
+
+	char const* data = file.getData();
+	size_t const wordCount = file.getSize() / sizeof(uint64_t);
+	for (size_t w = 0; w < wordCount; ++w) {
+		uint64_t word;
+		std::memcpy(&word, data + w * sizeof(uint64_t), sizeof(word));
+		mix(word);
+	}
+	uint64_t tail = 0;
+	std::memcpy(&tail, data + wordCount * sizeof(uint64_t), file.getSize() - wordCount * sizeof(uint64_t));
+	mix(tail);
+
+	out_hash = hash;
+	return true;
+}
+
+
+std::shared_ptr<MeshObject> MeshCache::load(std::string const& filePath, bool const ignoreUVs, bool const ignoreNormals) {
+	SourceKey sourceKey;
+	if (!getSourceKey(filePath, sourceKey)) return nullptr;
+
+	MappedFile cache;
+	if (!cache.open(getCachePath(filePath))) return nullptr;
+
+	// 1. header...
+	if (cache.getSize() < sizeof(Header)) return nullptr;
+	Header header;
+	std::memcpy(&header, cache.getData(), sizeof(Header));
+	if (0 != std::memcmp(header.m_magic, s_MAGIC, sizeof(s_MAGIC)) || s_VERSION != header.m_version) return nullptr;
+	if (getOptions(ignoreUVs, ignoreNormals) != header.m_options) return nullptr;
+
+	// 2. is it still up to date? (hashing the source is only needed if it was touched without changing its size)
+	if (sourceKey.m_size != header.m_sourceSize) return nullptr;
+	bool const isModifiedTimeStale = sourceKey.m_modifiedTime != header.m_sourceModifiedTime;
+	if (isModifiedTimeStale) {
+		uint64_t sourceHash = 0;
+		if (!hashFile(filePath, sourceHash) || sourceHash != header.m_sourceHash) return nullptr;
+	}
+
+	// 3. sections (every one is bounds checked, so a truncated/corrupt cache just counts as a miss)...
+	if ((cache.getSize() - sizeof(Header)) / sizeof(Section) < header.m_sectionCount) return nullptr;
+	std::vector<Section> sections(header.m_sectionCount);
+	if (0 != header.m_sectionCount) std::memcpy(sections.data(), cache.getData() + sizeof(Header), sections.size() * sizeof(Section));
+
+	std::shared_ptr<MeshObject> triMesh = std::make_shared<MeshObject>();
+	bool hasVerts = false;
+	bool hasFaces = false;
+	for (Section const& section : sections) {
+		if (section.m_offset > cache.getSize() || 0 == section.m_elementSize) return nullptr;
+		if ((cache.getSize() - section.m_offset) / section.m_elementSize < section.m_count) return nullptr;
+
+		char const* data = cache.getData();
+		if (SECTION_DRAW_VERTS == section.m_type && sizeof(glm::vec3) == section.m_elementSize) {
+			copySection(data, section.m_offset, section.m_count, triMesh->drawVerts);
+			hasVerts = true;
+		} else if (SECTION_UVS == section.m_type && sizeof(glm::vec2) == section.m_elementSize) {
+			copySection(data, section.m_offset, section.m_count, triMesh->uvs);
+		} else if (SECTION_NORMALS == section.m_type && sizeof(glm::vec3) == section.m_elementSize) {
+			copySection(data, section.m_offset, section.m_count, triMesh->normals);
+		} else if (SECTION_DRAW_FACES == section.m_type && sizeof(GLuint) == section.m_elementSize) {
+			copySection(data, section.m_offset, section.m_count, triMesh->drawFaces);
+			hasFaces = true;
+		}
+	}
+	if (!hasVerts || !hasFaces || triMesh->drawVerts.empty() || triMesh->drawFaces.empty()) return nullptr;
+
+	// 4. same sanity as a freshly parsed obj...
+	size_t const vertCount = triMesh->drawVerts.size();
+	if ((!triMesh->uvs.empty() && vertCount != triMesh->uvs.size()) || (!triMesh->normals.empty() && vertCount != triMesh->normals.size())) return nullptr;
+	if (0 != triMesh->drawFaces.size() % 3) return nullptr;
+	for (GLuint const index : triMesh->drawFaces) {
+		if (index >= vertCount) return nullptr;
+	}
+
+	// init vert colours (uniform light grey for now)
+	triMesh->colours.assign(vertCount, glm::vec3(0.8f, 0.8f, 0.8f));
+
+	if (triMesh->uvs.size() > 0) triMesh->hasTexture = true;
+
+	// 5. the source was only touched (same content), so the cache gets its new modification time (a failure just means hashing again next time)
+	if (isModifiedTimeStale) {
+		cache.close(); // (a mapped file can't be written on every platform)
+		updateSourceModifiedTime(filePath, sourceKey.m_modifiedTime);
+	}
+
+	return triMesh;
+}
+
+
+bool MeshCache::updateSourceModifiedTime(std::string const& filePath, int64_t const modifiedTime) {
+	std::fstream stream(getCachePath(filePath), std::ios::binary | std::ios::in | std::ios::out);
+	if (!stream) return false;
+
+	stream.seekp(offsetof(Header, m_sourceModifiedTime));
+	stream.write((char const*)&modifiedTime, sizeof(modifiedTime));
+	return (bool)stream;
+}
+
+
+bool MeshCache::write(std::string const& filePath, bool const ignoreUVs, bool const ignoreNormals, MeshObject const& mesh) {
+	static_assert(sizeof(Header) == 48 && sizeof(Section) == 24, "mesh cache header/section layout changed (bump s_VERSION)");
+
+	SourceKey sourceKey;
+	uint64_t sourceHash = 0;
+	if (!getSourceKey(filePath, sourceKey) || !hashFile(filePath, sourceHash)) return false;
+
+	// 1. layout...
+	struct Array {
+		SectionType m_type;
+		uint32_t m_elementSize;
+		uint64_t m_count;
+		void const* m_data;
+	};
+	Array const arrays[] = {
+		{ SECTION_DRAW_VERTS, sizeof(glm::vec3), mesh.drawVerts.size(), mesh.drawVerts.data() },
+		{ SECTION_UVS, sizeof(glm::vec2), mesh.uvs.size(), mesh.uvs.data() },
+		{ SECTION_NORMALS, sizeof(glm::vec3), mesh.normals.size(), mesh.normals.data() },
+		{ SECTION_DRAW_FACES, sizeof(GLuint), mesh.drawFaces.size(), mesh.drawFaces.data() },
+	};
+	size_t const sectionCount = sizeof(arrays) / sizeof(arrays[0]);
+
+	Header header;
+	std::memcpy(header.m_magic, s_MAGIC, sizeof(s_MAGIC));
+	header.m_version = s_VERSION;
+	header.m_options = getOptions(ignoreUVs, ignoreNormals);
+	header.m_sourceSize = sourceKey.m_size;
+	header.m_sourceModifiedTime = sourceKey.m_modifiedTime;
+	header.m_sourceHash = sourceHash;
+	header.m_sectionCount = (uint32_t)sectionCount;
+	header.m_padding = 0;
+
+	std::vector<Section> sections(sectionCount);
+	size_t offset = sizeof(Header) + sectionCount * sizeof(Section);
+	for (size_t s = 0; s < sectionCount; ++s) {
+		offset = alignUp(offset, s_ALIGNMENT);
+		sections[s].m_type = arrays[s].m_type;
+		sections[s].m_elementSize = arrays[s].m_elementSize;
+		sections[s].m_offset = offset;
+		sections[s].m_count = arrays[s].m_count;
+		offset += (size_t)(arrays[s].m_count * arrays[s].m_elementSize);
+	}
+
+	// 2. write to a temporary file, which then replaces the old cache (so a crash mid-write can't leave a half written cache behind)...
+	std::string const cachePath = getCachePath(filePath);
+	std::string const tempPath = cachePath + ".tmp";
+	{
+		std::ofstream stream(tempPath, std::ios::binary | std::ios::trunc);
+		if (!stream) return false;
+
+		stream.write((char const*)&header, sizeof(Header));
+		stream.write((char const*)sections.data(), sections.size() * sizeof(Section));
+		size_t written = sizeof(Header) + sections.size() * sizeof(Section);
+		char const zeros[s_ALIGNMENT] = {};
+		for (size_t s = 0; s < sectionCount; ++s) {
+			stream.write(zeros, sections[s].m_offset - written);
+			size_t const byteCount = (size_t)(arrays[s].m_count * arrays[s].m_elementSize);
+			if (0 != byteCount) stream.write((char const*)arrays[s].m_data, byteCount);
+			written = (size_t)sections[s].m_offset + byteCount;
+		}
+		if (!stream) return false;
+	}
+
+	std::error_code error;
+	std::filesystem::rename(tempPath, cachePath, error);
+	if (error) {
+		std::filesystem::remove(tempPath, error);
+		return false;
+	}
+	return true;
+}
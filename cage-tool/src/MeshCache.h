@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "MeshObject.h"
+
+
+// binary cache of the tri meshes built from obj files, stored next to the obj as <obj path>.meshcache
+// layout: header, section table, then 1 array per section (each 16 byte aligned) - the arrays are exactly MeshObject's drawVerts/uvs/normals/drawFaces
+// a cache is only used if it was built with the same load options from the same source, i.e. same size and modification time, or (if only the modification time changed) same content hash
+//NOTE: the sections are tagged, so more of them (e.g. a weld map or adjacency) can be added without breaking old caches - unknown sections are skipped
+//NOTE: native (little-endian) byte order, the cache is not meant to be moved between machines
+class MeshCache {
+
+public:
+	// RETURNS nullptr if there is no (up to date) cache for filePath
+	static std::shared_ptr<MeshObject> load(std::string const& filePath, bool const ignoreUVs, bool const ignoreNormals);
+
+	// RETURNS false if the cache could not be written (e.g. read-only folder), which is harmless - the obj just gets parsed again next time
+	static bool write(std::string const& filePath, bool const ignoreUVs, bool const ignoreNormals, MeshObject const& mesh);
+
+	static std::string getCachePath(std::string const& filePath) { return filePath + ".meshcache"; }
+
+private:
+	enum SectionType {
+		SECTION_DRAW_VERTS = 0,
+		SECTION_UVS = 1,
+		SECTION_NORMALS = 2,
+		SECTION_DRAW_FACES = 3,
+	};
+
+	struct Section {
+		uint32_t m_type;
+		uint32_t m_elementSize; // bytes
+		uint64_t m_offset; // bytes from the start of the file
+		uint64_t m_count; // elements
+	};
+
+	struct Header {
+		char m_magic[8];
+		uint32_t m_version;
+		uint32_t m_options; // bit 0: ignoreUVs, bit 1: ignoreNormals
+		uint64_t m_sourceSize;
+		int64_t m_sourceModifiedTime;
+		uint64_t m_sourceHash;
+		uint32_t m_sectionCount;
+		uint32_t m_padding;
+	};
+
+	static uint32_t const s_VERSION = 1;
+	static size_t const s_ALIGNMENT = 16;
+
+	// identifies the source obj
+	struct SourceKey {
+		uint64_t m_size = 0;
+		int64_t m_modifiedTime = 0;
+	};
+	static bool getSourceKey(std::string const& filePath, SourceKey &out_key);
+	static bool hashFile(std::string const& filePath, uint64_t &out_hash);
+	// patches the header of an existing cache in place (so the next load skips hashing the source again)
+	static bool updateSourceModifiedTime(std::string const& filePath, int64_t const modifiedTime);
+
+	static uint32_t getOptions(bool const ignoreUVs, bool const ignoreNormals) { return (ignoreUVs ? 1u : 0u) | (ignoreNormals ? 2u : 0u); }
+};
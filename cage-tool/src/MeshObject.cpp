@@ -11,6 +11,9 @@ MeshObject::MeshObject() :
 }
 
 MeshObject::~MeshObject() {
+	// never uploaded (e.g. a mesh dropped on a loading thread, which has no GL context to call into)
+	if (0 == vao && 0 == textureID) return;
+
 	// Remove data from GPU
 	glDeleteBuffers(1, &vertexBuffer);
 	glDeleteBuffers(1, &uvBuffer);
@@ -29,12 +29,6 @@ enum PolygonMode {
 };
 
 
-enum ColourMode {
-	NORMAL,
-	PICKING,
-};
-
-
 // Loads and stores (potentially textured) 3D meshes from .obj files. 
 class MeshObject {
 
@@ -50,11 +44,7 @@ public:
 	std::vector<glm::vec3> normals;
 	std::vector<glm::vec2> uvs;
 
-	//NOTE: either pickingColours is empty (symbolizes a uniform picking colour of white) or both colour vectors are same size
-	//NOTE: the colour buffer will have its data swapped between these 2 vectors when the user is picking
 	std::vector<glm::vec3> colours;
-	std::vector<glm::vec3> pickingColours;
-	ColourMode m_colourMode = ColourMode::NORMAL; // represents which vector is currently bound in the colour buffer (will probably only be swapped for the cage)
 
 	//std::vector<GLuint> faces;
 	
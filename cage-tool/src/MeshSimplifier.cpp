@@ -0,0 +1,289 @@
+#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "ParallelTools.h"
+
+
+MeshSimplifier::Quadric MeshSimplifier::Quadric::fromPlane(glm::dvec3 const& n, double const d, double const weight) {
+	Quadric q;
+	q.m[0] = weight * n.x * n.x; q.m[1] = weight * n.x * n.y; q.m[2] = weight * n.x * n.z; q.m[3] = weight * n.x * d;
+	q.m[4] = weight * n.y * n.y; q.m[5] = weight * n.y * n.z; q.m[6] = weight * n.y * d;
+	q.m[7] = weight * n.z * n.z; q.m[8] = weight * n.z * d;
+	q.m[9] = weight * d * d;
+	return q;
+}
+
+
+
+MeshSimplifier::Quadric& MeshSimplifier::Quadric::operator+=(Quadric const& q) {
+	for (unsigned int i = 0; i < 10; ++i) m[i] += q.m[i];
+	return *this;
+}
+
+
+
+double MeshSimplifier::Quadric::evaluate(glm::dvec3 const& p) const {
+	//NOTE: p^T A p + 2 b.p + c
+	return m[0] * p.x * p.x + 2.0 * m[1] * p.x * p.y + 2.0 * m[2] * p.x * p.z + 2.0 * m[3] * p.x
+		+ m[4] * p.y * p.y + 2.0 * m[5] * p.y * p.z + 2.0 * m[6] * p.y
+		+ m[7] * p.z * p.z + 2.0 * m[8] * p.z
+		+ m[9];
+}
+
+
+
+bool MeshSimplifier::Quadric::minimize(glm::dvec3 &out_p) const {
+	// solve A p = -b
+	glm::dmat3 const A(m[0], m[1], m[2], m[1], m[4], m[5], m[2], m[5], m[7]);
+	double const det = glm::determinant(A);
+	double const scale = (m[0] + m[4] + m[7]) / 3.0;
+	if (glm::abs(det) <= 1e-10 * scale * scale * scale) return false;
+
+	out_p = glm::inverse(A) * glm::dvec3(-m[3], -m[6], -m[8]);
+	return true;
+}
+
+
+
+unsigned int MeshSimplifier::simplify(HalfEdgeMesh &mesh, SimplifyOptions const& options) {
+	unsigned int const vertCount = (unsigned int)mesh.m_positions.size();
+	unsigned int const faceCount = (unsigned int)mesh.m_faceHalfEdges.size();
+	unsigned int const halfEdgeCount = (unsigned int)mesh.m_halfEdges.size();
+	if (0 == faceCount) return 0;
+
+	// tolerance for the enclosure test (relative to the size of the mesh)...
+	glm::vec3 minCorner(std::numeric_limits<float>::max());
+	glm::vec3 maxCorner(std::numeric_limits<float>::lowest());
+	for (unsigned int v = 0; v < vertCount; ++v) {
+		if (mesh.m_isVertexRemoved.at(v)) continue;
+		minCorner = glm::min(minCorner, mesh.m_positions.at(v));
+		maxCorner = glm::max(maxCorner, mesh.m_positions.at(v));
+	}
+	double const tolerance = 1e-6 * glm::length(glm::dvec3(maxCorner - minCorner));
+
+	// 1. face quadrics, then vert quadrics (a vert only reads its own faces, so both loops are race free)...
+	std::vector<Quadric> faceQuadrics(faceCount);
+	ParallelTools::parallelFor(faceCount, [&](size_t const f) {
+		if (mesh.m_isFaceRemoved.at(f)) return;
+		glm::dvec3 const areaNormal = mesh.getFaceAreaNormal((unsigned int)f);
+		double const length = glm::length(areaNormal);
+		if (length <= 0.0) return;
+
+		glm::dvec3 const n = areaNormal / length;
+		glm::dvec3 const p0 = mesh.m_positions.at(mesh.from(mesh.m_faceHalfEdges.at(f)));
+		faceQuadrics.at(f) = Quadric::fromPlane(n, -glm::dot(n, p0), 0.5 * length);
+	});
+
+	std::vector<Quadric> vertexQuadrics(vertCount);
+	ParallelTools::parallelFor(vertCount, [&](size_t const v) {
+		if (mesh.m_isVertexRemoved.at(v)) return;
+		unsigned int const start = mesh.m_vertexHalfEdges.at(v);
+		unsigned int h = start;
+		do {
+			vertexQuadrics.at(v) += faceQuadrics.at(mesh.m_halfEdges.at(h).m_face);
+			h = mesh.nextOutgoing(h);
+		} while (h != start);
+	}, 256);
+
+	// stamps are unique per vert and change whenever a vert moves, so a heap entry is stale as soon as either of its stamps doesn't match anymore
+	std::vector<unsigned int> stamps(vertCount);
+	for (unsigned int v = 0; v < vertCount; ++v) stamps.at(v) = v;
+	unsigned int nextStamp = vertCount;
+
+	// 2. initial candidates (1 half-edge per edge)...
+	unsigned int const threadCount = ParallelTools::getThreadCount();
+	std::vector<std::vector<CollapseCandidate>> threadCandidates(threadCount);
+	ParallelTools::parallelForRange(halfEdgeCount, [&](size_t const begin, size_t const end, unsigned int const threadIndex) {
+		std::vector<unsigned int> scratchFaces;
+		std::vector<unsigned int> scratchRing;
+		for (size_t h = begin; h < end; ++h) {
+			if (mesh.m_isHalfEdgeRemoved.at(h) || mesh.m_halfEdges.at(h).m_twin < h) continue;
+
+			CollapseCandidate candidate;
+			if (!evaluateCollapse(mesh, vertexQuadrics, (unsigned int)h, options.m_keepEnclosing, tolerance, scratchFaces, scratchRing, candidate.m_cost, candidate.m_position)) continue;
+			candidate.m_halfEdge = (unsigned int)h;
+			candidate.m_fromStamp = stamps.at(mesh.from((unsigned int)h));
+			candidate.m_toStamp = stamps.at(mesh.m_halfEdges.at(h).m_vertex);
+			threadCandidates.at(threadIndex).push_back(candidate);
+		}
+	}, 256);
+
+	std::vector<CollapseCandidate> heap;
+	for (std::vector<CollapseCandidate> const& candidates : threadCandidates) heap.insert(heap.end(), candidates.begin(), candidates.end());
+	std::make_heap(heap.begin(), heap.end());
+
+	// 3. collapse the cheapest edge until the target is reached...
+	std::vector<unsigned int> scratchFaces;
+	std::vector<unsigned int> scratchRing;
+	unsigned int collapseCount = 0;
+	while (mesh.getVertexCount() > options.m_targetVertCount && !heap.empty()) {
+		std::pop_heap(heap.begin(), heap.end());
+		CollapseCandidate const candidate = heap.back();
+		heap.pop_back();
+
+		unsigned int const h = candidate.m_halfEdge;
+		if (mesh.m_isHalfEdgeRemoved.at(h)) continue;
+		unsigned int const a = mesh.from(h);
+		unsigned int const b = mesh.m_halfEdges.at(h).m_vertex;
+		if (stamps.at(a) != candidate.m_fromStamp || stamps.at(b) != candidate.m_toStamp) continue;
+
+		// the neighbourhood might still have changed through a nearby collapse (that didn't touch a or b), so re-check before collapsing
+		if (!mesh.isCollapseValid(h) || !isPositionLegal(mesh, h, candidate.m_position, options.m_keepEnclosing, tolerance, scratchFaces, scratchRing)) {
+			//NOTE: an unchanged position means nothing around the edge changed since it was evaluated, so it would just fail again
+			CollapseCandidate updated = candidate;
+			if (evaluateCollapse(mesh, vertexQuadrics, h, options.m_keepEnclosing, tolerance, scratchFaces, scratchRing, updated.m_cost, updated.m_position) && updated.m_position != candidate.m_position) {
+				heap.push_back(updated);
+				std::push_heap(heap.begin(), heap.end());
+			}
+			continue;
+		}
+
+		mesh.collapse(h, glm::vec3(candidate.m_position));
+		vertexQuadrics.at(b) += vertexQuadrics.at(a);
+		stamps.at(b) = nextStamp++;
+		++collapseCount;
+
+		// re-evaluate every edge around the moved vert...
+		unsigned int const start = mesh.m_vertexHalfEdges.at(b);
+		unsigned int e = start;
+		do {
+			CollapseCandidate updated;
+			if (evaluateCollapse(mesh, vertexQuadrics, e, options.m_keepEnclosing, tolerance, scratchFaces, scratchRing, updated.m_cost, updated.m_position)) {
+				updated.m_halfEdge = e;
+				updated.m_fromStamp = stamps.at(b);
+				updated.m_toStamp = stamps.at(mesh.m_halfEdges.at(e).m_vertex);
+				heap.push_back(updated);
+				std::push_heap(heap.begin(), heap.end());
+			}
+			e = mesh.nextOutgoing(e);
+		} while (e != start);
+	}
+
+	return collapseCount;
+}
+
+
+
+void MeshSimplifier::offsetAlongNormals(HalfEdgeMesh &mesh, float const distance) {
+	std::vector<glm::vec3> offsetPositions = mesh.m_positions;
+	ParallelTools::parallelFor(mesh.m_positions.size(), [&](size_t const v) {
+		if (mesh.m_isVertexRemoved.at(v)) return;
+
+		glm::dvec3 normal(0.0, 0.0, 0.0);
+		unsigned int const start = mesh.m_vertexHalfEdges.at(v);
+		unsigned int h = start;
+		do {
+			normal += mesh.getFaceAreaNormal(mesh.m_halfEdges.at(h).m_face);
+			h = mesh.nextOutgoing(h);
+		} while (h != start);
+
+		double const length = glm::length(normal);
+		if (length > 0.0) offsetPositions.at(v) += glm::vec3(normal * (distance / length));
+	}, 256);
+	mesh.m_positions = offsetPositions;
+}
+
+
+
+bool MeshSimplifier::evaluateCollapse(HalfEdgeMesh const& mesh, std::vector<Quadric> const& vertexQuadrics, unsigned int const h, bool const keepEnclosing, double const tolerance, std::vector<unsigned int> &scratchFaces, std::vector<unsigned int> &scratchRing, double &out_cost, glm::dvec3 &out_position) {
+	if (!mesh.isCollapseValid(h)) return false;
+
+	unsigned int const a = mesh.from(h);
+	unsigned int const b = mesh.m_halfEdges.at(h).m_vertex;
+	Quadric q = vertexQuadrics.at(a);
+	q += vertexQuadrics.at(b);
+
+	// candidate positions: the quadric minimum (if there is one), the edge midpoint and both end points
+	glm::dvec3 const pa = mesh.m_positions.at(a);
+	glm::dvec3 const pb = mesh.m_positions.at(b);
+	glm::dvec3 candidates[4] = { 0.5 * (pa + pb), 0.5 * (pa + pb), pa, pb };
+	unsigned int const firstCandidate = q.minimize(candidates[0]) ? 0 : 1;
+
+	bool isFound = false;
+	out_cost = std::numeric_limits<double>::max();
+	for (unsigned int c = firstCandidate; c < 4; ++c) {
+		glm::dvec3 p = candidates[c];
+		if (keepEnclosing) p = projectOutside(mesh, h, p, scratchFaces, scratchRing);
+		if (!isPositionLegal(mesh, h, p, keepEnclosing, tolerance, scratchFaces, scratchRing)) continue;
+
+		double const cost = q.evaluate(p);
+		if (cost < out_cost) {
+			out_cost = cost;
+			out_position = p;
+			isFound = true;
+		}
+	}
+	return isFound;
+}
+
+
+
+bool MeshSimplifier::isPositionLegal(HalfEdgeMesh const& mesh, unsigned int const h, glm::dvec3 const& p, bool const keepEnclosing, double const tolerance, std::vector<unsigned int> &scratchFaces, std::vector<unsigned int> &scratchRing) {
+	unsigned int const a = mesh.from(h);
+	unsigned int const b = mesh.m_halfEdges.at(h).m_vertex;
+	unsigned int const edgeFace0 = mesh.m_halfEdges.at(h).m_face;
+	unsigned int const edgeFace1 = mesh.m_halfEdges.at(mesh.m_halfEdges.at(h).m_twin).m_face;
+
+	mesh.getFaceRing(a, scratchFaces);
+	mesh.getFaceRing(b, scratchRing);
+	scratchFaces.insert(scratchFaces.end(), scratchRing.begin(), scratchRing.end());
+
+	for (unsigned int const f : scratchFaces) {
+		glm::dvec3 const oldNormal = mesh.getFaceAreaNormal(f);
+		double const oldLength = glm::length(oldNormal);
+
+		// the enclosure constraint holds for all faces around the edge (including the 2 that disappear)
+		if (keepEnclosing && oldLength > 0.0) {
+			glm::dvec3 const p0 = mesh.m_positions.at(mesh.from(mesh.m_faceHalfEdges.at(f)));
+			if (glm::dot(oldNormal, p - p0) / oldLength < -tolerance) return false;
+		}
+
+		if (f == edgeFace0 || f == edgeFace1) continue;
+
+		// the face with a or b moved to p must not flip or become degenerate...
+		glm::dvec3 corners[3];
+		unsigned int e = mesh.m_faceHalfEdges.at(f);
+		for (unsigned int c = 0; c < 3; ++c) {
+			unsigned int const v = mesh.from(e);
+			corners[c] = (v == a || v == b) ? p : glm::dvec3(mesh.m_positions.at(v));
+			e = mesh.m_halfEdges.at(e).m_next;
+		}
+		glm::dvec3 const newNormal = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+		double const newLength = glm::length(newNormal);
+		if (newLength <= 1e-12 * oldLength) return false;
+		if (glm::dot(oldNormal, newNormal) <= 0.0) return false;
+	}
+
+	return true;
+}
+
+
+
+glm::dvec3 MeshSimplifier::projectOutside(HalfEdgeMesh const& mesh, unsigned int const h, glm::dvec3 p, std::vector<unsigned int> &scratchFaces, std::vector<unsigned int> &scratchRing) {
+	mesh.getFaceRing(mesh.from(h), scratchFaces);
+	mesh.getFaceRing(mesh.m_halfEdges.at(h).m_vertex, scratchRing);
+	scratchFaces.insert(scratchFaces.end(), scratchRing.begin(), scratchRing.end());
+
+	//NOTE: the projections are exact for a single violated plane, with several they converge towards the intersection of the half-spaces
+	// reference: https://en.wikipedia.org/wiki/Projections_onto_convex_sets
+	for (unsigned int iteration = 0; iteration < 16; ++iteration) {
+		bool isOutside = true;
+		for (unsigned int const f : scratchFaces) {
+			glm::dvec3 const areaNormal = mesh.getFaceAreaNormal(f);
+			double const length = glm::length(areaNormal);
+			if (length <= 0.0) continue;
+
+			glm::dvec3 const n = areaNormal / length;
+			glm::dvec3 const p0 = mesh.m_positions.at(mesh.from(mesh.m_faceHalfEdges.at(f)));
+			double const distance = glm::dot(n, p - p0);
+			if (distance < 0.0) {
+				p -= distance * n;
+				isOutside = false;
+			}
+		}
+		if (isOutside) break;
+	}
+	return p;
+}
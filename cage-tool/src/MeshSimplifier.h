@@ -0,0 +1,63 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "HalfEdgeMesh.h"
+
+
+struct SimplifyOptions {
+	unsigned int m_targetVertCount = 200; // stop collapsing once the mesh has this many verts (or nothing can be collapsed anymore)
+	bool m_keepEnclosing = true; // only allow collapses that keep the simplified surface outside of the input surface (progressive hull)
+};
+
+
+// quadric error metric (QEM) mesh decimation through half-edge collapses
+// reference: Garland, Heckbert - Surface Simplification Using Quadric Error Metrics (1997)
+// reference: Sander, Gu, Gortler, Hoppe, Snyder - Silhouette Clipping (2000) - progressive hull constraints
+// 1. a quadric per face (its plane, weighted by area) and per vert (sum over its faces) - both in parallel
+// 2. every edge gets the position minimizing the sum of its 2 vert quadrics, edges go into a min-heap on that error
+// 3. the cheapest edge is collapsed, the heap entries of its edges are re-evaluated (stale entries are skipped through per-vert stamps)
+//NOTE: with m_keepEnclosing, the new vert has to lie on the outer side of every face plane around the edge, so every collapse only ever adds volume
+class MeshSimplifier {
+
+public:
+	// RETURNS the number of collapses performed
+	static unsigned int simplify(HalfEdgeMesh &mesh, SimplifyOptions const& options);
+
+	// moves every vert along its (area weighted) normal
+	static void offsetAlongNormals(HalfEdgeMesh &mesh, float const distance);
+
+private:
+	// symmetric 4x4 matrix, stored as its upper triangle (a2, ab, ac, ad, b2, bc, bd, c2, cd, d2)
+	struct Quadric {
+		double m[10] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+
+		static Quadric fromPlane(glm::dvec3 const& n, double const d, double const weight);
+		Quadric& operator+=(Quadric const& q);
+		double evaluate(glm::dvec3 const& p) const;
+		// RETURNS false if the quadric is (nearly) singular
+		bool minimize(glm::dvec3 &out_p) const;
+	};
+
+	struct CollapseCandidate {
+		double m_cost;
+		unsigned int m_halfEdge;
+		unsigned int m_fromStamp; // stamps of both verts at the time of evaluation (stale if either vert changed since)
+		unsigned int m_toStamp;
+		glm::dvec3 m_position; //NOTE: kept in double so that re-checking a popped candidate repeats exactly the test it passed
+
+		bool operator<(CollapseCandidate const& c) const {
+			return m_cost > c.m_cost; // min-heap
+		}
+	};
+
+	// best legal position (and its error) for collapsing h, RETURNS false if h can't be collapsed
+	static bool evaluateCollapse(HalfEdgeMesh const& mesh, std::vector<Quadric> const& vertexQuadrics, unsigned int const h, bool const keepEnclosing, double const tolerance, std::vector<unsigned int> &scratchFaces, std::vector<unsigned int> &scratchRing, double &out_cost, glm::dvec3 &out_position);
+
+	// does moving the 2 verts of h to p keep every remaining face around them facing the same way (and, if keepEnclosing, is p outside every face plane around them)?
+	static bool isPositionLegal(HalfEdgeMesh const& mesh, unsigned int const h, glm::dvec3 const& p, bool const keepEnclosing, double const tolerance, std::vector<unsigned int> &scratchFaces, std::vector<unsigned int> &scratchRing);
+
+	// pushes p out through the face planes around the 2 verts of h that it is behind (cyclic projection)
+	static glm::dvec3 projectOutside(HalfEdgeMesh const& mesh, unsigned int const h, glm::dvec3 p, std::vector<unsigned int> &scratchFaces, std::vector<unsigned int> &scratchRing);
+};
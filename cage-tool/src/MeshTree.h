@@ -0,0 +1,61 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+
+
+// leaf OBB of the cage generation tree, as an inclusive range of voxel indices in the obb space
+//NOTE: .x (in V1 axis), .y (in V2 axis), .z (in V3 axis) - the box spans the grid coordinates m_min to m_max + 1
+struct LeafBox {
+	glm::uvec3 m_min;
+	glm::uvec3 m_max;
+};
+
+
+// flat arena that the cage generation tree appends its leaves into (no per-subtree copies, so building a tree is linear in its output size)
+struct MeshTree {
+	std::vector<glm::uvec3> m_vertexCoords; // integer grid coordinates - .x (in V1 axis), .y (in V2 axis), .z (in V3 axis)
+	std::vector<unsigned int> m_faceIndices; // 3 indices in a row correspond to a triangle face (CCW winding) of 3 verts in m_vertexCoords
+
+	std::vector<LeafBox> m_leafBoxes; // every leaf OBB that was appended to this tree (used to weld the final cage)
+
+	static unsigned int const s_VERTS_PER_LEAF = 8;
+	static unsigned int const s_FACE_INDICES_PER_LEAF = 36;
+
+	void clear() {
+		m_vertexCoords.clear();
+		m_faceIndices.clear();
+		m_leafBoxes.clear();
+	}
+
+	void reserveLeaves(size_t const leafCount) {
+		m_vertexCoords.reserve(leafCount * s_VERTS_PER_LEAF);
+		m_faceIndices.reserve(leafCount * s_FACE_INDICES_PER_LEAF);
+		m_leafBoxes.reserve(leafCount);
+	}
+
+	// appends the 8 corners + 12 faces of a leaf box, its face indices get offset by the current vert count (nothing already in the arena is touched)
+	void appendLeafBox(LeafBox const& leafBox) {
+		unsigned int const offset = (unsigned int)m_vertexCoords.size();
+
+		//NOTE: must add 1 to max index to handle ceiling of bounding volume
+		//NOTE: corner c has bit 2 = max along V1, bit 1 = max along V2, bit 0 = max along V3
+		glm::uvec3 const ceiling = leafBox.m_max + glm::uvec3(1, 1, 1);
+		for (unsigned int c = 0; c < s_VERTS_PER_LEAF; ++c) {
+			m_vertexCoords.push_back(glm::uvec3((c & 4) ? ceiling.x : leafBox.m_min.x, (c & 2) ? ceiling.y : leafBox.m_min.y, (c & 1) ? ceiling.z : leafBox.m_min.z));
+		}
+
+		// 6 faces from corner 0 (000), then 6 faces from corner 7 (111)
+		static unsigned int const s_BOX_FACE_INDICES[s_FACE_INDICES_PER_LEAF] = {
+			0, 2, 6,  0, 6, 4,
+			0, 1, 3,  0, 3, 2,
+			0, 4, 5,  0, 5, 1,
+			7, 3, 1,  7, 1, 5,
+			7, 5, 4,  7, 4, 6,
+			7, 6, 2,  7, 2, 3,
+		};
+		for (unsigned int const index : s_BOX_FACE_INDICES) m_faceIndices.push_back(offset + index);
+
+		m_leafBoxes.push_back(leafBox);
+	}
+};
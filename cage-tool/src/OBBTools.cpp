@@ -0,0 +1,359 @@
+#include "OBBTools.h"
+
+#include <Eigen/Dense>
+#include <algorithm>
+#include <limits>
+
+#include "ParallelTools.h"
+
+// SSE is always present on x64 (and is the MSVC default on x86), otherwise we fall back to the scalar loop
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define OBB_TOOLS_USE_SSE
+#include <xmmintrin.h>
+#endif
+
+//NOTE: the SIMD projection loop reads the point array as a flat float array
+static_assert(sizeof(glm::vec3) == 3 * sizeof(float), "glm::vec3 is expected to be 3 tightly packed floats");
+
+
+OBB OBBTools::fitOBB(std::vector<glm::vec3> const& points, OBBFitOptions const& options) {
+	OBB obb;
+	if (points.empty()) return obb;
+
+	// low covariance of 2 values means more independent (less correlated)
+	// covariance(x,x) = variance(x)
+	// covariance matrix A generalizes the concept of variance in multiple dimensions
+	// we want to diagonalize the covariance matrix to make signals strong (big diagonal entries) and distortions weak (low (in this case 0) off-diagonal entries)
+	// A is REAL and SYMMETRIC ===> guaranteed to have 3 eigenvectors in the similarity transformation (change of basis matrix) when we diagonalize A.
+	// THE 3 EIGENVECTORS OF COVARIANCE MATRIX WILL MAKE UP ORIENTATION OF OBB
+	// large eigenvalues mean large variance, thus align OBB along eigenvector corresponding to largest eigenvalue
+
+	// 1. (optional) reduce the point set to its convex hull (typically a few thousand verts out of millions of points)...
+	//NOTE: the min/max projections along any axis are always attained by hull points, so the extents can always be computed on the hull verts
+	bool const needsHull = options.m_useConvexHull || options.m_useHullFaceSearch;
+	HullMesh hull;
+	if (needsHull) hull = ConvexHull::computeHull(points);
+	std::vector<glm::vec3> const& fitPoints = options.m_useConvexHull ? hull.m_vertices : points;
+	std::vector<glm::vec3> const& extentPoints = needsHull ? hull.m_vertices : points;
+
+	// 2. compute centroid mu and covariance matrix in one pass...
+	glm::dvec3 mu;
+	glm::dmat3 covarianceMatrix;
+	computeMeanAndCovariance(fitPoints, mu, covarianceMatrix);
+	//NOTE: this matrix should be REAL and SYMMETRIC
+
+	// 3. get sorted eigenvalues (ascending) + corresponding eigenvectors...
+
+	// convert matrix form (glm -> eigen) to work with eigensolver...
+	Eigen::Matrix3d covMatEigen;
+	for (unsigned int i = 0; i < 3; ++i) { // loop over columns
+		for (unsigned int j = 0; j < 3; ++j) { // loop over rows
+			covMatEigen(j, i) = covarianceMatrix[i][j]; //NOTE: eigen(row, col) vs glm(col, row)
+		}
+	}
+
+	// reference: https://stackoverflow.com/questions/50458712/c-find-eigenvalues-and-eigenvectors-of-matrix
+	Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> eigenSolver;
+	eigenSolver.compute(covMatEigen);
+	Eigen::Matrix3d eigenVectors = eigenSolver.eigenvectors(); //NOTE: eigenvectors come sorted corresponding to the (ascending) eigenvalues and are normalized. This returned matrix also corresponds to P in the diagonalization formula A = P*D*P^-1. Here A =:= covariance matrix
+
+	// convert eigenvector forms (eigen -> glm)...
+	glm::vec3 axes[3];
+	for (unsigned int a = 0; a < 3; ++a) {
+		axes[a] = glm::normalize(glm::vec3(eigenVectors(0, a), eigenVectors(1, a), eigenVectors(2, a)));
+	}
+
+	// 4. find the min/max coordinates of the projected points along each of the 3 mutually orthonormal eigenvectors that form our basis...
+	float minScalars[3];
+	float maxScalars[3];
+	computeExtents(extentPoints, axes, minScalars, maxScalars);
+
+	// 5. sort basis vectors (v3 >= v2 >= V1)...
+	std::vector<SortableAxis> sortedAxes = { SortableAxis(axes[0], minScalars[0], maxScalars[0]), SortableAxis(axes[1], minScalars[1], maxScalars[1]), SortableAxis(axes[2], minScalars[2], maxScalars[2]) };
+	std::sort(sortedAxes.begin(), sortedAxes.end());
+
+	for (unsigned int a = 0; a < 3; ++a) {
+		obb.m_axes[a] = sortedAxes.at(a).m_axis;
+		obb.m_min[a] = sortedAxes.at(a).m_min;
+		obb.m_max[a] = sortedAxes.at(a).m_max;
+	}
+	obb.m_mean = glm::vec3(mu);
+
+	// 6. (optional) swap in the hull face box if it is tighter...
+	if (options.m_useHullFaceSearch && !hull.m_faces.empty()) {
+		OBB hullFaceOBB = fitHullFaceOBB(hull);
+		if (hullFaceOBB.getVolume() < obb.getVolume()) {
+			hullFaceOBB.m_mean = obb.m_mean;
+			obb = hullFaceOBB;
+		}
+	}
+
+	return obb;
+}
+
+
+// reference: https://en.wikipedia.org/wiki/Algorithms_for_calculating_variance#Welford's_online_algorithm
+// reference: https://en.wikipedia.org/wiki/Algorithms_for_calculating_variance#Parallel_algorithm
+void OBBTools::computeMeanAndCovariance(std::vector<glm::vec3> const& points, glm::dvec3 &out_mean, glm::dmat3 &out_covariance) {
+	out_mean = glm::dvec3(0.0, 0.0, 0.0);
+	out_covariance = glm::dmat3(0.0);
+	if (points.empty()) return;
+
+	// per-thread running state (count, mean, sum of dev * (dev)^T)...
+	struct Moments {
+		double m_count = 0.0;
+		glm::dvec3 m_mean = glm::dvec3(0.0, 0.0, 0.0);
+		glm::dmat3 m_comoment = glm::dmat3(0.0);
+	};
+	std::vector<Moments> partials(ParallelTools::getThreadCount());
+
+	ParallelTools::parallelForRange(points.size(), [&points, &partials](size_t const begin, size_t const end, unsigned int const threadIndex) {
+		Moments m;
+		for (size_t i = begin; i < end; ++i) {
+			glm::dvec3 const p = glm::dvec3(points[i]);
+			m.m_count += 1.0;
+			glm::dvec3 const devOld = p - m.m_mean;
+			m.m_mean += devOld / m.m_count;
+			glm::dvec3 const devNew = p - m.m_mean;
+			m.m_comoment += glm::outerProduct(devNew, devOld);
+		}
+		partials[threadIndex] = m;
+	});
+
+	// merge the per-thread states...
+	Moments total;
+	for (Moments const& m : partials) {
+		if (0.0 == m.m_count) continue;
+		if (0.0 == total.m_count) {
+			total = m;
+			continue;
+		}
+		double const count = total.m_count + m.m_count;
+		glm::dvec3 const delta = m.m_mean - total.m_mean;
+		total.m_mean += delta * (m.m_count / count);
+		total.m_comoment += m.m_comoment + glm::outerProduct(delta, delta) * (total.m_count * m.m_count / count);
+		total.m_count = count;
+	}
+
+	out_mean = total.m_mean;
+	// symmetrize (the Welford update accumulates dev_new * (dev_old)^T, which is only symmetric up to rounding)
+	out_covariance = (total.m_comoment + glm::transpose(total.m_comoment)) * 0.5;
+}
+
+
+//NOTE: the axes are assumed to be normalized, so the projected scalar is just the dot product (no division by the squared length)
+void OBBTools::computeExtents(std::vector<glm::vec3> const& points, glm::vec3 const axes[3], float out_min[3], float out_max[3]) {
+	for (unsigned int a = 0; a < 3; ++a) {
+		out_min[a] = std::numeric_limits<float>::max();
+		out_max[a] = std::numeric_limits<float>::lowest();
+	}
+	if (points.empty()) return;
+
+	unsigned int const threadCount = ParallelTools::getThreadCount();
+	std::vector<float> partialMins(3 * threadCount, std::numeric_limits<float>::max());
+	std::vector<float> partialMaxs(3 * threadCount, std::numeric_limits<float>::lowest());
+
+	ParallelTools::parallelForRange(points.size(), [&](size_t const begin, size_t const end, unsigned int const threadIndex) {
+		float mins[3] = { std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
+		float maxs[3] = { std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() };
+
+		size_t i = begin;
+
+#ifdef OBB_TOOLS_USE_SSE
+		// 4 points (12 floats) per iteration, de-interleaved into xxxx, yyyy, zzzz lanes...
+		__m128 minLanes[3];
+		__m128 maxLanes[3];
+		__m128 axisX[3];
+		__m128 axisY[3];
+		__m128 axisZ[3];
+		for (unsigned int a = 0; a < 3; ++a) {
+			minLanes[a] = _mm_set1_ps(std::numeric_limits<float>::max());
+			maxLanes[a] = _mm_set1_ps(std::numeric_limits<float>::lowest());
+			axisX[a] = _mm_set1_ps(axes[a].x);
+			axisY[a] = _mm_set1_ps(axes[a].y);
+			axisZ[a] = _mm_set1_ps(axes[a].z);
+		}
+
+		float const* data = &points[0].x;
+		for (; i + 4 <= end; i += 4) {
+			float const* p = data + 3 * i;
+			__m128 const a = _mm_loadu_ps(p);     // x0 y0 z0 x1
+			__m128 const b = _mm_loadu_ps(p + 4); // y1 z1 x2 y2
+			__m128 const c = _mm_loadu_ps(p + 8); // z2 x3 y3 z3
+
+			__m128 const xs = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+			__m128 const ys = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+			__m128 const zs = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+
+			for (unsigned int ax = 0; ax < 3; ++ax) {
+				__m128 const proj = _mm_add_ps(_mm_add_ps(_mm_mul_ps(xs, axisX[ax]), _mm_mul_ps(ys, axisY[ax])), _mm_mul_ps(zs, axisZ[ax]));
+				minLanes[ax] = _mm_min_ps(minLanes[ax], proj);
+				maxLanes[ax] = _mm_max_ps(maxLanes[ax], proj);
+			}
+		}
+
+		for (unsigned int ax = 0; ax < 3; ++ax) {
+			float laneMins[4];
+			float laneMaxs[4];
+			_mm_storeu_ps(laneMins, minLanes[ax]);
+			_mm_storeu_ps(laneMaxs, maxLanes[ax]);
+			for (unsigned int l = 0; l < 4; ++l) {
+				mins[ax] = glm::min(mins[ax], laneMins[l]);
+				maxs[ax] = glm::max(maxs[ax], laneMaxs[l]);
+			}
+		}
+#endif
+
+		// scalar tail (or the whole range if SSE is unavailable)...
+		for (; i < end; ++i) {
+			glm::vec3 const& p = points[i];
+			for (unsigned int ax = 0; ax < 3; ++ax) {
+				float const projScalar = glm::dot(p, axes[ax]);
+				mins[ax] = glm::min(mins[ax], projScalar);
+				maxs[ax] = glm::max(maxs[ax], projScalar);
+			}
+		}
+
+		for (unsigned int ax = 0; ax < 3; ++ax) {
+			partialMins[3 * threadIndex + ax] = mins[ax];
+			partialMaxs[3 * threadIndex + ax] = maxs[ax];
+		}
+	});
+
+	for (unsigned int t = 0; t < threadCount; ++t) {
+		for (unsigned int a = 0; a < 3; ++a) {
+			out_min[a] = glm::min(out_min[a], partialMins[3 * t + a]);
+			out_max[a] = glm::max(out_max[a], partialMaxs[3 * t + a]);
+		}
+	}
+}
+
+
+OBB OBBTools::fitHullFaceOBB(HullMesh const& hull) {
+	OBB obb;
+	if (hull.m_faces.empty()) return obb;
+
+	std::vector<glm::vec3> const& verts = hull.m_vertices;
+
+	// per-thread best box (stored as its 3 axes, the extents get recomputed exactly at the end)...
+	struct Candidate {
+		float m_volume = std::numeric_limits<float>::max();
+		glm::vec3 m_axes[3];
+	};
+	std::vector<Candidate> partialBests(ParallelTools::getThreadCount());
+
+	ParallelTools::parallelForRange(hull.m_faces.size(), [&](size_t const begin, size_t const end, unsigned int const threadIndex) {
+		Candidate best;
+		std::vector<glm::vec2> projected(verts.size());
+		std::vector<glm::vec2> hull2D;
+		hull2D.reserve(verts.size() + 1);
+
+		for (size_t f = begin; f < end; ++f) {
+			glm::uvec3 const& face = hull.m_faces[f];
+			glm::vec3 const faceNormal = glm::cross(verts[face[1]] - verts[face[0]], verts[face[2]] - verts[face[0]]);
+			float const faceNormalLength = glm::length(faceNormal);
+			if (faceNormalLength <= 0.0f) continue;
+			glm::vec3 const n = faceNormal / faceNormalLength;
+
+			// 1. orthonormal basis (u, w) of the plane orthogonal to n...
+			glm::vec3 const helper = glm::abs(n.x) < 0.9f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+			glm::vec3 const u = glm::normalize(glm::cross(n, helper));
+			glm::vec3 const w = glm::cross(n, u);
+
+			// 2. project the hull verts...
+			float minN = std::numeric_limits<float>::max();
+			float maxN = std::numeric_limits<float>::lowest();
+			for (size_t i = 0; i < verts.size(); ++i) {
+				projected[i] = glm::vec2(glm::dot(verts[i], u), glm::dot(verts[i], w));
+				float const projN = glm::dot(verts[i], n);
+				minN = glm::min(minN, projN);
+				maxN = glm::max(maxN, projN);
+			}
+			float const extentN = maxN - minN;
+
+			// 3. 2D convex hull (Andrew's monotone chain, counter-clockwise, no collinear points)...
+			// reference: https://en.wikibooks.org/wiki/Algorithm_Implementation/Geometry/Convex_hull/Monotone_chain
+			std::sort(projected.begin(), projected.end(), [](glm::vec2 const& a, glm::vec2 const& b) { return a.x < b.x || (a.x == b.x && a.y < b.y); });
+			auto cross2D = [](glm::vec2 const& o, glm::vec2 const& a, glm::vec2 const& b) { return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x); };
+
+			hull2D.clear();
+			for (size_t i = 0; i < projected.size(); ++i) { // lower hull
+				while (hull2D.size() >= 2 && cross2D(hull2D[hull2D.size() - 2], hull2D.back(), projected[i]) <= 0.0f) hull2D.pop_back();
+				hull2D.push_back(projected[i]);
+			}
+			size_t const lowerSize = hull2D.size() + 1;
+			for (size_t i = projected.size() - 1; i-- > 0;) { // upper hull
+				while (hull2D.size() >= lowerSize && cross2D(hull2D[hull2D.size() - 2], hull2D.back(), projected[i]) <= 0.0f) hull2D.pop_back();
+				hull2D.push_back(projected[i]);
+			}
+			hull2D.pop_back(); // last point is the first one again
+
+			size_t const m = hull2D.size();
+			if (m < 3) continue;
+
+			// 4. rotating calipers - the min area rectangle has a side flush with one of the 2D hull edges...
+			//NOTE: for each edge the 3 other calipers (furthest along the edge, furthest from the edge, furthest back along the edge) only ever move forward, so this is linear in m
+			size_t right = 0;
+			size_t top = 0;
+			size_t left = 0;
+			for (size_t i = 0; i < m; ++i) {
+				glm::vec2 const& origin = hull2D[i];
+				glm::vec2 const edge = hull2D[(i + 1) % m] - origin;
+				float const edgeLength = glm::length(edge);
+				if (edgeLength <= 0.0f) continue;
+				glm::vec2 const e = edge / edgeLength;
+				glm::vec2 const o = glm::vec2(-e.y, e.x); // points into the (counter-clockwise) hull
+
+				if (0 == i) {
+					right = i;
+					top = i;
+					left = i;
+				}
+				right = glm::max(right, i);
+				size_t steps = 0;
+				while (steps++ < m && glm::dot(hull2D[(right + 1) % m] - hull2D[right % m], e) > 0.0f) ++right;
+				top = glm::max(top, right);
+				steps = 0;
+				while (steps++ < m && glm::dot(hull2D[(top + 1) % m] - hull2D[top % m], o) > 0.0f) ++top;
+				left = glm::max(left, top);
+				steps = 0;
+				while (steps++ < m && glm::dot(hull2D[(left + 1) % m] - hull2D[left % m], e) < 0.0f) ++left;
+
+				float const width = glm::dot(hull2D[right % m] - origin, e) - glm::dot(hull2D[left % m] - origin, e);
+				float const height = glm::dot(hull2D[top % m] - origin, o);
+				float const volume = width * height * extentN;
+
+				if (volume < best.m_volume) {
+					best.m_volume = volume;
+					best.m_axes[0] = n;
+					best.m_axes[1] = glm::normalize(e.x * u + e.y * w);
+					best.m_axes[2] = glm::normalize(o.x * u + o.y * w);
+				}
+			}
+		}
+
+		partialBests[threadIndex] = best;
+	}, 64);
+
+	Candidate best;
+	for (Candidate const& candidate : partialBests) {
+		if (candidate.m_volume < best.m_volume) best = candidate;
+	}
+	if (std::numeric_limits<float>::max() == best.m_volume) return obb;
+
+	// exact extents along the chosen axes + sort them (v3 >= v2 >= V1)...
+	float minScalars[3];
+	float maxScalars[3];
+	computeExtents(verts, best.m_axes, minScalars, maxScalars);
+
+	std::vector<SortableAxis> sortedAxes = { SortableAxis(best.m_axes[0], minScalars[0], maxScalars[0]), SortableAxis(best.m_axes[1], minScalars[1], maxScalars[1]), SortableAxis(best.m_axes[2], minScalars[2], maxScalars[2]) };
+	std::sort(sortedAxes.begin(), sortedAxes.end());
+
+	for (unsigned int a = 0; a < 3; ++a) {
+		obb.m_axes[a] = sortedAxes.at(a).m_axis;
+		obb.m_min[a] = sortedAxes.at(a).m_min;
+		obb.m_max[a] = sortedAxes.at(a).m_max;
+	}
+
+	return obb;
+}
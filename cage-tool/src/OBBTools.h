@@ -0,0 +1,74 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "ConvexHull.h"
+
+
+//NOTE: m_axis should be normalized
+//NOTE: m_max >= m_min is assumed
+struct SortableAxis {
+	glm::vec3 m_axis;
+	float m_min;
+	float m_max;
+
+	SortableAxis(glm::vec3 const axis, float const min, float const max) : m_axis(axis), m_min(min), m_max(max) {}
+
+	bool operator<(SortableAxis const& sa) const {
+		return (m_max - m_min) < (sa.m_max - sa.m_min);
+	}
+};
+
+
+// oriented bounding box, stored as 3 orthonormal axes plus the min/max scalars of the fitted points projected along each of them
+//NOTE: the axes are sorted by extent (m_axes[0] is the shortest, m_axes[2] the longest), which is the V1/V2/V3 convention used by the cage generation
+struct OBB {
+	glm::vec3 m_axes[3] = { glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f) };
+	float m_min[3] = { 0.0f, 0.0f, 0.0f };
+	float m_max[3] = { 0.0f, 0.0f, 0.0f };
+
+	glm::vec3 m_mean = glm::vec3(0.0f, 0.0f, 0.0f); // centroid of the fitted points (not necessarily the box centre)
+
+	float getExtent(unsigned int const axis) const { return m_max[axis] - m_min[axis]; }
+	float getVolume() const { return getExtent(0) * getExtent(1) * getExtent(2); }
+
+	// box corner picked by 3 bits (bit 0 = max along V1, bit 1 = max along V2, bit 2 = max along V3)
+	glm::vec3 getCorner(unsigned int const cornerBits) const {
+		return ((cornerBits & 1) ? m_max[0] : m_min[0]) * m_axes[0] + ((cornerBits & 2) ? m_max[1] : m_min[1]) * m_axes[1] + ((cornerBits & 4) ? m_max[2] : m_min[2]) * m_axes[2];
+	}
+};
+
+
+struct OBBFitOptions {
+	// fit the axes to the points on the convex hull only (extents are unaffected since the extreme points of a set always lie on its hull)
+	bool m_useConvexHull = false;
+
+	// also try the boxes that have a face flush with a convex hull face (rotating calipers), and keep the tightest one if it beats the PCA box
+	//NOTE: this is much slower than plain PCA, but helps for models where PCA is poor (e.g. symmetric or boxy models where the eigenvectors are arbitrary)
+	bool m_useHullFaceSearch = false;
+};
+
+
+// reusable OBB fitting engine (Principal Component Analysis)
+// reference: https://stackoverflow.com/questions/6189229/creating-oobb-from-points
+// reference: https://hewjunwei.wordpress.com/2013/01/26/obb-generation-via-principal-component-analysis/
+class OBBTools {
+
+public:
+	static OBB fitOBB(std::vector<glm::vec3> const& points, OBBFitOptions const& options = OBBFitOptions());
+
+	// fused single pass mean + covariance (parallel Welford, merged with Chan's pairwise formula)
+	//NOTE: out_covariance is the (unnormalized) scatter matrix, sum of dev * (dev)^T, which has the same eigenvectors as the covariance matrix
+	static void computeMeanAndCovariance(std::vector<glm::vec3> const& points, glm::dvec3 &out_mean, glm::dmat3 &out_covariance);
+
+	// single (SIMD) pass over the points finding the min/max scalar of the projections along each of the 3 given unit axes
+	static void computeExtents(std::vector<glm::vec3> const& points, glm::vec3 const axes[3], float out_min[3], float out_max[3]);
+
+	// minimum volume box over all the boxes that have a face flush with one of the hull faces
+	// for each face normal n, the hull verts are projected onto the plane orthogonal to n and the min area rectangle of that 2D hull is found with rotating calipers
+	// reference: https://en.wikipedia.org/wiki/Rotating_calipers
+	// reference: https://en.wikipedia.org/wiki/Minimum_bounding_box_algorithms
+	//NOTE: returns a default (axis aligned, empty) OBB if the hull has no faces
+	static OBB fitHullFaceOBB(HullMesh const& hull);
+};
@@ -0,0 +1,449 @@
+#include "ObjectExporter.h"
+
+#include <boost/algorithm/string.hpp>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "ByteOrder.h"
+#include "IndexHashMap.h"
+#include "ParallelTools.h"
+
+
+namespace {
+	// room for any line this exporter writes (the longest is a v/vn line of 3 huge floats, see writeFloat)
+	size_t const s_MAX_LINE_LENGTH = 256;
+
+	char const s_DIGIT_PAIRS[] =
+		"00010203040506070809" "10111213141516171819" "20212223242526272829" "30313233343536373839" "40414243444546474849"
+		"50515253545556575859" "60616263646566676869" "70717273747576777879" "80818283848586878889" "90919293949596979899";
+
+	char* writeUnsigned(char *out, unsigned int const value) {
+		return std::to_chars(out, out + 16, value).ptr;
+	}
+
+	// same output as printf("%f") (6 decimals)
+	//NOTE: floating point to_chars is missing from the v141 toolset, so this goes through an integer instead:
+	// value * 10^6 is exact in a double (24 + 20 mantissa bits), and rounding it half to even gives exactly what printf's correctly rounded output has
+	char* writeFloat(char *out, float const value) {
+		double const scaled = (double)value * 1e6;
+		if (!(std::fabs(scaled) < 9.0e18)) return out + std::snprintf(out, 64, "%f", value); // nan, inf, and anything that doesn't fit in 64 bits
+
+		long long const rounded = std::llrint(scaled);
+		unsigned long long const magnitude = (unsigned long long)(rounded < 0 ? -rounded : rounded);
+		if (std::signbit(value)) *out++ = '-'; // printf keeps the sign of -0 (and of negatives rounding to 0)
+
+		out = std::to_chars(out, out + 24, magnitude / 1000000).ptr;
+		*out++ = '.';
+		unsigned int fraction = (unsigned int)(magnitude % 1000000);
+		for (int d = 4; d >= 0; d -= 2) {
+			std::memcpy(out + d, s_DIGIT_PAIRS + 2 * (fraction % 100), 2);
+			fraction /= 100;
+		}
+		return out + 6;
+	}
+
+	// appends formatLine(out, i) for every i in [0, count) - the lines are formatted in parallel (1 buffer per range), then concatenated in order
+	//NOTE: formatLine writes straight into the buffer (there is always room for s_MAX_LINE_LENGTH chars) and returns the end of its line
+	template <typename Func>
+	void appendLines(size_t const count, Func const& formatLine, std::string &out_text) {
+		std::vector<std::string> chunks(ParallelTools::getThreadCount());
+		ParallelTools::parallelForRange(count, [&](size_t const begin, size_t const end, unsigned int const threadIndex) {
+			std::string &chunk = chunks[threadIndex];
+			chunk.resize((end - begin) * 48 + s_MAX_LINE_LENGTH);
+
+			size_t size = 0;
+			for (size_t i = begin; i < end; ++i) {
+				if (chunk.size() - size < s_MAX_LINE_LENGTH) chunk.resize(2 * chunk.size());
+				size = formatLine(&chunk[size], i) - chunk.data();
+			}
+			chunk.resize(size);
+		}, 4096);
+
+		size_t totalSize = out_text.size();
+		for (std::string const& chunk : chunks) totalSize += chunk.size();
+		out_text.reserve(totalSize);
+		for (std::string const& chunk : chunks) out_text += chunk;
+	}
+
+	// a [data, data + size) range of bytes
+	typedef std::pair<char const*, size_t> Bytes;
+
+	// writes the pieces 1 after the other (1 write each, no copies into a staging buffer)
+	//NOTE: the file is only opened for writing if it doesn't exist yet (existing files never get overwritten)
+	//NOTE: text files (obj) are written in text mode, so they get the platform's line breaks - binary ones must not (windows would turn every \n byte into \r\n)
+	bool writeNewFile(std::string const& filePath, std::vector<Bytes> const& pieces, bool const isBinary) {
+		FILE *fp = fopen(filePath.c_str(), isBinary ? "wbx" : "wx");
+		if (NULL == fp) return false;
+
+		bool isWritten = true;
+		for (Bytes const& piece : pieces) {
+			if (0 != piece.second) isWritten = isWritten && piece.second == fwrite(piece.first, 1, piece.second, fp);
+		}
+		bool const isClosed = 0 == fclose(fp);
+		return isWritten && isClosed;
+	}
+
+	// writes the whole file with a single write
+	bool writeNewFile(std::string const& filePath, char const* data, size_t const size, bool const isBinary) {
+		return writeNewFile(filePath, std::vector<Bytes>(1, Bytes(data, size)), isBinary);
+	}
+
+	// json array of the components (shortest text that reads back as the same float)
+	std::string toJSONArray(glm::vec3 const& value) {
+		char text[64];
+		std::snprintf(text, sizeof(text), "[%.9g,%.9g,%.9g]", value.x, value.y, value.z);
+		return text;
+	}
+
+	// key of a float tuple for deduplication (-0 is folded into +0, so keys are equal exactly when the values compare equal)
+	template <typename Key, typename Vec>
+	Key toKey(Vec const& value) {
+		Key key;
+		for (int c = 0; c < Vec::length(); ++c) {
+			float const component = value[c] + 0.0f;
+			std::memcpy(&key[c], &component, sizeof(float));
+		}
+		return key;
+	}
+
+	// unique values in order of first use, plus the (1-based) obj index of every draw vert (in component c of out_objIndices)
+	//NOTE: the v/vt/vn indices of a draw vert share 1 uvec3, so writing a face costs 1 random access per corner instead of 3
+	template <typename Key, typename Vec>
+	void deduplicate(std::vector<Vec> const& values, std::vector<GLuint> const& drawFaces, int const c, std::vector<Vec> &out_uniqueValues, std::vector<glm::uvec3> &out_objIndices) {
+		out_uniqueValues.clear();
+
+		IndexHashMap<Key> uniqueIndices(values.size());
+		for (GLuint const drawIndex : drawFaces) {
+			if (0 != out_objIndices[drawIndex][c]) continue; // draw vert already seen
+
+			bool isNew = false;
+			unsigned int const index = uniqueIndices.findOrInsert(toKey<Key>(values[drawIndex]), (unsigned int)out_uniqueValues.size(), isNew);
+			if (isNew) out_uniqueValues.push_back(values[drawIndex]);
+			out_objIndices[drawIndex][c] = index + 1; //NOTE: obj indices are 1-based
+		}
+	}
+}
+
+
+bool ObjectExporter::exportTriMeshOBJ(std::string const& filePath, MeshObject const& mesh, bool const includeUVs, bool const includeNormals) {
+	size_t const vertCount = mesh.drawVerts.size();
+	if (includeUVs && mesh.uvs.size() != vertCount) return false;
+	if (includeNormals && mesh.normals.size() != vertCount) return false;
+	for (GLuint const index : mesh.drawFaces) {
+		if (index >= vertCount) return false;
+	}
+
+	// 1. deduplicate every attribute (linear time, hash maps over the values)...
+	std::vector<glm::vec3> uniqueVerts;
+	std::vector<glm::vec2> uniqueUVs;
+	std::vector<glm::vec3> uniqueNormals;
+	std::vector<glm::uvec3> objIndices(vertCount, glm::uvec3(0, 0, 0)); // v, vt, vn
+	deduplicate<glm::uvec3>(mesh.drawVerts, mesh.drawFaces, 0, uniqueVerts, objIndices);
+	if (includeUVs) deduplicate<glm::uvec2>(mesh.uvs, mesh.drawFaces, 1, uniqueUVs, objIndices);
+	if (includeNormals) deduplicate<glm::uvec3>(mesh.normals, mesh.drawFaces, 2, uniqueNormals, objIndices);
+
+	// 2. format...
+	std::string text = "# Exported from Cage-Tool\n";
+
+	text += "\n\n# -----VERTS-----\n";
+	appendLines(uniqueVerts.size(), [&uniqueVerts](char *out, size_t const i) {
+		glm::vec3 const& v = uniqueVerts[i];
+		std::memcpy(out, "\nv ", 3);
+		out = writeFloat(out + 3, v.x);
+		*out++ = ' ';
+		out = writeFloat(out, v.y);
+		*out++ = ' ';
+		return writeFloat(out, v.z);
+	}, text);
+
+	if (includeUVs) {
+		text += "\n\n# -----UVS-----\n";
+		appendLines(uniqueUVs.size(), [&uniqueUVs](char *out, size_t const i) {
+			glm::vec2 const& uv = uniqueUVs[i];
+			std::memcpy(out, "\nvt ", 4);
+			out = writeFloat(out + 4, uv.x);
+			*out++ = ' ';
+			return writeFloat(out, uv.y);
+		}, text);
+	}
+
+	if (includeNormals) {
+		text += "\n\n# -----NORMALS-----\n";
+		appendLines(uniqueNormals.size(), [&uniqueNormals](char *out, size_t const i) {
+			glm::vec3 const& normal = uniqueNormals[i];
+			std::memcpy(out, "\nvn ", 4);
+			out = writeFloat(out + 4, normal.x);
+			*out++ = ' ';
+			out = writeFloat(out, normal.y);
+			*out++ = ' ';
+			return writeFloat(out, normal.z);
+		}, text);
+	}
+
+	// f v, f v/vt, f v//vn or f v/vt/vn
+	text += "\n\n# -----FACES-----\n";
+	appendLines(mesh.drawFaces.size() / 3, [&](char *out, size_t const f) {
+		std::memcpy(out, "\nf", 2);
+		out += 2;
+		for (size_t corner = 0; corner < 3; ++corner) {
+			glm::uvec3 const& indices = objIndices[mesh.drawFaces[3 * f + corner]];
+			*out++ = ' ';
+			out = writeUnsigned(out, indices[0]);
+			if (!includeUVs && !includeNormals) continue;
+
+			*out++ = '/';
+			if (includeUVs) out = writeUnsigned(out, indices[1]);
+			if (!includeNormals) continue;
+
+			*out++ = '/';
+			out = writeUnsigned(out, indices[2]);
+		}
+		return out;
+	}, text);
+
+	// 3. write...
+	return writeNewFile(filePath, text.data(), text.size(), false);
+}
+
+
+// reference: http://paulbourke.net/dataformats/ply/
+bool ObjectExporter::exportTriMeshPLY(std::string const& filePath, MeshObject const& mesh, bool const includeUVs, bool const includeNormals) {
+	size_t const vertCount = mesh.drawVerts.size();
+	size_t const faceCount = mesh.drawFaces.size() / 3;
+	if (includeUVs && mesh.uvs.size() != vertCount) return false;
+	if (includeNormals && mesh.normals.size() != vertCount) return false;
+	for (GLuint const index : mesh.drawFaces) {
+		if (index >= vertCount) return false;
+	}
+
+	// 1. header (in the host's byte order, so the arrays can be copied as they are)...
+	std::string header = "ply\n";
+	header += ByteOrder::isHostLittleEndian() ? "format binary_little_endian 1.0\n" : "format binary_big_endian 1.0\n";
+	header += "comment Exported from Cage-Tool\n";
+	header += "element vertex " + std::to_string(vertCount) + "\n";
+	header += "property float x\nproperty float y\nproperty float z\n";
+	if (includeNormals) header += "property float nx\nproperty float ny\nproperty float nz\n";
+	if (includeUVs) header += "property float s\nproperty float t\n";
+	header += "element face " + std::to_string(faceCount) + "\n";
+	header += "property list uchar uint vertex_indices\n";
+	header += "end_header\n";
+
+	// 2. vertex records (interleaved attributes) and face records (count + 3 indices), filled in parallel...
+	size_t const vertSize = sizeof(glm::vec3) + (includeNormals ? sizeof(glm::vec3) : 0) + (includeUVs ? sizeof(glm::vec2) : 0);
+	size_t const faceSize = 1 + 3 * sizeof(GLuint);
+
+	std::vector<char> data(header.size() + vertCount * vertSize + faceCount * faceSize);
+	std::memcpy(data.data(), header.data(), header.size());
+	char *const verts = data.data() + header.size();
+	char *const faces = verts + vertCount * vertSize;
+
+	ParallelTools::parallelFor(vertCount, [&](size_t const i) {
+		char *out = verts + i * vertSize;
+		std::memcpy(out, &mesh.drawVerts[i], sizeof(glm::vec3));
+		out += sizeof(glm::vec3);
+		if (includeNormals) {
+			std::memcpy(out, &mesh.normals[i], sizeof(glm::vec3));
+			out += sizeof(glm::vec3);
+		}
+		if (includeUVs) {
+			glm::vec2 const uv = glm::vec2(mesh.uvs[i].x, -mesh.uvs[i].y); //NOTE: undoes the v flip of the loaders
+			std::memcpy(out, &uv, sizeof(glm::vec2));
+		}
+	}, 4096);
+
+	ParallelTools::parallelFor(faceCount, [&](size_t const f) {
+		char *out = faces + f * faceSize;
+		*out = 3;
+		std::memcpy(out + 1, &mesh.drawFaces[3 * f], 3 * sizeof(GLuint));
+	}, 4096);
+
+	// 3. write...
+	return writeNewFile(filePath, data.data(), data.size(), true);
+}
+
+
+// reference: https://en.wikipedia.org/wiki/STL_(file_format)
+bool ObjectExporter::exportTriMeshSTL(std::string const& filePath, MeshObject const& mesh) {
+	size_t const faceCount = mesh.drawFaces.size() / 3;
+	if (faceCount > 0xFFFFFFFF) return false; // the triangle count is a uint32
+	for (GLuint const index : mesh.drawFaces) {
+		if (index >= mesh.drawVerts.size()) return false;
+	}
+
+	size_t const headerSize = 84;
+	size_t const triangleSize = 50;
+	bool const isSwapped = !ByteOrder::isHostLittleEndian(); // STL is always little endian
+
+	// 1. header - 80 bytes that must not start with "solid" (that would mark an ascii STL), then the triangle count...
+	std::vector<char> data(headerSize + faceCount * triangleSize, 0);
+	char const title[] = "Exported from Cage-Tool";
+	std::memcpy(data.data(), title, sizeof(title) - 1);
+	ByteOrder::write<uint32_t>(data.data() + 80, (uint32_t)faceCount, isSwapped);
+
+	// 2. triangles (unit face normal, 3 corners, 0 attribute), filled in parallel...
+	ParallelTools::parallelFor(faceCount, [&](size_t const f) {
+		glm::vec3 const corners[3] = { mesh.drawVerts[mesh.drawFaces[3 * f]], mesh.drawVerts[mesh.drawFaces[3 * f + 1]], mesh.drawVerts[mesh.drawFaces[3 * f + 2]] };
+		glm::vec3 normal = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+		float const length = glm::length(normal);
+		normal = (length > 0.0f) ? normal / length : glm::vec3(0.0f, 0.0f, 0.0f); // degenerate triangle
+
+		char *out = data.data() + headerSize + f * triangleSize;
+		for (int c = 0; c < 3; ++c) out = ByteOrder::write<float>(out, normal[c], isSwapped);
+		for (glm::vec3 const& corner : corners) {
+			for (int c = 0; c < 3; ++c) out = ByteOrder::write<float>(out, corner[c], isSwapped);
+		}
+		//NOTE: the attribute byte count stays 0
+	}, 4096);
+
+	// 3. write...
+	return writeNewFile(filePath, data.data(), data.size(), true);
+}
+
+
+// reference: https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html
+// layout: 12 byte header, JSON chunk (the scene description), BIN chunk (every array, 4 byte aligned)
+bool ObjectExporter::exportMorphTargetsGLB(std::string const& filePath, MeshObject const& mesh, MeshPose const& restPose, std::vector<MeshPose> const& poses, float const displacementThreshold) {
+	size_t const vertCount = restPose.m_verts.size();
+	if (0 == vertCount || 0 == mesh.drawFaces.size() || restPose.m_normals.size() != vertCount) return false;
+	for (MeshPose const& pose : poses) {
+		if (pose.m_verts.size() != vertCount || pose.m_normals.size() != vertCount) return false;
+	}
+	for (GLuint const index : mesh.drawFaces) {
+		if (index >= vertCount) return false;
+	}
+	if (!ByteOrder::isHostLittleEndian()) return false; //NOTE: glTF buffers are little endian, the arrays are written as they are in memory
+
+	// 1. sparse morph targets - the verts displaced by more than the threshold (in index order, as glTF requires), with their position and normal displacements...
+	//NOTE: the normals of verts below the threshold are left as they are (they only change through their neighbours, by very little)
+	struct MorphTarget {
+		std::vector<GLuint> m_indices;
+		std::vector<glm::vec3> m_positionDeltas;
+		std::vector<glm::vec3> m_normalDeltas;
+		glm::vec3 m_min = glm::vec3(0.0f, 0.0f, 0.0f); // the verts that aren't stored have a displacement of 0
+		glm::vec3 m_max = glm::vec3(0.0f, 0.0f, 0.0f);
+	};
+	std::vector<MorphTarget> targets(poses.size());
+	float const squaredThreshold = displacementThreshold * displacementThreshold;
+	ParallelTools::parallelFor(poses.size(), [&](size_t const p) {
+		MorphTarget &target = targets[p];
+		for (size_t v = 0; v < vertCount; ++v) {
+			glm::vec3 const delta = poses[p].m_verts[v] - restPose.m_verts[v];
+			if (glm::dot(delta, delta) <= squaredThreshold) continue;
+
+			target.m_indices.push_back((GLuint)v);
+			target.m_positionDeltas.push_back(delta);
+			target.m_normalDeltas.push_back(poses[p].m_normals[v] - restPose.m_normals[v]);
+			target.m_min = glm::min(target.m_min, delta);
+			target.m_max = glm::max(target.m_max, delta);
+		}
+	}, 1);
+
+	// 2. buffer views (the BIN chunk is just the arrays 1 after the other) and accessors...
+	//NOTE: every array is made of 4 byte components, so every view stays 4 byte aligned
+	std::vector<Bytes> binArrays;
+	size_t binSize = 0;
+	std::string bufferViews;
+	std::string accessors;
+	unsigned int bufferViewCount = 0;
+	unsigned int accessorCount = 0;
+
+	// target: "" for sparse indices/values (they must not have one)
+	auto addBufferView = [&](void const* data, size_t const size, std::string const& target) {
+		bufferViews += (0 == bufferViewCount) ? "{" : ",{";
+		bufferViews += "\"buffer\":0,\"byteOffset\":" + std::to_string(binSize) + ",\"byteLength\":" + std::to_string(size) + target + "}";
+		binArrays.push_back(Bytes((char const*)data, size));
+		binSize += size;
+		return bufferViewCount++;
+	};
+	auto addAccessor = [&](std::string const& accessor) {
+		accessors += (0 == accessorCount) ? accessor : "," + accessor;
+		return accessorCount++;
+	};
+	std::string const vertexTarget = ",\"target\":34962"; // ARRAY_BUFFER
+	std::string const indexTarget = ",\"target\":34963"; // ELEMENT_ARRAY_BUFFER
+	std::string const vec3Count = ",\"componentType\":5126,\"type\":\"VEC3\",\"count\":" + std::to_string(vertCount); // float
+
+	// rest pose...
+	glm::vec3 restMin = restPose.m_verts[0];
+	glm::vec3 restMax = restPose.m_verts[0];
+	for (glm::vec3 const& vert : restPose.m_verts) {
+		restMin = glm::min(restMin, vert);
+		restMax = glm::max(restMax, vert);
+	}
+
+	unsigned int const indices = addAccessor("{\"bufferView\":" + std::to_string(addBufferView(mesh.drawFaces.data(), mesh.drawFaces.size() * sizeof(GLuint), indexTarget)) + ",\"componentType\":5125,\"type\":\"SCALAR\",\"count\":" + std::to_string(mesh.drawFaces.size()) + "}");
+	unsigned int const positions = addAccessor("{\"bufferView\":" + std::to_string(addBufferView(restPose.m_verts.data(), vertCount * sizeof(glm::vec3), vertexTarget)) + vec3Count + ",\"min\":" + toJSONArray(restMin) + ",\"max\":" + toJSONArray(restMax) + "}");
+	unsigned int const normals = addAccessor("{\"bufferView\":" + std::to_string(addBufferView(restPose.m_normals.data(), vertCount * sizeof(glm::vec3), vertexTarget)) + vec3Count + "}");
+	std::string attributes = "\"POSITION\":" + std::to_string(positions) + ",\"NORMAL\":" + std::to_string(normals);
+
+	// glTF has v pointing down from the top of the texture, the loaders store -v (see ObjectLoader::parseOBJLine), so v' = 1 - v = 1 + (-v)
+	std::vector<glm::vec2> uvs;
+	if (mesh.uvs.size() == vertCount) {
+		uvs.resize(vertCount);
+		for (size_t v = 0; v < vertCount; ++v) uvs[v] = glm::vec2(mesh.uvs[v].x, 1.0f + mesh.uvs[v].y);
+		attributes += ",\"TEXCOORD_0\":" + std::to_string(addAccessor("{\"bufferView\":" + std::to_string(addBufferView(uvs.data(), vertCount * sizeof(glm::vec2), vertexTarget)) + ",\"componentType\":5126,\"type\":\"VEC2\",\"count\":" + std::to_string(vertCount) + "}"));
+	}
+
+	// ...morph targets (a target without any displaced verts is all zeros, which needs neither a buffer view nor sparse storage)
+	std::string morphTargets;
+	std::string weights;
+	std::string targetNames;
+	for (size_t p = 0; p < targets.size(); ++p) {
+		MorphTarget const& target = targets[p];
+		std::string positionDeltas = "{" + vec3Count.substr(1) + ",\"min\":" + toJSONArray(target.m_min) + ",\"max\":" + toJSONArray(target.m_max);
+		std::string normalDeltas = "{" + vec3Count.substr(1);
+		if (!target.m_indices.empty()) {
+			std::string const sparse = ",\"sparse\":{\"count\":" + std::to_string(target.m_indices.size()) + ",\"indices\":{\"componentType\":5125,\"bufferView\":" + std::to_string(addBufferView(target.m_indices.data(), target.m_indices.size() * sizeof(GLuint), "")) + "},\"values\":{\"bufferView\":";
+			positionDeltas += sparse + std::to_string(addBufferView(target.m_positionDeltas.data(), target.m_positionDeltas.size() * sizeof(glm::vec3), "")) + "}}";
+			normalDeltas += sparse + std::to_string(addBufferView(target.m_normalDeltas.data(), target.m_normalDeltas.size() * sizeof(glm::vec3), "")) + "}}";
+		}
+
+		std::string const separator = (0 == p) ? "" : ",";
+		morphTargets += separator + "{\"POSITION\":" + std::to_string(addAccessor(positionDeltas + "}")) + ",\"NORMAL\":" + std::to_string(addAccessor(normalDeltas + "}")) + "}";
+		weights += separator + "0";
+		targetNames += separator + "\"pose " + std::to_string(p + 1) + "\"";
+	}
+
+	// 3. json...
+	std::string json = "{\"asset\":{\"version\":\"2.0\",\"generator\":\"Cage-Tool\"},\"scene\":0,\"scenes\":[{\"nodes\":[0]}],\"nodes\":[{\"mesh\":0}]";
+	json += ",\"meshes\":[{\"primitives\":[{\"attributes\":{" + attributes + "},\"indices\":" + std::to_string(indices) + ",\"mode\":4";
+	if (!targets.empty()) json += ",\"targets\":[" + morphTargets + "]}],\"weights\":[" + weights + "],\"extras\":{\"targetNames\":[" + targetNames + "]}}]";
+	else json += "}]}]";
+	json += ",\"buffers\":[{\"byteLength\":" + std::to_string(binSize) + "}],\"bufferViews\":[" + bufferViews + "],\"accessors\":[" + accessors + "]}";
+	json.resize((json.size() + 3) / 4 * 4, ' '); // chunks have to be 4 byte aligned (padded with spaces for json)
+
+	// 4. header + chunk headers, then every array straight from where it is...
+	if (12 + 8 + json.size() + 8 + binSize > 0xFFFFFFFF) return false; // glb sizes are uint32
+
+	char header[20];
+	char *out = header;
+	out = ByteOrder::write<uint32_t>(out, 0x46546C67, false); // "glTF"
+	out = ByteOrder::write<uint32_t>(out, 2, false); // version
+	out = ByteOrder::write<uint32_t>(out, (uint32_t)(12 + 8 + json.size() + 8 + binSize), false);
+	out = ByteOrder::write<uint32_t>(out, (uint32_t)json.size(), false);
+	out = ByteOrder::write<uint32_t>(out, 0x4E4F534A, false); // "JSON"
+	char binHeader[8];
+	ByteOrder::write<uint32_t>(binHeader, (uint32_t)binSize, false);
+	ByteOrder::write<uint32_t>(binHeader + 4, 0x004E4942, false); // "BIN"
+
+	std::vector<Bytes> pieces = { Bytes(header, 20), Bytes(json.data(), json.size()), Bytes(binHeader, 8) };
+	pieces.insert(pieces.end(), binArrays.begin(), binArrays.end());
+	return writeNewFile(filePath, pieces, true);
+}
+
+
+bool ObjectExporter::exportTriMesh(std::string const& filePath, MeshObject const& mesh, bool const includeUVs, bool const includeNormals) {
+	size_t const dotIndex = filePath.find_last_of(".");
+	if (dotIndex == std::string::npos) return false;
+
+	std::string const extension = filePath.substr(dotIndex + 1);
+	if (boost::iequals(extension, "obj")) return exportTriMeshOBJ(filePath, mesh, includeUVs, includeNormals);
+	if (boost::iequals(extension, "ply")) return exportTriMeshPLY(filePath, mesh, includeUVs, includeNormals);
+	if (boost::iequals(extension, "stl")) return exportTriMeshSTL(filePath, mesh);
+	return false;
+}
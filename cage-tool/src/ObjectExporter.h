@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "MeshObject.h"
+
+
+// snapshot of a mesh's verts/normals in 1 pose (e.g. the model after a cage deformation)
+struct MeshPose {
+	std::vector<glm::vec3> m_verts;
+	std::vector<glm::vec3> m_normals;
+};
+
+
+// writes MeshObjects back out as obj, ply, stl or glb files
+class ObjectExporter {
+
+public:
+	// verts (and uvs/normals if included) are deduplicated by value, so verts that only got split for OpenGL (e.g. along uv seams) are merged again
+	// RETURNS false if the file already exists (it never gets overwritten), can't be written, or the mesh doesn't have the requested attributes
+	//NOTE: the whole file is formatted into memory (in parallel) and written with a single write
+	static bool exportTriMeshOBJ(std::string const& filePath, MeshObject const& mesh, bool const includeUVs, bool const includeNormals);
+
+	// binary PLY in the host's byte order - every draw vert is written as is (PLY is single-indexed like OpenGL, nothing to deduplicate)
+	static bool exportTriMeshPLY(std::string const& filePath, MeshObject const& mesh, bool const includeUVs, bool const includeNormals);
+
+	// binary STL - only positions make it into the file (plus a normal per face), so uvs/normals are never included
+	static bool exportTriMeshSTL(std::string const& filePath, MeshObject const& mesh);
+
+	// binary glTF 2.0 (.glb) of the mesh in its rest pose, with every pose as a morph target (an engine can then blend between the poses)
+	// the morph targets are sparse - only verts that are displaced by more than displacementThreshold (in model units) are stored
+	//NOTE: faces/uvs come from mesh, positions/normals from the poses. All arrays are written straight into the file (no json/base64 encoding)
+	static bool exportMorphTargetsGLB(std::string const& filePath, MeshObject const& mesh, MeshPose const& restPose, std::vector<MeshPose> const& poses, float const displacementThreshold);
+
+	// picks the format by the extension of filePath (.obj, .ply or .stl, case-insensitive), RETURNS false for any other
+	static bool exportTriMesh(std::string const& filePath, MeshObject const& mesh, bool const includeUVs, bool const includeNormals);
+};
@@ -1,8 +1,52 @@
 #include "ObjectLoader.h"
 
-#include <fstream>
 #include <boost/algorithm/string.hpp>
+#include <cctype>
+#include <charconv>
 
+#include "ByteOrder.h"
+#include "IndexHashMap.h"
+#include "MappedFile.h"
+#include "MeshCache.h"
+#include "ParallelTools.h"
+#include "TextParsing.h"
+
+
+
+namespace {
+	// case-insensitive, extension without the dot
+	bool hasExtension(std::string const& filePath, char const* extension) {
+		size_t const dotIndex = filePath.find_last_of(".");
+		if (dotIndex == std::string::npos) return false;
+		return boost::iequals(filePath.substr(dotIndex + 1), extension);
+	}
+
+	// files smaller than 2 chunks of this size are parsed serially
+	size_t const s_MIN_CHUNK_SIZE = 4 * 1024 * 1024;
+
+	// what got parsed out of 1 chunk of a file
+	struct OBJChunk {
+		std::vector<glm::vec3> m_verts;
+		std::vector<glm::vec2> m_uvs;
+		std::vector<glm::vec3> m_normals;
+		std::vector<glm::ivec3> m_facePoints;
+
+		bool m_isValid = false;
+		size_t m_lineCount = 0; // lines parsed (if invalid, the invalid line is the next one)
+	};
+
+	// concatenates the member vectors of all chunks, in chunk order (prefix sum of their sizes gives every chunk's offset, the copies run in parallel)
+	template <typename T>
+	void stitchChunks(std::vector<OBJChunk> const& chunks, std::vector<T> OBJChunk::*member, std::vector<T> &out_data) {
+		std::vector<size_t> offsets(chunks.size() + 1, 0);
+		for (size_t c = 0; c < chunks.size(); ++c) offsets[c + 1] = offsets[c] + (chunks[c].*member).size();
+
+		out_data.resize(offsets.back());
+		ParallelTools::parallelFor(chunks.size(), [&](size_t const c) {
+			std::copy((chunks[c].*member).begin(), (chunks[c].*member).end(), out_data.begin() + offsets[c]);
+		}, 1);
+	}
+}
 
 
 //NOTE: this method simply returns the data as found in file (but with indices decremented by 1 for 0-indexing). Thus, for OpenGL, the data still needs to be converted into a single-index-buffer format.
@@ -14,7 +58,7 @@
 //TODO: probably gonna have to keep track of stuff like "g" "usemtl", etc. and maybe comments so that they can be added to any exported files by our application (maybe we won't support that though...)
 //TODO: could also return an error string with a specific error
 // reference: http://paulbourke.net/dataformats/obj/
-bool ObjectLoader::loadTriMeshOBJ(std::string const& filePath, std::vector<glm::vec3> &out_verts, std::vector<glm::vec2> &out_uvs, std::vector<glm::vec3> &out_normals, std::vector<std::vector<glm::vec3>> &out_faces) {
+bool ObjectLoader::loadTriMeshOBJ(std::string const& filePath, std::vector<glm::vec3> &out_verts, std::vector<glm::vec2> &out_uvs, std::vector<glm::vec3> &out_normals, std::vector<glm::ivec3> &out_facePoints) {
 
 	// ERROR CHECKING...
 
@@ -39,242 +83,324 @@ bool ObjectLoader::loadTriMeshOBJ(std::string const& filePath, std::vector<glm::
 	out_verts.clear();
 	out_uvs.clear();
 	out_normals.clear();
-	out_faces.clear();
+	out_facePoints.clear();
 
-	// 2. read obj file line by line (each line as a string). Only error checking here will be format checking on the lines (e.g. f 1/1/1 2/2/2 3/3/3 4/4/4 would return false since we are assuming pure tri mesh)
+	// 2. scan the memory mapped obj file line by line (no copies - lines and tokens are just [begin, end) ranges into the mapping). Only error checking here will be format checking on the lines (e.g. f 1/1/1 2/2/2 3/3/3 4/4/4 would return false since we are assuming pure tri mesh)
 
-	// open file
-	std::ifstream fileStream;
-	fileStream.open(filePath); // opens file for reading (default mode)
-	// reference: https://stackoverflow.com/questions/4206816/ifstream-check-if-opened-successfully
-	if (!fileStream) return false; // if opening failed or stream is bad (e.g. invalid path), error
+	MappedFile file;
+	if (!file.open(filePath)) return false; // if opening failed (e.g. invalid path), error
 
 	//NOTE: the file will be parsed in an order-agnostic manner
-	std::string line = "";
+	char const* const fileBegin = file.getData();
+	char const* const fileEnd = fileBegin + file.getSize();
+
+	// big files are split (at line breaks) into 1 chunk per thread, which get parsed in parallel into their own buffers...
+	size_t const chunkCount = std::max<size_t>(1, std::min<size_t>(ParallelTools::getThreadCount(), file.getSize() / s_MIN_CHUNK_SIZE));
+	std::vector<char const*> chunkStarts(chunkCount + 1, fileEnd);
+	chunkStarts[0] = fileBegin;
+	for (size_t c = 1; c < chunkCount; ++c) {
+		char const* start = std::max(chunkStarts[c - 1], fileBegin + file.getSize() * c / chunkCount);
+		char const* const lineBreak = (char const*)std::memchr(start, '\n', fileEnd - start);
+		chunkStarts[c] = (nullptr == lineBreak) ? fileEnd : lineBreak + 1;
+	}
 
-	// reference: https://stackoverflow.com/questions/19123334/how-to-use-stdgetline-to-read-a-text-file-into-an-array-of-strings-in-c
-	// reference: https://stackoverflow.com/questions/5605125/why-is-iostreameof-inside-a-loop-condition-i-e-while-stream-eof-cons
-	while (std::getline(fileStream, line)) {
+	if (1 == chunkCount) {
+		size_t lineCount = 0;
+		if (!parseOBJLines(fileBegin, fileEnd, out_verts, out_uvs, out_normals, out_facePoints, lineCount)) {
+			std::cout << "ERROR (ObjectLoader.cpp) - invalid line " << lineCount + 1 << " in " << filePath << std::endl;
+			return false;
+		}
+	} else {
+		std::vector<OBJChunk> chunks(chunkCount);
+		ParallelTools::parallelFor(chunkCount, [&](size_t const c) {
+			OBJChunk &chunk = chunks[c];
+			chunk.m_isValid = parseOBJLines(chunkStarts[c], chunkStarts[c + 1], chunk.m_verts, chunk.m_uvs, chunk.m_normals, chunk.m_facePoints, chunk.m_lineCount);
+		}, 1);
+
+		// ...the first invalid line (in file order) is the one a serial parse would have stopped at
+		size_t lineCount = 0; // lines before chunk c
+		for (OBJChunk const& chunk : chunks) {
+			if (!chunk.m_isValid) {
+				std::cout << "ERROR (ObjectLoader.cpp) - invalid line " << lineCount + chunk.m_lineCount + 1 << " in " << filePath << std::endl;
+				return false;
+			}
+			lineCount += chunk.m_lineCount;
+		}
 
-		boost::trim(line);
-		if (line.empty()) continue; // ignore blank lines
+		// OBJ indices are absolute (we don't support the relative negative ones), so the chunks just get concatenated
+		stitchChunks(chunks, &OBJChunk::m_verts, out_verts);
+		stitchChunks(chunks, &OBJChunk::m_uvs, out_uvs);
+		stitchChunks(chunks, &OBJChunk::m_normals, out_normals);
+		stitchChunks(chunks, &OBJChunk::m_facePoints, out_facePoints);
+	}
 
-		// reference: https://wiki.fileformat.com/3d/obj/
-		//NOTE: this method will only be looking for v,vt,vn,f lines. Every line with a different prefix will simply be ignored (this includes all the valid prefix tokens listed in the above link, but it also unfortunately includes any gibberish as well)
-		//NOTE: this seems fine by me since this code should work even if the file format is updated in the future (by adding features, not subtracting the ones we support)
+	// FILE HAS BEEN READ WITHOUT ERROR
+	// POST ERROR CHECKING...
 
-		//NOTE: prefix tokens will be checked in a case-insensitive manner (idk if this is a violation of the spec, but its more flexible to the user)
+	//NOTE: file must have contained verts and faces
+	//NOTE: this error could also happen if file was empty or gibberish
+	if (out_verts.size() == 0 || out_facePoints.size() == 0) return false;
 
-		// reference: https://stackoverflow.com/questions/10551125/boost-string-split-to-eliminate-spaces-in-words
+	//NOTE: all points (making up all faces) in the file must be in the same index format (e.g. v0 v1 v2 == v0// v1// v2//, but v0/vt1/ ... != v0//vn0 ...)
+	//NOTE: only need to check the state of vtIndex/vnIndex since error checking in the f-section already made sure every point had a valid vIndex.
+	//NOTE: also must check if every index in in range of their respective vector
 
-		
-		//NOTE: command prefixes must be followed by a space character (or tab)
-		// reference: https://stackoverflow.com/questions/2896600/how-to-replace-all-occurrences-of-a-character-in-string
-		std::replace(line.begin(), line.end(), '\t', ' '); // replace any and all tabs with simple space chars
+	// first, we can figure out the format to look for based on the first point
+	glm::ivec3 const& firstPoint = out_facePoints.at(0);
+	bool const vtIndexExpected = -1 != firstPoint.y;
+	bool const vnIndexExpected = -1 != firstPoint.z;
 
+	// loop through all points of all faces...
+	for (glm::ivec3 const& p : out_facePoints) {
 
-		if (boost::istarts_with(line, "v ")) {
-			std::string suffix = line.substr(2);
-			//NOTE: this suffix cannot be empty since it would mean our whole trimmed line is "v " which is impossible since we trimmed our raw line to get it
-			boost::trim_left(suffix); //NOTE: right trim is unneeded since line was already trimmed before
-			//NOTE: this suffix is also guaranteed to not be empty (otherwise, it would have been trimmed before)
+		// 1. check index format is consistent...
 
-			//NOTE: suffix is expected to be in the format "x[whitespace]y[whitespace]z" where x,y,z are real numbers (will get parsed into floats)
-			std::vector<std::string> words;
-			boost::split(words, suffix, boost::is_any_of(" "), boost::token_compress_on); //NOTE: no need to check for '\t', since we already replaced them with ' ' in whole line
+		bool const vtFound = -1 != p.y;
+		if (vtIndexExpected != vtFound) return false; // mismatch of index format
 
-			if (words.size() != 3) return false; // invalid format
+		bool const vnFound = -1 != p.z;
+		if (vnIndexExpected != vnFound) return false; // mismatch of index format
 
-			//TODO: test -ve, none, +ve, ints, does 0.5f work (probably not, but no file will ever have this)
-			try {
-				glm::vec3 vert;
-				vert.x = std::stof(words.at(0));
-				vert.y = std::stof(words.at(1));
-				vert.z = std::stof(words.at(2));
-				out_verts.push_back(vert);
-			} catch (...) { // catch-all (cannot convert or range violation)
-				return false;
-			}
+		// 2. check each index is in respective vector range...
+		//NOTE: only need to check if index exists (!= -1)
 
-		} else if (boost::istarts_with(line, "vt ")) {
-			std::string suffix = line.substr(3);
-			//NOTE: this suffix cannot be empty since it would mean our whole trimmed line is "vt " which is impossible since we trimmed our raw line to get it
-			boost::trim_left(suffix); //NOTE: right trim is unneeded since line was already trimmed before
-			//NOTE: this suffix is also guaranteed to not be empty (otherwise, it would have been trimmed before)
-
-			//NOTE: suffix is expected to be in the format "u[whitespace]v" where u,v are real numbers (will get parsed into floats)
-			//NOTE: if u,v,w is encountered, we treat it as a parsing error (this parser does not support 3D texture coords despite them being valid in specification)
-			std::vector<std::string> words;
-			boost::split(words, suffix, boost::is_any_of(" "), boost::token_compress_on); //NOTE: no need to check for '\t', since we already replaced them with ' ' in whole line
-
-			if (words.size() != 2) return false; // invalid format
-
-			//TODO: test -ve, none, +ve, ints, does 0.5f work (probably not, but no file will ever have this)
-			try {
-				glm::vec2 uv;
-				uv.x = std::stof(words.at(0));
-				uv.y = std::stof(words.at(1));
-				//TODO: could add error checking here to make sure both U and V are in range [0.0f, 1.0f]
-				uv.y *= -1; //NOTE: MUST FLIP THE V COORD HERE!
-				//uv.y = 1.0f - uv.y; //NOTE: this seems to work as well, but i'll go with the above fix since it was present in old obj loader
-				out_uvs.push_back(uv);
-			}
-			catch (...) { // catch-all (cannot convert or range violation)
-				return false;
-			}
+		if (out_verts.size() <= (size_t)p.x) return false;
+		if (vtFound && out_uvs.size() <= (size_t)p.y) return false;
+		if (vnFound && out_normals.size() <= (size_t)p.z) return false;
+	}
 
-		} else if (boost::istarts_with(line, "vn ")) {
-			std::string suffix = line.substr(3);
-			//NOTE: this suffix cannot be empty since it would mean our whole trimmed line is "vn " which is impossible since we trimmed our raw line to get it
-			boost::trim_left(suffix); //NOTE: right trim is unneeded since line was already trimmed before
-			//NOTE: this suffix is also guaranteed to not be empty (otherwise, it would have been trimmed before)
-
-			//NOTE: suffix is expected to be in the format "x[whitespace]y[whitespace]z" where x,y,z are real numbers (will get parsed into floats)
-			std::vector<std::string> words;
-			boost::split(words, suffix, boost::is_any_of(" "), boost::token_compress_on); //NOTE: no need to check for '\t', since we already replaced them with ' ' in whole line
-
-			if (words.size() != 3) return false; // invalid format
-
-			//TODO: test -ve, none, +ve, ints, does 0.5f work (probably not, but no file will ever have this)
-			try {
-				glm::vec3 normal;
-				normal.x = std::stof(words.at(0));
-				normal.y = std::stof(words.at(1));
-				normal.z = std::stof(words.at(2));
-				//TODO: do I need to add error checking for 1. zero vector? 2. non-normalized vector?
-				out_normals.push_back(normal);
-			}
-			catch (...) { // catch-all (cannot convert or range violation)
-				return false;
-			}
+	return true;
+}
 
-		} else if (boost::istarts_with(line, "f ")) {
-			std::string suffix = line.substr(2);
-			//NOTE: this suffix cannot be empty since it would mean our whole trimmed line is "f " which is impossible since we trimmed our raw line to get it
-			boost::trim_left(suffix); //NOTE: right trim is unneeded since line was already trimmed before
-			//NOTE: this suffix is also guaranteed to not be empty (otherwise, it would have been trimmed before)
-
-			//NOTE: suffix is expected to be in the format "v0/vt0/vn0[whitespace]v1/vt1/vn1[whitespace]v2/vt2/vn2" where each token is an index (int >= 1) - NOTE: negative indices are not supported by this parser despite being valid in spec
-			//NOTE: vt/vn are optional, v is required, thus if both are missing the line could look like v0 v1 v2 or v0// v1// v2//
-			//NOTE: if an index is missing, a symbolic -1 will be put in its place
-			//NOTE: this parser only works for pure tri meshes
-			//NOTE: later on, I will error check that all explicit indices are in the proper format (e.g. can't have f 1/1/1 2//2 3/3/3 in the file)
-			std::vector<std::string> words;
-			boost::split(words, suffix, boost::is_any_of(" "), boost::token_compress_on); //NOTE: no need to check for '\t', since we already replaced them with ' ' in whole line
-
-			if (words.size() != 3) return false; // invalid format
-
-			std::vector<glm::vec3> points; // will be size 3 (triangle) - each of the 3 points has 3 indices (v/vt/vn)
-
-			for (std::string const& point : words) {
-				std::vector<std::string> indices;
-				boost::split(indices, point, boost::is_any_of("/"), boost::token_compress_off);
-
-				int vIndex = -1;
-				int vtIndex = -1;
-				int vnIndex = -1;
-
-				if (indices.size() == 1) { // point is just a vIndex (no slashes)
-					try {
-						vIndex = std::stoi(indices.at(0));
-						if (1 > vIndex) return false; // we only support indices >= 1
-						--vIndex; // must decrement obj indices to shift to 0-indexing
-					} catch (...) { // catch-all (cannot convert or range violation)
-						return false;
-					}
-				} else if (indices.size() == 3) {
-					try {
-						if (indices.at(0).empty()) return false; // missing vIndex (NOTE: we require all faces to have a vIndex)
-						vIndex = std::stoi(indices.at(0));
-						if (1 > vIndex) return false; // we only support indices >= 1
-						--vIndex; // must decrement obj indices to shift to 0-indexing
-						
-						if (!indices.at(1).empty()) { // empty vt will stay at -1
-							vtIndex = std::stoi(indices.at(1));
-							if (1 > vtIndex) return false; // we only support indices >= 1
-							--vtIndex; // must decrement obj indices to shift to 0-indexing
-						}
-
-						if (!indices.at(2).empty()) { // empty vn will stay at -1
-							vnIndex = std::stoi(indices.at(2));
-							if (1 > vnIndex) return false; // we only support indices >= 1
-							--vnIndex; // must decrement obj indices to shift to 0-indexing
-						}
-					} catch (...) { // catch-all (cannot convert or range violation)
-						return false;
-					}
-				} else return false; // have slashes but don't have exactly 2
 
-				// getting here means we have (so far) a valid triple of indices for this point
-				points.push_back(glm::vec3(vIndex, vtIndex, vnIndex));
+
+namespace {
+	// a [begin, end) range of chars within a line
+	struct Token {
+		char const* m_begin = nullptr;
+		char const* m_end = nullptr;
+
+		bool isEmpty() const { return m_begin == m_end; }
+	};
+
+	// splits [begin, end) on blanks (runs of them count as 1, like boost::split with token_compress_on)
+	// RETURNS the number of tokens found, only the first maxTokens get written to out_tokens (so a count > maxTokens means "too many")
+	//NOTE: [begin, end) must already be trimmed
+	unsigned int splitOnBlanks(char const* begin, char const* const end, Token *out_tokens, unsigned int const maxTokens) {
+		unsigned int count = 0;
+		while (begin < end) {
+			char const* tokenEnd = begin;
+			while (tokenEnd < end && !TextParsing::isBlank(*tokenEnd)) ++tokenEnd;
+			if (count < maxTokens) {
+				out_tokens[count].m_begin = begin;
+				out_tokens[count].m_end = tokenEnd;
 			}
+			++count;
+			if (count > maxTokens) break; // that's enough to know it's invalid
 
-			out_faces.push_back(points);
+			begin = tokenEnd;
+			while (begin < end && TextParsing::isBlank(*begin)) ++begin;
+		}
+		return count;
+	}
 
-		} else {
-			if ("v" == line || "vt" == line || "vn" == line || "f" == line) return false; // valid and supported prefix but, missing data
-			else continue; //NOTE: this case handles both gibberish lines (incl. something like v10.2 10.5 12.1 - missing space after 'v') and lines prefixed by valid obj commands that we do not support here
+	// parses a whole token into floats the way std::stof did
+	bool parseFloats(Token const* tokens, unsigned int const count, float *out_values) {
+		for (unsigned int i = 0; i < count; ++i) {
+			if (nullptr == TextParsing::parseFloat(tokens[i].m_begin, tokens[i].m_end, out_values[i])) return false;
+		}
+		return true;
+	}
+
+	// an obj index (>= 1), shifted to 0-indexing
+	bool parseIndex(Token const& token, int &out_index) {
+		if (nullptr == TextParsing::parseInt(token.m_begin, token.m_end, out_index)) return false;
+		if (1 > out_index) return false; // we only support indices >= 1
+		--out_index; // must decrement obj indices to shift to 0-indexing
+		return true;
+	}
+
+	// case-insensitive comparison of a token with a lower case keyword
+	bool isKeyword(Token const& token, char const* keyword) {
+		char const* c = token.m_begin;
+		for (; c < token.m_end && '\0' != *keyword; ++c, ++keyword) {
+			if (std::tolower((unsigned char)*c) != *keyword) return false;
 		}
+		return c == token.m_end && '\0' == *keyword;
+	}
 
-		// otherwise, continue as normal
+	// case-sensitive
+	bool isExactly(char const* begin, char const* end, char const* word) {
+		size_t const length = std::strlen(word);
+		return (size_t)(end - begin) == length && 0 == std::memcmp(begin, word, length);
 	}
+}
 
-	// FILE HAS BEEN READ WITHOUT ERROR
-	// POST ERROR CHECKING...
 
-	//NOTE: file must have contained verts and faces
-	//NOTE: this error could also happen if file was empty or gibberish
-	if (out_verts.size() == 0 || out_faces.size() == 0) return false;
+bool ObjectLoader::parseOBJLines(char const* begin, char const* const end, std::vector<glm::vec3> &out_verts, std::vector<glm::vec2> &out_uvs, std::vector<glm::vec3> &out_normals, std::vector<glm::ivec3> &out_facePoints, size_t &out_lineCount) {
+	out_lineCount = 0;
 
-	//NOTE: all points (making up all faces) in the file must be in the same index format (e.g. v0 v1 v2 == v0// v1// v2//, but v0/vt1/ ... != v0//vn0 ...)
-	//NOTE: only need to check the state of vtIndex/vnIndex since error checking in the f-section already made sure every point had a valid vIndex.
-	//NOTE: also must check if every index in in range of their respective vector
+	char const* lineBegin = begin;
+	while (lineBegin < end) {
+		char const* lineEnd = (char const*)std::memchr(lineBegin, '\n', end - lineBegin);
+		if (nullptr == lineEnd) lineEnd = end;
 
-	// first, we can figure out the format to look for based on the first point
-	glm::vec3 const& firstPoint = out_faces.at(0).at(0);
-	bool const vtIndexExpected = -1 != firstPoint.y;
-	bool const vnIndexExpected = -1 != firstPoint.z;
+		if (!parseOBJLine(lineBegin, lineEnd, out_verts, out_uvs, out_normals, out_facePoints)) return false;
+		++out_lineCount;
+
+		lineBegin = (end == lineEnd) ? end : lineEnd + 1;
+	}
+	return true;
+}
 
-	// loop through all faces...
-	for (std::vector<glm::vec3> const& f : out_faces) {
-		for (glm::vec3 const& p : f) {
 
-			// 1. check index format is consistent...
+// one line of an obj file, see loadTriMeshOBJ
+// RETURNS false on a format error
+bool ObjectLoader::parseOBJLine(char const* lineBegin, char const* lineEnd, std::vector<glm::vec3> &out_verts, std::vector<glm::vec2> &out_uvs, std::vector<glm::vec3> &out_normals, std::vector<glm::ivec3> &out_facePoints) {
 
-			bool const vtFound = -1 != p.y;
-			if (vtIndexExpected != vtFound) return false; // mismatch of index format
+	// trim
+	while (lineBegin < lineEnd && TextParsing::isSpace(*lineBegin)) ++lineBegin;
+	while (lineBegin < lineEnd && TextParsing::isSpace(*(lineEnd - 1))) --lineEnd;
+	if (lineBegin == lineEnd) return true; // ignore blank lines
 
-			bool const vnFound = -1 != p.z;
-			if (vnIndexExpected != vnFound) return false; // mismatch of index format
+	// reference: https://wiki.fileformat.com/3d/obj/
+	//NOTE: this method will only be looking for v,vt,vn,f lines. Every line with a different prefix will simply be ignored (this includes all the valid prefix tokens listed in the above link, but it also unfortunately includes any gibberish as well)
+	//NOTE: this seems fine by me since this code should work even if the file format is updated in the future (by adding features, not subtracting the ones we support)
 
-			// 2. check each index is in respective vector range...
-			//NOTE: only need to check if index exists (!= -1)
+	//NOTE: prefix tokens will be checked in a case-insensitive manner (idk if this is a violation of the spec, but its more flexible to the user)
+	//NOTE: command prefixes must be followed by a space character (or tab)
+	Token prefix;
+	prefix.m_begin = lineBegin;
+	prefix.m_end = lineBegin;
+	while (prefix.m_end < lineEnd && !TextParsing::isBlank(*prefix.m_end)) ++prefix.m_end;
+
+	if (lineEnd == prefix.m_end) {
+		if (isExactly(lineBegin, lineEnd, "v") || isExactly(lineBegin, lineEnd, "vt") || isExactly(lineBegin, lineEnd, "vn") || isExactly(lineBegin, lineEnd, "f")) return false; // valid and supported prefix but, missing data
+		return true; //NOTE: this case handles both gibberish lines (incl. something like v10.2 10.5 12.1 - missing space after 'v') and lines prefixed by valid obj commands that we do not support here
+	}
 
-			if (out_verts.size() <= p.x) return false;
-			if (vtFound && out_uvs.size() <= p.y) return false;
-			if (vnFound && out_normals.size() <= p.z) return false;
+	//NOTE: the suffix can't be empty since the line was trimmed
+	char const* suffixBegin = prefix.m_end;
+	while (TextParsing::isBlank(*suffixBegin)) ++suffixBegin;
+
+	Token words[4]; // 1 more than any supported line has, to detect too many
+
+	if (isKeyword(prefix, "v")) {
+		//NOTE: suffix is expected to be in the format "x[whitespace]y[whitespace]z" where x,y,z are real numbers (will get parsed into floats)
+		if (splitOnBlanks(suffixBegin, lineEnd, words, 4) != 3) return false; // invalid format
+
+		glm::vec3 vert;
+		if (!parseFloats(words, 3, &vert.x)) return false; // cannot convert or range violation
+		out_verts.push_back(vert);
+
+	} else if (isKeyword(prefix, "vt")) {
+		//NOTE: suffix is expected to be in the format "u[whitespace]v" where u,v are real numbers (will get parsed into floats)
+		//NOTE: if u,v,w is encountered, we treat it as a parsing error (this parser does not support 3D texture coords despite them being valid in specification)
+		if (splitOnBlanks(suffixBegin, lineEnd, words, 4) != 2) return false; // invalid format
+
+		glm::vec2 uv;
+		if (!parseFloats(words, 2, &uv.x)) return false; // cannot convert or range violation
+		//TODO: could add error checking here to make sure both U and V are in range [0.0f, 1.0f]
+		uv.y *= -1; //NOTE: MUST FLIP THE V COORD HERE!
+		//uv.y = 1.0f - uv.y; //NOTE: this seems to work as well, but i'll go with the above fix since it was present in old obj loader
+		out_uvs.push_back(uv);
+
+	} else if (isKeyword(prefix, "vn")) {
+		//NOTE: suffix is expected to be in the format "x[whitespace]y[whitespace]z" where x,y,z are real numbers (will get parsed into floats)
+		if (splitOnBlanks(suffixBegin, lineEnd, words, 4) != 3) return false; // invalid format
+
+		glm::vec3 normal;
+		if (!parseFloats(words, 3, &normal.x)) return false; // cannot convert or range violation
+		//TODO: do I need to add error checking for 1. zero vector? 2. non-normalized vector?
+		out_normals.push_back(normal);
+
+	} else if (isKeyword(prefix, "f")) {
+		//NOTE: suffix is expected to be in the format "v0/vt0/vn0[whitespace]v1/vt1/vn1[whitespace]v2/vt2/vn2" where each token is an index (int >= 1) - NOTE: negative indices are not supported by this parser despite being valid in spec
+		//NOTE: vt/vn are optional, v is required, thus if both are missing the line could look like v0 v1 v2 or v0// v1// v2//
+		//NOTE: if an index is missing, a symbolic -1 will be put in its place
+		//NOTE: this parser only works for pure tri meshes
+		//NOTE: later on, I will error check that all explicit indices are in the proper format (e.g. can't have f 1/1/1 2//2 3/3/3 in the file)
+		if (splitOnBlanks(suffixBegin, lineEnd, words, 4) != 3) return false; // invalid format
+
+		glm::ivec3 points[3]; // each of the 3 points has 3 indices (v/vt/vn)
+
+		for (unsigned int i = 0; i < 3; ++i) {
+			// split on '/' (empty pieces are kept)
+			Token indices[3];
+			unsigned int indexCount = 0;
+			char const* pieceBegin = words[i].m_begin;
+			while (true) {
+				char const* pieceEnd = pieceBegin;
+				while (pieceEnd < words[i].m_end && '/' != *pieceEnd) ++pieceEnd;
+				if (indexCount == 3) return false; // more than 2 slashes
+				indices[indexCount].m_begin = pieceBegin;
+				indices[indexCount].m_end = pieceEnd;
+				++indexCount;
+				if (pieceEnd == words[i].m_end) break;
+				pieceBegin = pieceEnd + 1;
+			}
+
+			glm::ivec3 &point = points[i];
+			point = glm::ivec3(-1, -1, -1);
+
+			if (indexCount == 1) { // point is just a vIndex (no slashes)
+				if (!parseIndex(indices[0], point.x)) return false;
+			} else if (indexCount == 3) {
+				if (indices[0].isEmpty()) return false; // missing vIndex (NOTE: we require all faces to have a vIndex)
+				if (!parseIndex(indices[0], point.x)) return false;
+				if (!indices[1].isEmpty() && !parseIndex(indices[1], point.y)) return false; // empty vt will stay at -1
+				if (!indices[2].isEmpty() && !parseIndex(indices[2], point.z)) return false; // empty vn will stay at -1
+			} else return false; // have slashes but don't have exactly 2
 		}
+
+		// getting here means we have a valid triple of indices for every point
+		out_facePoints.insert(out_facePoints.end(), points, points + 3);
 	}
 
+	// otherwise, a (for us) unsupported command, which is ignored
 	return true;
 }
 
 
 
 std::shared_ptr<MeshObject> ObjectLoader::createTriMeshObject(std::string const& filePath, bool const ignoreUVS, bool const ignoreNormals) {
+	// binary formats are already (close to) what OpenGL wants, so they are read straight into the MeshObject (and never cached)...
+	if (hasExtension(filePath, "ply")) {
+		std::vector<glm::vec3> drawVerts;
+		std::vector<glm::vec2> uvs;
+		std::vector<glm::vec3> normals;
+		std::vector<GLuint> drawFaces;
+		if (!loadTriMeshPLY(filePath, drawVerts, uvs, normals, drawFaces)) return nullptr;
+
+		if (ignoreUVS) uvs.clear();
+		if (ignoreNormals) normals.clear();
+		return makeTriMeshObject(std::move(drawVerts), std::move(uvs), std::move(normals), std::move(drawFaces));
+	}
+	if (hasExtension(filePath, "stl")) {
+		std::vector<glm::vec3> drawVerts;
+		std::vector<GLuint> drawFaces;
+		if (!loadTriMeshSTL(filePath, drawVerts, drawFaces)) return nullptr;
+
+		return makeTriMeshObject(std::move(drawVerts), std::vector<glm::vec2>(), std::vector<glm::vec3>(), std::move(drawFaces));
+	}
+
+	// the binary cache next to the obj skips all of the parsing below (see MeshCache)...
+	std::shared_ptr<MeshObject> cachedMesh = MeshCache::load(filePath, ignoreUVS, ignoreNormals);
+	if (nullptr != cachedMesh) return cachedMesh;
+
 	std::vector<glm::vec3> parsedVerts;
 	std::vector<glm::vec2> parsedUVs;
 	std::vector<glm::vec3> parsedNormals;
-	std::vector<std::vector<glm::vec3>> parsedFaces;
+	std::vector<glm::ivec3> parsedFacePoints;
 
-	if (!loadTriMeshOBJ(filePath, parsedVerts, parsedUVs, parsedNormals, parsedFaces)) return nullptr; // parsing error
+	if (!loadTriMeshOBJ(filePath, parsedVerts, parsedUVs, parsedNormals, parsedFacePoints)) return nullptr; // parsing error
 
 	//NOTE: guaranteed to have verts and faces by parser (if obj file is valid). UVs and Normals may not be found in file.
 	//NOTE: the parser guarantees that we have a pure tri mesh
 	//NOTE: an obj file with faces that don't specify uvs or normals or both, but the file still contains vt or vn lines is valid (we just have to ignore this extra data provided to us)
 
 	// 1. can look at format of a point (they are all the same format) to figure out what data each face is made up of...
-	glm::vec3 const& firstPoint = parsedFaces.at(0).at(0);
+	glm::ivec3 const& firstPoint = parsedFacePoints.at(0);
 	bool const vtFound = -1 != firstPoint.y;
 	bool const vnFound = -1 != firstPoint.z;
 
@@ -294,111 +420,477 @@ std::shared_ptr<MeshObject> ObjectLoader::createTriMeshObject(std::string const&
 	std::vector<GLuint> drawFaces;
 
 
-	// 4 CASES...
-
 	//NOTE: remember that the parser won't return false if the file has unreferenced data (e.g. a v line whose index is never mentioned in any face) - thus, below we must only add referenced data to meshobject
 	//NOTE: the parser also doesn't check each section for unique data (e.g. are all v lines unique?), but this is assumed in every obj file. - anyway, we we extract unique data anyway
 
-	if (!includeUVs && !includeNormals) { // TRIVIAL CASE (just verts and faces)
+	// every unique (v, vt, vn) tuple becomes 1 draw vert - the parts that aren't included are masked to -1, which covers all 4 cases (v, v/vt, v/vn, v/vt/vn)
+	//NOTE: linear time - each tuple is looked up in a hash map of the tuples seen so far
+	IndexHashMap<glm::ivec3> tupleIndices(parsedVerts.size());
 
-		std::vector<int> vIndices; // stores unique singles
+	for (glm::ivec3 const& p : parsedFacePoints) {
 
-		for (std::vector<glm::vec3> const& f : parsedFaces) {
-			for (glm::vec3 const& p : f) {
+		glm::ivec3 const tuple = glm::ivec3(p.x, includeUVs ? p.y : -1, includeNormals ? p.z : -1);
 
-				int const vIndex = p.x;
+		bool isNew = false;
+		unsigned int const index = tupleIndices.findOrInsert(tuple, (unsigned int)drawVerts.size(), isNew);
+		if (isNew) { // new tuple
+			drawVerts.push_back(parsedVerts.at(tuple.x));
+			if (includeUVs) uvs.push_back(parsedUVs.at(tuple.y));
+			if (includeNormals) normals.push_back(parsedNormals.at(tuple.z));
+		}
+		drawFaces.push_back(index);
+	}
 
-				auto it = std::find(vIndices.begin(), vIndices.end(), vIndex);
-				if (vIndices.end() != it) { // duplicate single
-					unsigned int const index = it - vIndices.begin();
-					drawFaces.push_back(index);
-				} else { // new single
-					vIndices.push_back(vIndex);
-					drawVerts.push_back(parsedVerts.at(vIndex));
-					drawFaces.push_back(vIndices.size() - 1);
-				}
-			}
+	std::shared_ptr<MeshObject> triMesh = makeTriMeshObject(std::move(drawVerts), std::move(uvs), std::move(normals), std::move(drawFaces));
+
+	MeshCache::write(filePath, ignoreUVS, ignoreNormals, *triMesh);
+
+	return triMesh;
+}
+
+
+
+namespace {
+	// PLY scalar types (the old names, e.g. uchar, and the sized ones, e.g. uint8, are interchangeable)
+	enum PLYType {
+		PLY_NONE = 0,
+		PLY_INT8,
+		PLY_UINT8,
+		PLY_INT16,
+		PLY_UINT16,
+		PLY_INT32,
+		PLY_UINT32,
+		PLY_FLOAT32,
+		PLY_FLOAT64,
+	};
+
+	PLYType toPLYType(Token const& token) {
+		static char const* const s_NAMES[][2] = { { "char", "int8" }, { "uchar", "uint8" }, { "short", "int16" }, { "ushort", "uint16" }, { "int", "int32" }, { "uint", "uint32" }, { "float", "float32" }, { "double", "float64" } };
+		for (int t = 0; t < 8; ++t) {
+			if (isExactly(token.m_begin, token.m_end, s_NAMES[t][0]) || isExactly(token.m_begin, token.m_end, s_NAMES[t][1])) return (PLYType)(t + 1);
 		}
+		return PLY_NONE;
+	}
 
-	} else if (includeUVs && !includeNormals) { // verts, uvs and faces
+	size_t getPLYTypeSize(PLYType const type) {
+		static size_t const s_SIZES[] = { 0, 1, 1, 2, 2, 4, 4, 4, 8 };
+		return s_SIZES[type];
+	}
 
-		std::vector<glm::vec2> v_vtIndexPairs; // stores unique pairs
+	//NOTE: every PLY integer fits exactly into a double
+	double readPLYValue(char const* in, PLYType const type, bool const isSwapped) {
+		switch (type) {
+		case PLY_INT8: return ByteOrder::read<int8_t>(in, isSwapped);
+		case PLY_UINT8: return ByteOrder::read<uint8_t>(in, isSwapped);
+		case PLY_INT16: return ByteOrder::read<int16_t>(in, isSwapped);
+		case PLY_UINT16: return ByteOrder::read<uint16_t>(in, isSwapped);
+		case PLY_INT32: return ByteOrder::read<int32_t>(in, isSwapped);
+		case PLY_UINT32: return ByteOrder::read<uint32_t>(in, isSwapped);
+		case PLY_FLOAT32: return ByteOrder::read<float>(in, isSwapped);
+		case PLY_FLOAT64: return ByteOrder::read<double>(in, isSwapped);
+		default: return 0.0;
+		}
+	}
 
-		for (std::vector<glm::vec3> const& f : parsedFaces) {
-			for (glm::vec3 const& p : f) {
+	struct PLYProperty {
+		std::string m_name;
+		PLYType m_type = PLY_NONE; // for lists, the type of the items
+		PLYType m_countType = PLY_NONE; // only lists have a count
+		size_t m_offset = 0; // bytes from the start of the record (only for elements without lists)
+	};
+
+	struct PLYElement {
+		std::string m_name;
+		size_t m_count = 0;
+		std::vector<PLYProperty> m_properties;
+		bool m_hasLists = false;
+		size_t m_recordSize = 0; // bytes (only for elements without lists)
+
+		// RETURNS -1 if there is no such property
+		int findProperty(char const* name) const {
+			for (size_t p = 0; p < m_properties.size(); ++p) {
+				if (m_properties[p].m_name == name) return (int)p;
+			}
+			return -1;
+		}
+
+		// RETURNS the end of the record starting at in, nullptr if it runs past end
+		char const* skipRecord(char const* in, char const* const end, bool const isSwapped) const;
+	};
+
+	// RETURNS the end of the property (value or whole list) starting at in, nullptr if it runs past end
+	char const* skipPLYProperty(char const* in, char const* const end, PLYProperty const& property, bool const isSwapped) {
+		size_t itemCount = 1;
+		if (PLY_NONE != property.m_countType) {
+			size_t const countSize = getPLYTypeSize(property.m_countType);
+			if ((size_t)(end - in) < countSize) return nullptr;
+			double const count = readPLYValue(in, property.m_countType, isSwapped);
+			if (count < 0.0) return nullptr;
+			itemCount = (size_t)count;
+			in += countSize;
+		}
+		size_t const size = itemCount * getPLYTypeSize(property.m_type);
+		if ((size_t)(end - in) < size) return nullptr;
+		return in + size;
+	}
 
-				glm::vec2 const pair = glm::vec2(p.x, p.y);
+	char const* PLYElement::skipRecord(char const* in, char const* const end, bool const isSwapped) const {
+		if (!m_hasLists) return ((size_t)(end - in) < m_recordSize) ? nullptr : in + m_recordSize;
 
-				auto it = std::find(v_vtIndexPairs.begin(), v_vtIndexPairs.end(), pair);
-				if (v_vtIndexPairs.end() != it) { // duplicate pair
-					unsigned int const index = it - v_vtIndexPairs.begin();
-					drawFaces.push_back(index);
-				} else { // new pair
-					v_vtIndexPairs.push_back(pair);
-					drawVerts.push_back(parsedVerts.at(pair.x));
-					uvs.push_back(parsedUVs.at(pair.y));
-					drawFaces.push_back(v_vtIndexPairs.size() - 1);
+		for (PLYProperty const& property : m_properties) {
+			in = skipPLYProperty(in, end, property, isSwapped);
+			if (nullptr == in) return nullptr;
+		}
+		return in;
+	}
+
+	struct PLYHeader {
+		bool m_isLittleEndian = true;
+		std::vector<PLYElement> m_elements;
+	};
+
+	// RETURNS the start of the data (right after the end_header line), nullptr if the header is invalid (or not binary)
+	// reference: http://paulbourke.net/dataformats/ply/
+	char const* parsePLYHeader(char const* begin, char const* const end, std::string const& filePath, PLYHeader &out_header) {
+		bool isFormatFound = false;
+		size_t lineCount = 0;
+
+		char const* lineBegin = begin;
+		while (lineBegin < end) {
+			char const* const lineBreak = (char const*)std::memchr(lineBegin, '\n', end - lineBegin);
+			if (nullptr == lineBreak) break; // the header has to end with an end_header line
+			char const* lineEnd = lineBreak;
+			while (lineBegin < lineEnd && TextParsing::isSpace(*(lineEnd - 1))) --lineEnd; // \r\n line breaks
+			++lineCount;
+
+			Token words[6]; // 1 more than any supported line has
+			unsigned int const wordCount = splitOnBlanks(lineBegin, lineEnd, words, 6);
+
+			if (1 == lineCount) {
+				if (1 != wordCount || !isExactly(words[0].m_begin, words[0].m_end, "ply")) return nullptr; // not a ply file
+			} else if (0 == wordCount || isExactly(words[0].m_begin, words[0].m_end, "comment") || isExactly(words[0].m_begin, words[0].m_end, "obj_info")) {
+				// nothing to do
+			} else if (isExactly(words[0].m_begin, words[0].m_end, "end_header")) {
+				if (isFormatFound) return lineBreak + 1;
+				break;
+			} else if (isExactly(words[0].m_begin, words[0].m_end, "format") && 3 == wordCount) {
+				if (isExactly(words[1].m_begin, words[1].m_end, "ascii")) {
+					std::cout << "ERROR (ObjectLoader.cpp) - ascii PLY is not supported (only binary) in " << filePath << std::endl;
+					return nullptr;
+				}
+				if (isExactly(words[1].m_begin, words[1].m_end, "binary_little_endian")) out_header.m_isLittleEndian = true;
+				else if (isExactly(words[1].m_begin, words[1].m_end, "binary_big_endian")) out_header.m_isLittleEndian = false;
+				else break;
+				isFormatFound = true;
+			} else if (isExactly(words[0].m_begin, words[0].m_end, "element") && 3 == wordCount) {
+				PLYElement element;
+				element.m_name.assign(words[1].m_begin, words[1].m_end);
+				if (std::from_chars(words[2].m_begin, words[2].m_end, element.m_count).ptr != words[2].m_end) break;
+				out_header.m_elements.push_back(element);
+			} else if (isExactly(words[0].m_begin, words[0].m_end, "property") && !out_header.m_elements.empty() && (3 == wordCount || 5 == wordCount)) {
+				PLYElement &element = out_header.m_elements.back();
+				PLYProperty property;
+				if (3 == wordCount) {
+					property.m_type = toPLYType(words[1]);
+					property.m_offset = element.m_recordSize;
+				} else {
+					if (!isExactly(words[1].m_begin, words[1].m_end, "list")) break;
+					property.m_countType = toPLYType(words[2]);
+					property.m_type = toPLYType(words[3]);
+					if (PLY_NONE == property.m_countType || PLY_FLOAT32 == property.m_countType || PLY_FLOAT64 == property.m_countType) break;
+					element.m_hasLists = true;
 				}
+				if (PLY_NONE == property.m_type) break;
+				property.m_name.assign(words[wordCount - 1].m_begin, words[wordCount - 1].m_end);
+				element.m_recordSize += getPLYTypeSize(property.m_type); //NOTE: meaningless once the element has a list
+				element.m_properties.push_back(property);
+			} else break;
+
+			lineBegin = lineBreak + 1;
+		}
+
+		std::cout << "ERROR (ObjectLoader.cpp) - invalid PLY header (line " << lineCount << ") in " << filePath << std::endl;
+		return nullptr;
+	}
+
+	// copies 1 attribute (made of the properties in propertyIndices) out of every vertex record
+	//NOTE: float components right after each other in native byte order (by far the most common case) get copied as is - with a single bulk copy if the record is nothing but the attribute
+	template <typename Vec>
+	void readPLYAttribute(char const* records, PLYElement const& element, int const* propertyIndices, bool const isSwapped, std::vector<Vec> &out_values) {
+		out_values.resize(element.m_count);
+
+		PLYProperty const* components[4];
+		bool isPacked = !isSwapped;
+		for (int c = 0; c < Vec::length(); ++c) {
+			components[c] = &element.m_properties[propertyIndices[c]];
+			isPacked = isPacked && PLY_FLOAT32 == components[c]->m_type && components[0]->m_offset + c * sizeof(float) == components[c]->m_offset;
+		}
+
+		if (isPacked && sizeof(Vec) == element.m_recordSize) {
+			if (0 != element.m_count) std::memcpy(out_values.data(), records, element.m_count * sizeof(Vec));
+			return;
+		}
+
+		ParallelTools::parallelFor(element.m_count, [&](size_t const i) {
+			char const* record = records + i * element.m_recordSize;
+			if (isPacked) {
+				std::memcpy(&out_values[i], record + components[0]->m_offset, sizeof(Vec));
+			} else {
+				for (int c = 0; c < Vec::length(); ++c) out_values[i][c] = (float)readPLYValue(record + components[c]->m_offset, components[c]->m_type, isSwapped);
 			}
+		}, 4096);
+	}
+
+	// RETURNS true if element has all of the properties names (and their indices in out_propertyIndices)
+	bool findPLYProperties(PLYElement const& element, std::initializer_list<char const*> const names, int *out_propertyIndices) {
+		for (char const* name : names) {
+			*out_propertyIndices = element.findProperty(name);
+			if (-1 == *out_propertyIndices++) return false;
 		}
+		return true;
+	}
+
+	// RETURNS the end of the vertex data, nullptr if it is invalid
+	char const* readPLYVerts(char const* in, char const* const end, PLYElement const& element, bool const isSwapped, std::vector<glm::vec3> &out_verts, std::vector<glm::vec2> &out_uvs, std::vector<glm::vec3> &out_normals) {
+		int positionIndices[3];
+		if (element.m_hasLists || !findPLYProperties(element, { "x", "y", "z" }, positionIndices)) return nullptr;
+		if (element.m_count > (size_t)(end - in) / element.m_recordSize) return nullptr; // not enough data
 
-	} else if (!includeUVs && includeNormals) { // verts, normals and faces
+		readPLYAttribute(in, element, positionIndices, isSwapped, out_verts);
 
-		std::vector<glm::vec2> v_vnIndexPairs; // stores unique pairs
+		int normalIndices[3];
+		if (findPLYProperties(element, { "nx", "ny", "nz" }, normalIndices)) readPLYAttribute(in, element, normalIndices, isSwapped, out_normals);
 
-		for (std::vector<glm::vec3> const& f : parsedFaces) {
-			for (glm::vec3 const& p : f) {
+		// there is no standard name for texture coords, these are the ones written by the common tools
+		int uvIndices[2];
+		if (findPLYProperties(element, { "u", "v" }, uvIndices) || findPLYProperties(element, { "s", "t" }, uvIndices) || findPLYProperties(element, { "texture_u", "texture_v" }, uvIndices) || findPLYProperties(element, { "texture_s", "texture_t" }, uvIndices)) {
+			readPLYAttribute(in, element, uvIndices, isSwapped, out_uvs);
+			for (glm::vec2 &uv : out_uvs) uv.y *= -1; //NOTE: same v flip as for the vt lines of an obj
+		}
 
-				glm::vec2 const pair = glm::vec2(p.x, p.z);
+		return in + element.m_count * element.m_recordSize;
+	}
 
-				auto it = std::find(v_vnIndexPairs.begin(), v_vnIndexPairs.end(), pair);
-				if (v_vnIndexPairs.end() != it) { // duplicate pair
-					unsigned int const index = it - v_vnIndexPairs.begin();
-					drawFaces.push_back(index);
-				} else { // new pair
-					v_vnIndexPairs.push_back(pair);
-					drawVerts.push_back(parsedVerts.at(pair.x));
-					normals.push_back(parsedNormals.at(pair.y));
-					drawFaces.push_back(v_vnIndexPairs.size() - 1);
+	// RETURNS the end of the face data, nullptr if it is invalid (incl. any face that isn't a triangle)
+	//NOTE: indices are only checked for being representable, not against the vertex count
+	char const* readPLYFaces(char const* in, char const* const end, PLYElement const& element, bool const isSwapped, std::vector<GLuint> &out_faces) {
+		int indicesIndex = element.findProperty("vertex_indices");
+		if (-1 == indicesIndex) indicesIndex = element.findProperty("vertex_index");
+		if (-1 == indicesIndex) return nullptr;
+
+		PLYProperty const& indices = element.m_properties[indicesIndex];
+		if (PLY_NONE == indices.m_countType || PLY_FLOAT32 == indices.m_type || PLY_FLOAT64 == indices.m_type) return nullptr;
+
+		size_t const countSize = getPLYTypeSize(indices.m_countType);
+		size_t const indexSize = getPLYTypeSize(indices.m_type);
+
+		out_faces.resize(3 * element.m_count);
+		auto readTriangle = [&](char const* list, size_t const f) {
+			if (3.0 != readPLYValue(list, indices.m_countType, isSwapped)) return false;
+			for (size_t corner = 0; corner < 3; ++corner) {
+				double const index = readPLYValue(list + countSize + corner * indexSize, indices.m_type, isSwapped);
+				out_faces[3 * f + corner] = (index >= 0.0 && index < 4294967295.0) ? (GLuint)index : 0xFFFFFFFF; // out of range either way
+			}
+			return true;
+		};
+
+		// 1. faces that are nothing but the index list are fixed size records as long as every face is a triangle - read in parallel...
+		//NOTE: all faces before the first non-triangle are where they'd be expected, so that first non-triangle is always caught
+		if (1 == element.m_properties.size()) {
+			size_t const recordSize = countSize + 3 * indexSize;
+			if (element.m_count > (size_t)(end - in) / recordSize) return nullptr; // not enough data (or not all triangles)
+
+			std::vector<unsigned char> isRangeValid(ParallelTools::getThreadCount(), 1);
+			ParallelTools::parallelForRange(element.m_count, [&](size_t const begin, size_t const rangeEnd, unsigned int const threadIndex) {
+				for (size_t f = begin; f < rangeEnd; ++f) {
+					if (!readTriangle(in + f * recordSize, f)) {
+						isRangeValid[threadIndex] = 0;
+						return;
+					}
 				}
+			}, 4096);
+			for (unsigned char const isValid : isRangeValid) {
+				if (!isValid) return nullptr;
 			}
+			return in + element.m_count * recordSize;
 		}
 
-	} else { // verts, uvs, normals and faces
+		// 2. ...otherwise walk the records (e.g. faces with a colour)
+		for (size_t f = 0; f < element.m_count; ++f) {
+			for (size_t p = 0; p < element.m_properties.size(); ++p) {
+				if ((int)p == indicesIndex && ((size_t)(end - in) < countSize + 3 * indexSize || !readTriangle(in, f))) return nullptr;
+				in = skipPLYProperty(in, end, element.m_properties[p], isSwapped);
+				if (nullptr == in) return nullptr;
+			}
+		}
+		return in;
+	}
+}
 
-		std::vector<glm::vec3> v_vt_vnIndexTriples; // stores unique triples
 
-		for (std::vector<glm::vec3> const& f : parsedFaces) {
-			for (glm::vec3 const& p : f) {
+// reference: http://paulbourke.net/dataformats/ply/
+//NOTE: only the vertex and face elements are read, any other element (e.g. edges) is skipped
+bool ObjectLoader::loadTriMeshPLY(std::string const& filePath, std::vector<glm::vec3> &out_verts, std::vector<glm::vec2> &out_uvs, std::vector<glm::vec3> &out_normals, std::vector<GLuint> &out_faces) {
+	if (!hasExtension(filePath, "ply")) return false;
 
-				glm::vec3 const triple = p;
+	out_verts.clear();
+	out_uvs.clear();
+	out_normals.clear();
+	out_faces.clear();
+
+	MappedFile file;
+	if (!file.open(filePath)) return false;
+	char const* const fileEnd = file.getData() + file.getSize();
+
+	PLYHeader header;
+	char const* in = parsePLYHeader(file.getData(), fileEnd, filePath, header);
+	if (nullptr == in) return false;
+	bool const isSwapped = header.m_isLittleEndian != ByteOrder::isHostLittleEndian();
+
+	// the elements are stored 1 after the other, in header order
+	bool isVertexElementRead = false;
+	bool isFaceElementRead = false;
+	for (PLYElement const& element : header.m_elements) {
+		if ("vertex" == element.m_name && !isVertexElementRead) {
+			in = readPLYVerts(in, fileEnd, element, isSwapped, out_verts, out_uvs, out_normals);
+			isVertexElementRead = true;
+		} else if ("face" == element.m_name && !isFaceElementRead) {
+			in = readPLYFaces(in, fileEnd, element, isSwapped, out_faces);
+			isFaceElementRead = true;
+		} else if (!element.m_hasLists) {
+			in = (element.m_count > (size_t)(fileEnd - in) / std::max<size_t>(element.m_recordSize, 1)) ? nullptr : in + element.m_count * element.m_recordSize;
+		} else {
+			for (size_t r = 0; r < element.m_count && nullptr != in; ++r) in = element.skipRecord(in, fileEnd, isSwapped);
+		}
+
+		if (nullptr == in) {
+			std::cout << "ERROR (ObjectLoader.cpp) - invalid " << element.m_name << " data" << (("face" == element.m_name) ? " (faces have to be triangles)" : "") << " in " << filePath << std::endl;
+			return false;
+		}
+		if (isVertexElementRead && isFaceElementRead) break; // nothing after them is needed
+	}
+
+	//NOTE: file must have contained verts and faces
+	if (out_verts.size() == 0 || out_faces.size() == 0) {
+		std::cout << "ERROR (ObjectLoader.cpp) - no verts or no faces in " << filePath << std::endl;
+		return false;
+	}
 
-				auto it = std::find(v_vt_vnIndexTriples.begin(), v_vt_vnIndexTriples.end(), triple);
-				if (v_vt_vnIndexTriples.end() != it) { // duplicate triple
-					unsigned int const index = it - v_vt_vnIndexTriples.begin();
-					drawFaces.push_back(index);
-				} else { // new triple
-					v_vt_vnIndexTriples.push_back(triple);
-					drawVerts.push_back(parsedVerts.at(triple.x));
-					uvs.push_back(parsedUVs.at(triple.y));
-					normals.push_back(parsedNormals.at(triple.z));
-					drawFaces.push_back(v_vt_vnIndexTriples.size() - 1);
+	for (GLuint const index : out_faces) {
+		if (index >= out_verts.size()) {
+			std::cout << "ERROR (ObjectLoader.cpp) - face index out of range in " << filePath << std::endl;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+//NOTE: any element before the vertex element is skipped (nothing after it is looked at)
+bool ObjectLoader::findPLYVertexLayout(char const* data, size_t const size, std::string const& filePath, PLYVertexLayout &out_layout) {
+	char const* const end = data + size;
+
+	PLYHeader header;
+	char const* in = parsePLYHeader(data, end, filePath, header);
+	if (nullptr == in) return false;
+	bool const isSwapped = header.m_isLittleEndian != ByteOrder::isHostLittleEndian();
+
+	for (PLYElement const& element : header.m_elements) {
+		if ("vertex" == element.m_name) {
+			int positionIndices[3];
+			if (element.m_hasLists || !findPLYProperties(element, { "x", "y", "z" }, positionIndices)) break;
+			for (int c = 0; c < 3; ++c) {
+				if (PLY_FLOAT32 != element.m_properties[positionIndices[c]].m_type) {
+					std::cout << "ERROR (ObjectLoader.cpp) - vertex positions have to be floats in " << filePath << std::endl;
+					return false;
 				}
+				out_layout.m_positionOffsets[c] = element.m_properties[positionIndices[c]].m_offset;
 			}
+			if (element.m_count > (size_t)(end - in) / element.m_recordSize) break; // not enough data
+
+			out_layout.m_dataOffset = (size_t)(in - data);
+			out_layout.m_vertCount = element.m_count;
+			out_layout.m_recordSize = element.m_recordSize;
+			out_layout.m_isSwapped = isSwapped;
+			return true;
 		}
 
+		for (size_t r = 0; r < element.m_count && nullptr != in; ++r) in = element.skipRecord(in, end, isSwapped);
+		if (nullptr == in) break;
+	}
+
+	std::cout << "ERROR (ObjectLoader.cpp) - no valid vertex data in " << filePath << std::endl;
+	return false;
+}
+
+
+// binary STL: 80 byte header, triangle count (uint32), then 50 bytes per triangle - normal, 3 corners (all float32 xyz) and a uint16 attribute
+// reference: https://en.wikipedia.org/wiki/STL_(file_format)
+//NOTE: the file normals are ignored (the normals get generated anyway)
+bool ObjectLoader::loadTriMeshSTL(std::string const& filePath, std::vector<glm::vec3> &out_verts, std::vector<GLuint> &out_faces) {
+	if (!hasExtension(filePath, "stl")) return false;
+
+	out_verts.clear();
+	out_faces.clear();
+
+	MappedFile file;
+	if (!file.open(filePath)) return false;
+
+	size_t const headerSize = 84;
+	size_t const triangleSize = 50;
+	bool const isSwapped = !ByteOrder::isHostLittleEndian(); // STL is always little endian
+
+	char const* const data = file.getData();
+	size_t const triangleCount = (file.getSize() < headerSize) ? 0 : ByteOrder::read<uint32_t>(data + 80, isSwapped);
+	if (file.getSize() < headerSize || (file.getSize() - headerSize) / triangleSize < triangleCount) {
+		bool const isASCII = file.getSize() >= 5 && 0 == std::memcmp(data, "solid", 5);
+		std::cout << "ERROR (ObjectLoader.cpp) - " << (isASCII ? "ascii STL is not supported (only binary)" : "truncated STL file") << " in " << filePath << std::endl;
+		return false;
+	}
+	if (0 == triangleCount) {
+		std::cout << "ERROR (ObjectLoader.cpp) - no faces in " << filePath << std::endl;
+		return false;
+	}
+
+	// 1. copy out the corners of every triangle (in parallel)...
+	std::vector<glm::vec3> corners(3 * triangleCount);
+	ParallelTools::parallelFor(triangleCount, [&](size_t const t) {
+		char const* const triangleCorners = data + headerSize + t * triangleSize + sizeof(glm::vec3); // skip the normal
+		if (!isSwapped) {
+			std::memcpy(&corners[3 * t], triangleCorners, 3 * sizeof(glm::vec3));
+		} else {
+			for (size_t c = 0; c < 9; ++c) corners[3 * t + c / 3][c % 3] = ByteOrder::read<float>(triangleCorners + c * sizeof(float), true);
+		}
+	}, 4096);
+
+	// 2. ...then weld corners with the exact same position into 1 vert (STL triangles don't share verts)
+	//NOTE: linear time - each position is looked up in a hash map over its float bits (-0 is folded into +0, so equal positions always match)
+	out_faces.resize(corners.size());
+	IndexHashMap<glm::uvec3> vertIndices(triangleCount / 2 + 1); // a closed tri mesh has about half as many verts as faces
+	for (size_t c = 0; c < corners.size(); ++c) {
+		glm::vec3 const position = corners[c] + glm::vec3(0.0f, 0.0f, 0.0f);
+		glm::uvec3 key;
+		std::memcpy(&key.x, &position.x, sizeof(key));
+
+		bool isNew = false;
+		out_faces[c] = vertIndices.findOrInsert(key, (unsigned int)out_verts.size(), isNew);
+		if (isNew) out_verts.push_back(corners[c]);
 	}
 
+	return true;
+}
+
+
+std::shared_ptr<MeshObject> ObjectLoader::makeTriMeshObject(std::vector<glm::vec3> &&drawVerts, std::vector<glm::vec2> &&uvs, std::vector<glm::vec3> &&normals, std::vector<GLuint> &&drawFaces) {
 	std::shared_ptr<MeshObject> triMesh = std::make_shared<MeshObject>();
-	triMesh->drawVerts = drawVerts;
-	triMesh->uvs = uvs;
-	triMesh->normals = normals;
-	triMesh->drawFaces = drawFaces;
+	triMesh->drawVerts = std::move(drawVerts);
+	triMesh->uvs = std::move(uvs);
+	triMesh->normals = std::move(normals);
+	triMesh->drawFaces = std::move(drawFaces);
 
 	// init vert colours (uniform light grey for now)
-	for (unsigned int i = 0; i < triMesh->drawVerts.size(); ++i) {
-		triMesh->colours.push_back(glm::vec3(0.8f, 0.8f, 0.8f));
-	}
+	triMesh->colours.assign(triMesh->drawVerts.size(), glm::vec3(0.8f, 0.8f, 0.8f));
 
 	if (triMesh->uvs.size() > 0) triMesh->hasTexture = true; //TODO: probably gonna remove this hasTexture field later on
 
@@ -21,6 +21,15 @@ struct PackedVertex {
 };
 */
 
+// where the vertex records of a binary PLY are in the file, so they can be streamed (see StreamingDeformer) instead of loaded
+struct PLYVertexLayout {
+	size_t m_dataOffset = 0; // bytes from the start of the file to the first vertex record
+	size_t m_vertCount = 0;
+	size_t m_recordSize = 0; // bytes
+	size_t m_positionOffsets[3] = {}; // bytes from the start of a record to the x, y and z float
+	bool m_isSwapped = false; // not in host byte order
+};
+
 class ObjectLoader {
 
 public:
@@ -28,13 +37,34 @@ public:
 	// newer better loader that should be used
 	//NOTE: will return indices starting from 0 (not 1 like obj format)
 	//NOTE: assumes that all faces are triangles, otherwise returns false
-	static bool loadTriMeshOBJ(std::string const& filePath, std::vector<glm::vec3> &out_verts, std::vector<glm::vec2> &out_uvs, std::vector<glm::vec3> &out_normals, std::vector<std::vector<glm::vec3>> &out_faces);
+	//NOTE: out_facePoints holds 3 points in a row per face, each point is (vIndex, vtIndex, vnIndex) with -1 for a missing index
+	static bool loadTriMeshOBJ(std::string const& filePath, std::vector<glm::vec3> &out_verts, std::vector<glm::vec2> &out_uvs, std::vector<glm::vec3> &out_normals, std::vector<glm::ivec3> &out_facePoints);
 	
+	// binary PLY (little or big endian) - every vertex becomes 1 draw vert as is (PLY is already single-indexed, like OpenGL)
+	//NOTE: out_uvs/out_normals stay empty if the vertex element doesn't have them (u/v, s/t or texture_u/texture_v and nx/ny/nz)
+	//NOTE: assumes that all faces are triangles, otherwise returns false
+	static bool loadTriMeshPLY(std::string const& filePath, std::vector<glm::vec3> &out_verts, std::vector<glm::vec2> &out_uvs, std::vector<glm::vec3> &out_normals, std::vector<GLuint> &out_faces);
+
+	// finds the vertex records of the binary PLY in [data, data + size) without reading them
+	// RETURNS false if the header is invalid, the vertex records are incomplete or the positions aren't floats
+	static bool findPLYVertexLayout(char const* data, size_t const size, std::string const& filePath, PLYVertexLayout &out_layout);
+
+	// binary STL - the (unconnected) triangle corners are welded by position, so the mesh comes out connected
+	static bool loadTriMeshSTL(std::string const& filePath, std::vector<glm::vec3> &out_verts, std::vector<GLuint> &out_faces);
+
+	// picks the loader by the extension of filePath (.obj, .ply or .stl, case-insensitive)
 	static std::shared_ptr<MeshObject> createTriMeshObject(std::string const& filePath, bool const ignoreUVS = false, bool const ignoreNormals = false);
 
 	//static std::shared_ptr<MeshObject> createMeshObject(std::string modelFile);
 
 private:
+	// MeshObject with light grey vert colours
+	static std::shared_ptr<MeshObject> makeTriMeshObject(std::vector<glm::vec3> &&drawVerts, std::vector<glm::vec2> &&uvs, std::vector<glm::vec3> &&normals, std::vector<GLuint> &&drawFaces);
+
+	// parses every line in [begin, end) (which has to start at the beginning of a line)
+	// RETURNS false at the first invalid line, out_lineCount is the number of lines before it (or all lines if it returns true)
+	static bool parseOBJLines(char const* begin, char const* const end, std::vector<glm::vec3> &out_verts, std::vector<glm::vec2> &out_uvs, std::vector<glm::vec3> &out_normals, std::vector<glm::ivec3> &out_facePoints, size_t &out_lineCount);
+	static bool parseOBJLine(char const* lineBegin, char const* lineEnd, std::vector<glm::vec3> &out_verts, std::vector<glm::vec2> &out_uvs, std::vector<glm::vec3> &out_normals, std::vector<glm::ivec3> &out_facePoints);
 
 /*
 	static bool getSimilarVertexIndex_fast(
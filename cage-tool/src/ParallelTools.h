@@ -0,0 +1,61 @@
+#pragma once
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+// small helpers for splitting data-parallel loops across the hardware threads (no external dependencies)
+class ParallelTools {
+
+public:
+	// number of worker threads to split work over (always >= 1)
+	static unsigned int getThreadCount() {
+		unsigned int const hw = std::thread::hardware_concurrency();
+		return 0 == hw ? 1 : hw;
+	}
+
+	//NOTE: splits [0, count) into contiguous ranges and calls func(begin, end, threadIndex) once per range
+	//NOTE: threadIndex is in [0, getThreadCount()) so callers can index their own per-thread scratch buffers
+	//NOTE: ranges smaller than minRangeSize are not split any further (small inputs just run on the calling thread)
+	template <typename Func>
+	static void parallelForRange(size_t const count, Func const& func, size_t const minRangeSize = 1024) {
+		if (0 == count) return;
+
+		size_t const threadCount = minOf<size_t>(getThreadCount(), (count + minRangeSize - 1) / maxOf<size_t>(minRangeSize, 1));
+		if (threadCount <= 1) {
+			func(size_t(0), count, 0u);
+			return;
+		}
+
+		size_t const rangeSize = (count + threadCount - 1) / threadCount;
+
+		std::vector<std::thread> workers;
+		workers.reserve(threadCount - 1);
+		for (size_t t = 1; t < threadCount; ++t) {
+			size_t const begin = t * rangeSize;
+			size_t const end = minOf(count, begin + rangeSize);
+			if (begin >= end) break;
+			workers.emplace_back([&func, begin, end, t]() { func(begin, end, (unsigned int)t); });
+		}
+
+		// calling thread takes the first range
+		func(size_t(0), minOf(count, rangeSize), 0u);
+
+		for (std::thread &worker : workers) worker.join();
+	}
+
+	// calls func(i) for every i in [0, count)
+	template <typename Func>
+	static void parallelFor(size_t const count, Func const& func, size_t const minRangeSize = 1024) {
+		parallelForRange(count, [&func](size_t const begin, size_t const end, unsigned int const) {
+			for (size_t i = begin; i < end; ++i) func(i);
+		}, minRangeSize);
+	}
+
+private:
+	//NOTE: local min/max so that this header doesn't clash with the min/max macros pulled in by windows.h
+	template <typename T>
+	static T minOf(T const a, T const b) { return a < b ? a : b; }
+	template <typename T>
+	static T maxOf(T const a, T const b) { return a < b ? b : a; }
+};
@@ -1,12 +1,31 @@
 #include "Program.h"
 
-#include <Eigen/Dense>
-#include <glm/gtx/norm.hpp>
 #include <glm/gtx/projection.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include "CageWelder.h"
+#include "HalfEdgeMesh.h"
+#include "IndexHashMap.h"
+#include "MeanValueCoordinates.h"
+#include "MeshSimplifier.h"
+#include "OBBTools.h"
+#include "ObjectExporter.h"
+#include "ParallelTools.h"
+#include "SignedDistanceField.h"
+#include "VoxelGrid.h"
+#include "WindingNumber.h"
+
 // STATICS (INIT)...
 glm::vec3 const Program::s_CAGE_UNSELECTED_COLOUR = glm::vec3(0.0f, 0.0f, 0.0f);
 glm::vec3 const Program::s_CAGE_SELECTED_COLOUR = glm::vec3(1.0f, 1.0f, 0.0f);
+glm::vec3 const Program::s_MODEL_COLOUR = glm::vec3(0.8f, 0.8f, 0.8f);
+glm::vec3 const Program::s_MODEL_OUTSIDE_CAGE_COLOUR = glm::vec3(1.0f, 0.0f, 0.0f);
+glm::vec3 const Program::s_MODEL_ON_CAGE_COLOUR = glm::vec3(1.0f, 0.5f, 0.0f);
+unsigned int const Program::s_MAX_DELTA_DEFORMS = 64;
+char const* const Program::s_MESH_FILE_EXTENSIONS[3] = { "obj", "ply", "stl" };
 
 Program::Program() {
 
@@ -185,9 +204,16 @@ void Program::clearModel() {
 	}
 
 	m_model = nullptr;
+	m_modelBVH = BVH();
+	m_isModelHashValid = false;
+
+	// recorded/played frames belong to this model
+	m_animationRecorder.close();
+	m_animationPlayer.close();
+	m_animationFrame = 0;
 
 	// vertWeights have now been invalidated, so clear them
-	m_vertWeights.clear();
+	clearCageWeights();
 }
 
 
@@ -204,63 +230,106 @@ void Program::clearCage() {
 	}
 
 	m_cage = nullptr;
+	m_isCageGenerated = false;
+	m_cagePicker.invalidate();
+	m_cageSelection.reset(0);
 
 	// vertWeights have now been invalidated, so clear them
-	m_vertWeights.clear();
+	clearCageWeights();
 }
 
 
 void Program::loadModel(std::string const& filePath) {
+	if (m_modelLoadJob.isBusy()) return;
 
-	std::shared_ptr<MeshObject> newModel = ObjectLoader::createTriMeshObject(filePath, false, true); // force ignore normals (TODO: generate them ourselves)
-	if (nullptr != newModel) {
-		// remove any old model...
-		clearModel();
+	m_loadedModel = LoadedMesh();
+	m_modelLoadJob.start([this, filePath](BackgroundJob &job) {
+		LoadedMesh &loaded = m_loadedModel;
 
-		// init new model...
-		m_model = newModel;
-		if (m_model->hasTexture) m_model->textureID = renderEngine->loadTexture("textures/default.png"); // apply default texture (if there are uvs)
-		m_model->generateNormals();
-		//m_model->setScale(glm::vec3(0.02f, 0.02f, 0.02f));
-		meshObjects.push_back(m_model);
-		renderEngine->assignBuffers(*m_model);
-	}
-}
+		job.setProgress(0.0f, "reading file");
+		loaded.m_mesh = ObjectLoader::createTriMeshObject(filePath, false, true); // force ignore normals (TODO: generate them ourselves)
+		if (nullptr == loaded.m_mesh) return;
+
+		job.setProgress(0.7f, "generating normals");
+		loaded.m_mesh->generateNormals();
+
+		job.setProgress(0.8f, "building BVH");
+		loaded.m_bvh.build(loaded.m_mesh->drawVerts, loaded.m_mesh->drawFaces); // occluder for cage vert picking
+		loaded.m_hash = computeModelHash(*loaded.m_mesh); // cage generation cache key
 
+		if (loaded.m_mesh->hasTexture) {
+			job.setProgress(0.9f, "decoding texture");
+			RenderEngine::decodeTexture("textures/default.png", loaded.m_textureImage, loaded.m_textureWidth, loaded.m_textureHeight); // default texture (if there are uvs)
+		}
+		job.setProgress(1.0f, "uploading");
+	});
+}
 
 void Program::loadCage(std::string const& filePath) {
+	if (m_cageLoadJob.isBusy()) return;
+
+	m_loadedCage = LoadedMesh();
+	m_cageLoadJob.start([this, filePath](BackgroundJob &job) {
+		LoadedMesh &loaded = m_loadedCage;
+
+		job.setProgress(0.0f, "reading file");
+		loaded.m_mesh = ObjectLoader::createTriMeshObject(filePath, true, true); // force ignore both uvs and normals if present in file
+		if (nullptr == loaded.m_mesh) return;
+
+		// set cage black...
+		for (unsigned int i = 0; i < loaded.m_mesh->colours.size(); ++i) {
+			loaded.m_mesh->colours.at(i) = s_CAGE_UNSELECTED_COLOUR;
+		}
+		job.setProgress(1.0f, "uploading");
+	});
+}
+
+void Program::finishLoading() {
+	if (m_modelLoadJob.finish()) {
+		std::shared_ptr<MeshObject> newModel = m_loadedModel.m_mesh;
+		if (nullptr != newModel) {
+			// remove any old model...
+			clearModel();
 
-	std::shared_ptr<MeshObject> newCage = ObjectLoader::createTriMeshObject(filePath, true, true); // force ignore both uvs and normals if present in file
-	if (nullptr != newCage) {
-		// remove any old cage...
-		clearCage();
-
-		// init new cage...
-		m_cage = newCage;
-
-		// set cage black and also set picking colours...
-		for (unsigned int i = 0; i < m_cage->colours.size(); ++i) {
-			// render colour...
-			m_cage->colours.at(i) = s_CAGE_UNSELECTED_COLOUR;
-
-			// reference: http://www.opengl-tutorial.org/miscellaneous/clicking-on-objects/picking-with-an-opengl-hack/
-			// reference: https://github.com/opengl-tutorials/ogl/blob/master/misc05_picking/misc05_picking_slow_easy.cpp
-			// picking colour...
-			//NOTE: this assumes that this cage will be the only object with picking colours (these colours must be unique)
-			unsigned int const r = (i & 0x000000FF) >> 0;
-			unsigned int const g = (i & 0x0000FF00) >> 8;
-			unsigned int const b = (i & 0x00FF0000) >> 16;
-			m_cage->pickingColours.push_back(glm::vec3(r / 255.0f, g / 255.0f, b / 255.0f));
+			// init new model...
+			m_model = newModel;
+			if (m_model->hasTexture) m_model->textureID = renderEngine->createTexture(m_loadedModel.m_textureImage, m_loadedModel.m_textureWidth, m_loadedModel.m_textureHeight); // apply default texture (if there are uvs)
+			m_modelBVH = std::move(m_loadedModel.m_bvh);
+			m_modelHash = m_loadedModel.m_hash;
+			m_isModelHashValid = true;
+			//m_model->setScale(glm::vec3(0.02f, 0.02f, 0.02f));
+			meshObjects.push_back(m_model);
+			renderEngine->assignBuffers(*m_model);
 		}
-		m_cage->m_polygonMode = PolygonMode::LINE; // set wireframe
-		m_cage->m_renderPoints = true; // hack to render the cage as points as well (2nd polygon mode)
+		m_loadedModel = LoadedMesh();
+	}
+
+	if (m_cageLoadJob.finish()) {
+		std::shared_ptr<MeshObject> newCage = m_loadedCage.m_mesh;
+		if (nullptr != newCage) {
+			// remove any old cage...
+			clearCage();
 
-		//m_cage->setScale(glm::vec3(0.02f, 0.02f, 0.02f));
-		meshObjects.push_back(m_cage);
-		renderEngine->assignBuffers(*m_cage);
+			// init new cage...
+			m_cage = newCage;
+			m_cage->m_polygonMode = PolygonMode::LINE; // set wireframe
+			m_cage->m_renderPoints = true; // hack to render the cage as points as well (2nd polygon mode)
+			m_cageSelection.reset(m_cage->drawVerts.size());
+
+			//m_cage->setScale(glm::vec3(0.02f, 0.02f, 0.02f));
+			meshObjects.push_back(m_cage);
+			renderEngine->assignBuffers(*m_cage);
+		}
+		m_loadedCage = LoadedMesh();
 	}
 }
 
+// progress bar of a load job, with the step it is at written over it
+void Program::drawLoadingProgress(char const* label, BackgroundJob const& job) {
+	ImGui::Text("%s", label);
+	ImGui::ProgressBar(job.getProgress(), ImVec2(200.0f, 0.0f), job.getStep());
+}
+
 
 void Program::drawUI() {
 	// Start the Dear ImGui frame
@@ -368,12 +437,14 @@ void Program::drawUI() {
 
 			ImGui::Text("tip: if you wish to modify cage vert positions, clear the cage weights, right click any cage verts and use keys to translate them");
 			ImGui::Text("otherwise, compute cage weights and then deform model as usual");
+			ImGui::Text("right drag selects a box of cage verts (SHIFT: lasso instead, CTRL: unselect instead)");
 
 			if (ImGui::Button("SELECT ALL VERTS")) selectCageVerts(0, m_cage->colours.size());
 			ImGui::SameLine();
 			if (ImGui::Button("UNSELECT ALL VERTS")) unselectCageVerts(0, m_cage->colours.size());
 			ImGui::SameLine();
 			if (ImGui::Button("TOGGLE ALL VERTS")) toggleCageVerts(0, m_cage->colours.size());
+			ImGui::Checkbox("box/lasso selection ignores cage verts hidden behind the model", &m_ignoreHiddenCageVerts);
 
 			ImGui::PushItemWidth(200.0f);
 
@@ -435,13 +506,21 @@ void Program::drawUI() {
 		if (nullptr != m_model && nullptr != m_cage) {
 			if (m_vertWeights.empty()) {
 				if (ImGui::Button("COMPUTE CAGE WEIGHTS")) computeCageWeights();
+				ImGui::SameLine();
+				if (ImGui::Button("VALIDATE CAGE")) validateCageEnclosure();
 			}
 			else {
-				if (ImGui::Button("CLEAR CAGE WEIGHTS")) m_vertWeights.clear();
+				if (ImGui::Button("CLEAR CAGE WEIGHTS")) clearCageWeights();
+				drawPoseExportUI();
 			}
 			ImGui::Separator();
 		}
 
+		if (nullptr != m_model) {
+			drawAnimationCacheUI();
+			ImGui::Separator();
+		}
+
 		if (nullptr != m_model) {
 			if (ImGui::Button("CLEAR MODEL")) clearModel();
 
@@ -451,21 +530,27 @@ void Program::drawUI() {
 			char filename[maxFileNameLength] = "";
 			ImGuiInputTextFlags const flags = ImGuiInputTextFlags_EnterReturnsTrue;
 			ImGui::Text("EXPORT MODEL");
+			drawMeshFileFormatCombo("##exportModelFormat", m_exportFormat);
+			std::string const extension = std::string(".") + s_MESH_FILE_EXTENSIONS[m_exportFormat];
 			ImGui::Text(".../models/exports/");
 			ImGui::SameLine();
-			if (ImGui::InputText(".obj##2", filename, IM_ARRAYSIZE(filename), flags)) {
-				exportModelOBJ("models/exports/" + std::string(filename) + ".obj");
+			if (ImGui::InputText((extension + "##2").c_str(), filename, IM_ARRAYSIZE(filename), flags)) {
+				exportModel("models/exports/" + std::string(filename) + extension);
 			}
+		} else if (m_modelLoadJob.isBusy()) {
+			drawLoadingProgress("LOADING MODEL", m_modelLoadJob);
 		} else {
 			//NOTE: it seems that imgui only allows typing in the text box upto maxFileNameLength - 1 chars.
 			unsigned int const maxFileNameLength = 256;
 			char filename[maxFileNameLength] = "";
 			ImGuiInputTextFlags const flags = ImGuiInputTextFlags_EnterReturnsTrue;
 			ImGui::Text("LOAD MODEL");
+			drawMeshFileFormatCombo("##loadModelFormat", m_importFormat);
+			std::string const extension = std::string(".") + s_MESH_FILE_EXTENSIONS[m_importFormat];
 			ImGui::Text(".../models/imports/");
 			ImGui::SameLine();
-			if (ImGui::InputText(".obj##0", filename, IM_ARRAYSIZE(filename), flags)) {
-				loadModel("models/imports/" + std::string(filename) + ".obj");
+			if (ImGui::InputText((extension + "##0").c_str(), filename, IM_ARRAYSIZE(filename), flags)) {
+				loadModel("models/imports/" + std::string(filename) + extension);
 			}
 		}
 		ImGui::Separator();
@@ -479,43 +564,35 @@ void Program::drawUI() {
 			char filename[maxFileNameLength] = "";
 			ImGuiInputTextFlags const flags = ImGuiInputTextFlags_EnterReturnsTrue;
 			ImGui::Text("EXPORT CAGE");
+			drawMeshFileFormatCombo("##exportCageFormat", m_exportFormat);
+			std::string const extension = std::string(".") + s_MESH_FILE_EXTENSIONS[m_exportFormat];
 			ImGui::Text(".../models/exports/");
 			ImGui::SameLine();
-			if (ImGui::InputText(".obj##3", filename, IM_ARRAYSIZE(filename), flags)) {
-				exportCageOBJ("models/exports/" + std::string(filename) + ".obj");
+			if (ImGui::InputText((extension + "##3").c_str(), filename, IM_ARRAYSIZE(filename), flags)) {
+				exportCage("models/exports/" + std::string(filename) + extension);
 			}
-		} else {
-			if (nullptr != m_model) {
-				ImGui::PushItemWidth(200.0f);
-
-				ImGui::Text("TERMINATION CONSTANTS");
-
-				ImGui::SliderInt("max recursive depth", reinterpret_cast<int*>(&m_maxRecursiveDepth), 0, 100);
-				m_maxRecursiveDepth = glm::clamp<unsigned int>(m_maxRecursiveDepth, 0, 100);
-				
-				ImGui::SliderFloat("eta (t1 termination constant - jump tolerance (model shape))", &m_eta, 0.0f, 1.1f);
-				m_eta = glm::clamp<float>(m_eta, 0.0f, 1.1f);
-
-				ImGui::SliderFloat("zeta (t2 termination constant - regularity (obb shape)", &m_zeta, 0.0f, 1.1f);
-				m_zeta = glm::clamp<float>(m_zeta, 0.0f, 1.1f);
-
-				ImGui::Text("NOTE: to practically disable these termination conditions, set values to 100, 1.1, 1.1 respectively");
-				ImGui::Text("NOTE: if any of these 3 constants is set higher, then the termination condition is more loose");
-
-				ImGui::PopItemWidth();
 
-				if (ImGui::Button("GENERATE CAGE")) generateCage2();
+			// a generated cage can keep being regenerated (e.g. live preview) until its weights get computed
+			if (nullptr != m_model && m_isCageGenerated && m_vertWeights.empty()) {
+				ImGui::Separator();
+				drawCageGenerationUI();
 			}
+		} else if (m_cageLoadJob.isBusy()) {
+			drawLoadingProgress("LOADING CAGE", m_cageLoadJob);
+		} else {
+			if (nullptr != m_model) drawCageGenerationUI();
 			
 			//NOTE: it seems that imgui only allows typing in the text box upto maxFileNameLength - 1 chars.
 			unsigned int const maxFileNameLength = 256;
 			char filename[maxFileNameLength] = "";
 			ImGuiInputTextFlags const flags = ImGuiInputTextFlags_EnterReturnsTrue;
 			ImGui::Text("LOAD CAGE");
+			drawMeshFileFormatCombo("##loadCageFormat", m_importFormat);
+			std::string const extension = std::string(".") + s_MESH_FILE_EXTENSIONS[m_importFormat];
 			ImGui::Text(".../models/imports/");
 			ImGui::SameLine();
-			if (ImGui::InputText(".obj##1", filename, IM_ARRAYSIZE(filename), flags)) {
-				loadCage("models/imports/" + std::string(filename) + ".obj");
+			if (ImGui::InputText((extension + "##1").c_str(), filename, IM_ARRAYSIZE(filename), flags)) {
+				loadCage("models/imports/" + std::string(filename) + extension);
 			}
 		}
 		ImGui::Separator();
@@ -523,21 +600,116 @@ void Program::drawUI() {
 		ImGui::End();
 	}
 
+	drawCageRegionSelection();
+}
+
+
+// outline of the box/lasso being dragged (on top of everything)
+void Program::drawCageRegionSelection() {
+	if (m_selectionRegion.empty()) return;
+
+	ImDrawList *drawList = ImGui::GetForegroundDrawList();
+	ImU32 const colour = IM_COL32(255, 200, 0, 255);
+	if (m_isLassoSelection) {
+		std::vector<ImVec2> points;
+		points.reserve(m_selectionRegion.size());
+		for (glm::vec2 const& p : m_selectionRegion) points.push_back(ImVec2(p.x, p.y));
+		drawList->AddPolyline(points.data(), (int)points.size(), colour, true, 1.0f);
+	} else {
+		glm::vec2 const rectMin = glm::min(m_selectionRegion.front(), m_selectionRegion.back());
+		glm::vec2 const rectMax = glm::max(m_selectionRegion.front(), m_selectionRegion.back());
+		drawList->AddRectFilled(ImVec2(rectMin.x, rectMin.y), ImVec2(rectMax.x, rectMax.y), IM_COL32(255, 200, 0, 40));
+		drawList->AddRect(ImVec2(rectMin.x, rectMin.y), ImVec2(rectMax.x, rectMax.y), colour);
+	}
+}
+
+void Program::drawCageGenerationUI() {
+	ImGui::PushItemWidth(200.0f);
+
+	ImGui::Text("TERMINATION CONSTANTS");
+
+	// only the tree stage depends on these, so they are cheap to change once the other stages are cached
+	bool terminationChanged = false;
+
+	terminationChanged |= ImGui::SliderInt("max recursive depth", reinterpret_cast<int*>(&m_maxRecursiveDepth), 0, 100);
+	m_maxRecursiveDepth = glm::clamp<unsigned int>(m_maxRecursiveDepth, 0, 100);
+
+	terminationChanged |= ImGui::SliderFloat("eta (t1 termination constant - jump tolerance (model shape))", &m_eta, 0.0f, 1.1f);
+	m_eta = glm::clamp<float>(m_eta, 0.0f, 1.1f);
+
+	terminationChanged |= ImGui::SliderFloat("zeta (t2 termination constant - regularity (obb shape)", &m_zeta, 0.0f, 1.1f);
+	m_zeta = glm::clamp<float>(m_zeta, 0.0f, 1.1f);
+
+	terminationChanged |= ImGui::SliderInt("min splice distance (voxels between a splice and the ends of its box)", reinterpret_cast<int*>(&m_minSpliceDistance), 1, 50);
+	m_minSpliceDistance = glm::clamp<unsigned int>(m_minSpliceDistance, 1, 50);
+
+	ImGui::Text("NOTE: to practically disable these termination conditions, set values to 100, 1.1, 1.1 respectively");
+	ImGui::Text("NOTE: if any of these 3 constants is set higher, then the termination condition is more loose");
+
+	terminationChanged |= ImGui::Checkbox("best-first splitting (split the box with the biggest jump first, until a budget is reached)", &m_useBestFirstSplitting);
+	if (m_useBestFirstSplitting) {
+		terminationChanged |= ImGui::SliderInt("target cage vert count (0 = no limit)", reinterpret_cast<int*>(&m_targetCageVertCount), 0, 5000);
+		m_targetCageVertCount = glm::clamp<unsigned int>(m_targetCageVertCount, 0, 5000);
+
+		terminationChanged |= ImGui::SliderInt("target cage face count (0 = no limit)", reinterpret_cast<int*>(&m_targetCageFaceCount), 0, 10000);
+		m_targetCageFaceCount = glm::clamp<unsigned int>(m_targetCageFaceCount, 0, 10000);
+
+		terminationChanged |= ImGui::SliderFloat("splitting time budget in seconds (0 = no limit)", &m_splitTimeBudget, 0.0f, 10.0f);
+		m_splitTimeBudget = glm::clamp<float>(m_splitTimeBudget, 0.0f, 10.0f);
+	}
+
+	ImGui::Checkbox("live preview (regenerate the cage while dragging the termination constants)", &m_isLivePreviewOn);
+
+	ImGui::Text("VOXELIZATION (changing these reruns the whole pipeline)");
+
+	ImGui::SliderInt("voxel resolution", reinterpret_cast<int*>(&m_voxelResolution), 10, 300);
+	m_voxelResolution = glm::clamp<unsigned int>(m_voxelResolution, 10, 300);
+
+	ImGui::Checkbox("fit OBBs to convex hull points only", &m_obbFitOptions.m_useConvexHull);
+	ImGui::Checkbox("search convex hull faces for a tighter OBB (slower)", &m_obbFitOptions.m_useHullFaceSearch);
+
+	ImGui::PopItemWidth();
+
+	if (ImGui::Button("GENERATE CAGE")) {
+		generateCage2();
+	}
+	else if (terminationChanged && m_isLivePreviewOn && m_cageGenerationCache.m_isValid) {
+		generateCage2();
+	}
+
+	ImGui::Text("MESH SIMPLIFICATION (closed, manifold models only)");
+	ImGui::PushItemWidth(200.0f);
+
+	ImGui::SliderFloat("offset (fraction of the model's bounding box diagonal)", &m_simplificationOffset, 0.0f, 0.2f);
+	m_simplificationOffset = glm::clamp<float>(m_simplificationOffset, 0.0f, 0.2f);
+
+	ImGui::SliderInt("target cage vert count", reinterpret_cast<int*>(&m_simplificationTargetVertCount), 4, 2000);
+	m_simplificationTargetVertCount = glm::clamp<unsigned int>(m_simplificationTargetVertCount, 4, 2000);
+
+	ImGui::Checkbox("offset through signed distance field (uses voxel resolution)", &m_useSDFOffset);
+
+	ImGui::PopItemWidth();
+
+	if (ImGui::Button("GENERATE CAGE (MESH SIMPLIFICATION)")) {
+		generateCageSimplified();
+	}
 }
 
+
 // Main loop
 void Program::mainLoop() {
 
 	initScene();
 
 	// Our state
-	clearColor = ImVec4(1.0f, 1.0f, 1.0f, 1.0f); //NOTE: keep this white since it has the least chance of interfering with color picking (due to being the last possible color that can be generated)
+	clearColor = ImVec4(1.0f, 1.0f, 1.0f, 1.0f);
 
 	while(!glfwWindowShouldClose(window)) {
 
-		//NOTE: any colour picking will be done in mouse callback...
+		//NOTE: any cage vert picking will be done in mouse callback...
 		glfwPollEvents();
 
+		finishLoading();
 		drawUI();
 
 		// Rendering
@@ -573,11 +745,18 @@ void Program::mainLoop() {
 void Program::computeCageWeights() {
 	
 	// cleanup...
-	m_vertWeights.clear();
+	clearCageWeights();
 	//m_normalWeights.clear();
 	
 	if (nullptr == m_model || nullptr == m_cage) return;
 
+	// model verts outside of (or on) the cage would get invalid weights (or stop the loops below half way)
+	if (!validateCageEnclosure()) return;
+
+	// the model as it is now is the rest pose every deformation (and saved pose) starts from
+	m_restPose.m_verts = m_model->drawVerts;
+	m_restPose.m_normals = m_model->normals;
+
 	// 0. init vector sizes...
 
 	m_vertWeights = std::vector<std::vector<float>>(m_model->drawVerts.size(), std::vector<float>(m_cage->drawVerts.size(), 0.0f));
@@ -592,129 +771,8 @@ void Program::computeCageWeights() {
 		// foreach model vert...
 		for (unsigned int i = 0; i < m_model->drawVerts.size(); ++i) {
 
-			// init the cage vert weights vector for model vert i...
-			std::vector<float> u_i(m_cage->drawVerts.size(), 0.0f);
-
-			glm::vec3 const x = m_model->drawVerts.at(i); // (sphere origin)
-
-			// foreach triangle face in cage mesh...
-			for (unsigned int f = 0; f < m_cage->drawFaces.size(); f += 3) {
-
-				// save the 3 cage vert indices making up cage face f...
-				unsigned int const p1_index = m_cage->drawFaces.at(f);
-				unsigned int const p2_index = m_cage->drawFaces.at(f+1);
-				unsigned int const p3_index = m_cage->drawFaces.at(f+2);
-
-				// get the 3 cage vert positions...
-				glm::vec3 const p1 = m_cage->drawVerts.at(p1_index);
-				glm::vec3 const p2 = m_cage->drawVerts.at(p2_index);
-				glm::vec3 const p3 = m_cage->drawVerts.at(p3_index);
-
-				float const d1 = glm::length(p1 - x);
-				float const d2 = glm::length(p2 - x);
-				float const d3 = glm::length(p3 - x);
-
-				//TODO: ...
-				//TODO: ... (i'm thinking give it a weight of 1 and enter a special mode (if mode is false, then set true) - since this cage vert is basically located at model vert, it should get highest influence
-				// PREVENTS DIVIDE BY ZERO (since we would be trying to normalize the zero vector which is undefined)
-				if (d1 < glm::epsilon<float>()) {
-					//return? or continue? or something else?
-					return;
-				}
-				if (d2 < glm::epsilon<float>()) {
-					//return? or continue? or something else?
-					return;
-				}
-				if (d3 < glm::epsilon<float>()) {
-					//return? or continue? or something else?
-					return;
-				}
-
-				glm::vec3 const u1 = (p1 - x) / d1; // p1 projected on unit sphere centered at x
-				glm::vec3 const u2 = (p2 - x) / d2; // p2 projected on unit sphere centered at x
-				glm::vec3 const u3 = (p3 - x) / d3; // p3 projected on unit sphere centered at x
-
-				// side-lengths of planar triangle t
-				//NOTE: I believe the length would vary from 0 to 2 (e.g. 2 points on opposite side of unit sphere = R+R = 1+1 = 2)
-				float const l1 = glm::length(u2 - u3);
-				float const l2 = glm::length(u3 - u1);
-				float const l3 = glm::length(u1 - u2);
-
-				// arc-lengths of spherical triangle t_sph (equivalent to angles since R=1)
-				//NOTE: I believe these angles/lengths will be between 0 and pi
-				float const theta1 = 2 * glm::asin(l1 / 2);
-				float const theta2 = 2 * glm::asin(l2 / 2);
-				float const theta3 = 2 * glm::asin(l3 / 2);
-
-				// safety (handle if a length happens to be very small (< 2*epsilon) (I guess the area would be 0 and thus influence by this face would be 0, thus just continue?))
-				// PREVENTS DIVIDE BY ZERO (since asin(0/2) = 0, thus theta = 0, which then cause a sin(0) in denominator for a c_i calculation
-				if (theta1 < glm::epsilon<float>() || theta2 < glm::epsilon<float>() || theta3 < glm::epsilon<float>()) continue;
-
-				// half-angle (Beyer)
-				//NOTE: assume a scenario where u1,u2,u3 form a planar triangle that cuts through the center (x) of the unit sphere (and recall that they are all on the surface of the sphere at R=1).
-				//NOTE: now assume we have a configuration like
-				// u1-R-x-R-u3
-				//   \  |  /
-				//    \ R /
-				//     \|/
-				//     u2
-				// the planar triangle lengths would be l1 = l3 = sqrt(2*R^2) = sqrt(2) and l2 = 2*R = 2
-				// thus, we would get theta1 + theta2 + theta3 = 2 * [asin(sqrt(2) / 2) + asin(1) + asin(sqrt(2) / 2)] = 2 * [pi/4 + pi/2 + pi/4] = 2 * [pi]
-				//NOTE: thus, I think h will be in range [1.5 * epsilon, pi]
-				float const h = (theta1 + theta2 + theta3) / 2;
-				if (glm::pi<float>() - h < glm::epsilon<float>()) {
-					// center of sphere point x lies on triangle t (use 2D barycentric coords)
-
-					std::fill(u_i.begin(), u_i.end(), 0.0f); // reset weights vector back to all zeros
-
-					//NOTE: only this face will have an influence on model vert_i (x)
-					u_i.at(p1_index) = glm::sin(theta1) * d3 * d2;
-					u_i.at(p2_index) = glm::sin(theta2) * d1 * d3;
-					u_i.at(p3_index) = glm::sin(theta3) * d2 * d1;
-					break; // no need to check any other faces
-				}
-
-				//NOTE: I was having a bug where some faces were missing due to one of these cosines (c1,c2,c3) being something like 1.000024 which squared is > 1 and thus causes a sqrt(<0) at one of s1,s2,s3 resulting in a -nan
-				//FIX: clamp the cosines between the mathmetical range of -1 to 1
-				//NOTE: I'm not sure if clamping is the right thing to do, or if it should be an error or something, but I think its just float imprecision causing it and the program seems to work...
-				
-				// cosines of the spherical triangle angles (diheral angles)
-				float const c1 = glm::clamp((2 * glm::sin(h)*glm::sin(h - theta1)) / (glm::sin(theta2)*glm::sin(theta3)) - 1, -1.0f, 1.0f);
-				float const c2 = glm::clamp((2 * glm::sin(h)*glm::sin(h - theta2)) / (glm::sin(theta3)*glm::sin(theta1)) - 1, -1.0f, 1.0f);
-				float const c3 = glm::clamp((2 * glm::sin(h)*glm::sin(h - theta3)) / (glm::sin(theta1)*glm::sin(theta2)) - 1, -1.0f, 1.0f);
-
-				//TODO: add any error checking or comments for below???
-				glm::mat3 const uMat = glm::mat3(u1, u2, u3);
-				float const det = glm::determinant(uMat);
-				
-				float const s1 = glm::sign(det) * glm::sqrt(1 - c1 * c1);
-				float const s2 = glm::sign(det) * glm::sqrt(1 - c2 * c2);
-				float const s3 = glm::sign(det) * glm::sqrt(1 - c3 * c3);
-
-				// if sphere origin (x) lies on same plane as triangle t, but lies outside triangle, then we ignore this face (since projection would be a curve of zero area and thus have 0 weight)
-				if (glm::abs(s1) <= glm::epsilon<float>() || glm::abs(s2) <= glm::epsilon<float>() || glm::abs(s3) <= glm::epsilon<float>()) continue; // continue to next face
-
-				// update the weights of each of the 3 cage verts making up this face affecting the model vert_i (x) by accumulation
-				u_i.at(p1_index) += (theta1 - c2 * theta3 - c3 * theta2) / (d1 * glm::sin(theta2) * s3);
-				u_i.at(p2_index) += (theta2 - c3 * theta1 - c1 * theta3) / (d2 * glm::sin(theta3) * s1);
-				u_i.at(p3_index) += (theta3 - c1 * theta2 - c2 * theta1) / (d3 * glm::sin(theta1) * s2);
-			}
-
-			// 6. normalize the weights vector (sum of all elements = 1) for affine property
-
-			//TODO: since, we can have negative weights, isn't it possible that totalW could be 0?
-
-			float totalW = 0.0f;
-			for (unsigned int j = 0; j < u_i.size(); ++j) {
-				totalW += u_i.at(j);
-			}
-
-			for (unsigned int j = 0; j < u_i.size(); ++j) {
-				u_i.at(j) /= totalW;
-			}
-
-			// 7. assign weights vector to the model vert i
-			m_vertWeights.at(i) = u_i; // insert finished weight vector into matrix
+			// compute + assign the weights vector of model vert i (straight into the matrix)
+			if (!MeanValueCoordinates::computeWeights(m_model->drawVerts.at(i), m_cage->drawVerts, m_cage->drawFaces, m_vertWeights.at(i))) return;
 		}
 
 	} else if (CoordinateTypes::HC == m_coordinateType) {
@@ -730,6 +788,47 @@ void Program::computeCageWeights() {
 }
 
 
+//NOTE: the test is done in the same (untransformed) space as the weights
+//NOTE: the highlight only shows for untextured models (the texture replaces the vert colours)
+bool Program::validateCageEnclosure() {
+	if (nullptr == m_model || nullptr == m_cage) return false;
+
+	WindingNumber windingNumber;
+	if (!windingNumber.build(m_cage->drawVerts, m_cage->drawFaces)) {
+		std::cout << "ERROR (Program.cpp) - cage has no faces" << std::endl;
+		return false;
+	}
+
+	std::vector<float> windingNumbers;
+	std::vector<unsigned char> isOnCage;
+	windingNumber.evaluateAll(m_model->drawVerts, windingNumbers, isOnCage);
+
+	// classify + highlight...
+	//NOTE: the winding number is 1 inside and 0 outside of a closed cage, the approximation error is far below the 0.5 threshold
+	unsigned int outsideCount = 0;
+	unsigned int onCount = 0;
+	for (unsigned int i = 0; i < m_model->drawVerts.size(); ++i) {
+		glm::vec3 colour = s_MODEL_COLOUR;
+		if (isOnCage.at(i)) {
+			colour = s_MODEL_ON_CAGE_COLOUR;
+			++onCount;
+		}
+		else if (windingNumbers.at(i) < 0.5f) {
+			colour = s_MODEL_OUTSIDE_CAGE_COLOUR;
+			++outsideCount;
+		}
+		if (i < m_model->colours.size()) m_model->colours.at(i) = colour;
+	}
+	renderEngine->updateBuffers(*m_model, false, false, false, true);
+
+	if (outsideCount > 0 || onCount > 0) {
+		std::cout << "ERROR (Program.cpp) - cage doesn't enclose the model: " << outsideCount << " model verts outside of the cage (red), " << onCount << " on the cage (orange)" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+
 //TODO: testing
 void Program::deformModel() {
 
@@ -776,93 +875,220 @@ void Program::deformModel() {
 
 		m_model->drawVerts.at(i) = c_i; // update
 	}
+	m_deltaDeformCount = 0;
+
+	updateDeformedModel();
+}
+
+
+// the model verts are linear in the cage verts (c_i = sum over j of u_ij * v_j), so moving only some cage verts by the same translation t just adds (sum over moved j of u_ij) * t to every c_i
+//NOTE: O(model verts * moved cage verts) instead of O(model verts * cage verts) for a full deformModel()
+//NOTE: every delta adds float rounding error, so a full deformModel() re-syncs the model every s_MAX_DELTA_DEFORMS deltas (and when a translation ends or the selection changes)
+void Program::deformModel(std::vector<unsigned int> const& movedCageVerts, glm::vec3 const& translation) {
+
+	// if one (or both) objects has not been loaded in, we cannot apply algorithm
+	if (nullptr == m_model || nullptr == m_cage) return;
+
+	// if we have no weights (e.g. user hasn't pressed compute cage weights button yet or they have cleared the weights), we cannot apply algorithm
+	if (m_vertWeights.size() == 0) return;
+
+	//TODO: GC would also need the change of the cage face normals (not just of the verts)
+	if (CoordinateTypes::MVC != m_coordinateType || m_deltaDeformCount >= s_MAX_DELTA_DEFORMS) {
+		deformModel();
+		return;
+	}
+
+	ParallelTools::parallelFor(m_model->drawVerts.size(), [&](size_t const i) {
+		std::vector<float> const& u_i = m_vertWeights[i];
+
+		float movedWeight = 0.0f;
+		for (unsigned int const j : movedCageVerts) {
+			movedWeight += u_i[j];
+		}
+		m_model->drawVerts[i] += movedWeight * translation;
+	});
+	++m_deltaDeformCount;
+
+	updateDeformedModel();
+}
+
+
+void Program::clearCageWeights() {
+	m_vertWeights.clear();
+	m_deltaDeformCount = 0;
+
+	// the poses were relative to the rest pose of these weights
+	m_restPose = MeshPose();
+	m_savedPoses.clear();
+}
+
+
+void Program::updateDeformedModel() {
+	if (m_animationRecorder.isOpen()) m_animationRecorder.addFrame(m_model->drawVerts); // every deformation is 1 frame
 
 	// recompute the model's normals now that its verts have changed... 
 	m_model->generateNormals();
 	renderEngine->updateBuffers(*m_model, true, false, true, false);
+	m_modelBVH.refit(m_model->drawVerts);
+	m_isModelHashValid = false;
+}
+
+
+unsigned int Program::pickCageVert(glm::vec2 const& cursor, glm::ivec2 const& windowSize) {
+	if (nullptr == m_cage) return CagePicker::s_NONE;
+
+	//NOTE: the cage verts are rendered as 30 pixel points (see RenderEngine), so anywhere on the point picks it
+	float const pickRadius = 15.0f;
+
+	m_cagePicker.update(m_cage->drawVerts, m_cage->getModel(), camera->getLookAt(), renderEngine->getProjection(), windowSize);
+	if (nullptr == m_model) return m_cagePicker.pick(cursor, pickRadius, nullptr, glm::mat4());
+	return m_cagePicker.pick(cursor, pickRadius, &m_modelBVH, m_model->getModel()); // the model acts as an occluder
+}
+
+
+void Program::beginCageRegionSelection(glm::vec2 const& cursor, bool const isLasso) {
+	m_isLassoSelection = isLasso;
+	m_selectionRegion.assign(isLasso ? 1 : 2, cursor);
+}
+
+
+void Program::updateCageRegionSelection(glm::vec2 const& cursor) {
+	if (m_selectionRegion.empty()) return;
+
+	if (!m_isLassoSelection) {
+		m_selectionRegion.back() = cursor; // opposite corner
+		return;
+	}
+
+	// skip tiny steps, they only add edges to test against
+	glm::vec2 const step = cursor - m_selectionRegion.back();
+	if (glm::dot(step, step) >= 4.0f) m_selectionRegion.push_back(cursor);
+}
+
+
+bool Program::endCageRegionSelection(glm::ivec2 const& windowSize, bool const isUnselect) {
+	if (m_selectionRegion.empty()) return false;
+
+	std::vector<glm::vec2> region;
+	region.swap(m_selectionRegion); // stops drawing it
+
+	// a region within a few pixels is a click
+	glm::vec2 regionMin = region.front();
+	glm::vec2 regionMax = region.front();
+	for (glm::vec2 const& p : region) {
+		regionMin = glm::min(regionMin, p);
+		regionMax = glm::max(regionMax, p);
+	}
+	if (regionMax.x - regionMin.x < 4.0f && regionMax.y - regionMin.y < 4.0f) return false;
+
+	if (nullptr == m_cage) return true;
+
+	m_cagePicker.update(m_cage->drawVerts, m_cage->getModel(), camera->getLookAt(), renderEngine->getProjection(), windowSize);
+	BVH const* occluder = (m_ignoreHiddenCageVerts && nullptr != m_model) ? &m_modelBVH : nullptr;
+	glm::mat4 const occluderModel = (nullptr != m_model) ? m_model->getModel() : glm::mat4();
+
+	std::vector<unsigned int> verts;
+	if (m_isLassoSelection) m_cagePicker.queryLasso(region, occluder, occluderModel, verts);
+	else m_cagePicker.queryRect(region.front(), region.back(), occluder, occluderModel, verts);
+
+	for (unsigned int const v : verts) {
+		if (isUnselect) m_cageSelection.unselect(v);
+		else m_cageSelection.select(v);
+	}
+	updateCageSelectionColours();
+	return true;
 }
 
 
 //NOTE: both startIndex and endIndex will be inclusive
 void Program::selectCageVerts(unsigned int const startIndex, unsigned int const count) {
 	// error handling...
-	if (nullptr == m_cage || startIndex >= m_cage->colours.size() || count == 0) return;
+	if (nullptr == m_cage || startIndex >= m_cageSelection.getVertexCount() || count == 0) return;
 
-	// clamp endIndex max bound to last index in colours vector
-	unsigned int const endIndex = (startIndex + count - 1) >= m_cage->colours.size() ? m_cage->colours.size() - 1 : startIndex + count - 1;
+	// clamp endIndex max bound to last cage vert
+	unsigned int const endIndex = (startIndex + count - 1) >= m_cageSelection.getVertexCount() ? m_cageSelection.getVertexCount() - 1 : startIndex + count - 1;
 
-	// set all specified verts to selected colour...
 	for (unsigned int i = startIndex; i <= endIndex; ++i) {
-		m_cage->colours.at(i) = s_CAGE_SELECTED_COLOUR;
+		m_cageSelection.select(i);
 	}
 
-	// update colour buffer
-	// this enum test should always evaluate to true, but in case it isn't we can skip the update buffers, since the picking colours would just be reinserted (unchanged)
-	if (ColourMode::NORMAL == m_cage->m_colourMode) renderEngine->updateBuffers(*m_cage, false, false, false, true);
+	updateCageSelectionColours();
 }
 
 
 //NOTE: both startIndex and endIndex will be inclusive
 void Program::unselectCageVerts(unsigned int const startIndex, unsigned int const count) {
 	// error handling...
-	if (nullptr == m_cage || startIndex >= m_cage->colours.size() || count == 0) return;
+	if (nullptr == m_cage || startIndex >= m_cageSelection.getVertexCount() || count == 0) return;
 
-	// clamp endIndex max bound to last index in colours vector
-	unsigned int const endIndex = (startIndex + count - 1) >= m_cage->colours.size() ? m_cage->colours.size() - 1 : startIndex + count - 1;
+	// clamp endIndex max bound to last cage vert
+	unsigned int const endIndex = (startIndex + count - 1) >= m_cageSelection.getVertexCount() ? m_cageSelection.getVertexCount() - 1 : startIndex + count - 1;
 
-	// set all specified verts to unselected colour...
 	for (unsigned int i = startIndex; i <= endIndex; ++i) {
-		m_cage->colours.at(i) = s_CAGE_UNSELECTED_COLOUR;
+		m_cageSelection.unselect(i);
 	}
 
-	// update colour buffer
-	// this enum test should always evaluate to true, but in case it isn't we can skip the update buffers, since the picking colours would just be reinserted (unchanged)
-	if (ColourMode::NORMAL == m_cage->m_colourMode) renderEngine->updateBuffers(*m_cage, false, false, false, true);
+	updateCageSelectionColours();
 }
 
 
 //NOTE: both startIndex and endIndex will be inclusive
 void Program::toggleCageVerts(unsigned int const startIndex, unsigned int const count) {
 	// error handling...
-	if (nullptr == m_cage || startIndex >= m_cage->colours.size() || count == 0) return;
+	if (nullptr == m_cage || startIndex >= m_cageSelection.getVertexCount() || count == 0) return;
 
-	// clamp endIndex max bound to last index in colours vector
-	unsigned int const endIndex = (startIndex + count - 1) >= m_cage->colours.size() ? m_cage->colours.size() - 1 : startIndex + count - 1;
+	// clamp endIndex max bound to last cage vert
+	unsigned int const endIndex = (startIndex + count - 1) >= m_cageSelection.getVertexCount() ? m_cageSelection.getVertexCount() - 1 : startIndex + count - 1;
 
-	// set all specified verts to opposite colour...
 	for (unsigned int i = startIndex; i <= endIndex; ++i) {
-		m_cage->colours.at(i) = s_CAGE_UNSELECTED_COLOUR == m_cage->colours.at(i) ? s_CAGE_SELECTED_COLOUR : s_CAGE_UNSELECTED_COLOUR;
+		m_cageSelection.toggle(i);
 	}
 
-	// update colour buffer
-	// this enum test should always evaluate to true, but in case it isn't we can skip the update buffers, since the picking colours would just be reinserted (unchanged)
-	if (ColourMode::NORMAL == m_cage->m_colourMode) renderEngine->updateBuffers(*m_cage, false, false, false, true);
+	updateCageSelectionColours();
+}
+
+
+// recolours (and re-uploads) only the cage verts whose selection changed since the last call
+void Program::updateCageSelectionColours() {
+	unsigned int first = 0;
+	unsigned int count = 0;
+	if (nullptr == m_cage || !m_cageSelection.takeChangedRange(first, count)) return;
+
+	// the delta updates so far were for the old selection
+	finishCageTranslation();
+
+	for (unsigned int i = first; i < first + count; ++i) {
+		m_cage->colours.at(i) = m_cageSelection.isSelected(i) ? s_CAGE_SELECTED_COLOUR : s_CAGE_UNSELECTED_COLOUR;
+	}
+	renderEngine->updateColours(*m_cage, first, count);
 }
 
+
 void Program::translateSelectedCageVerts(glm::vec3 const& translation) {
 	if (nullptr == m_cage) return;
 
-	bool hasChanged = false;
+	std::vector<unsigned int> const& selected = m_cageSelection.getSelected();
+	if (selected.empty()) return;
 
-	// loop through all cage verts...
-	for (unsigned int i = 0; i < m_cage->drawVerts.size(); ++i) {
-		glm::vec3 &vert = m_cage->drawVerts.at(i);
+	// the model has to follow the cage again (instead of showing an animation frame) before it can be deformed by the delta
+	if (m_animationPlayer.isOpen()) closeAnimation();
 
-		// if vert is selected, apply translation to it
-		if (s_CAGE_SELECTED_COLOUR == m_cage->colours.at(i)) {
-			vert += translation;
-			hasChanged = true;
-		}
+	// only the selected verts are visited...
+	for (unsigned int const i : selected) {
+		m_cage->drawVerts.at(i) += translation;
 	}
 
 	//TODO: add in call to recompute normals of cage (if we are including normals with cage) - would need to set updateNormals true in updateBuffers() call
 
-	if (hasChanged) {
-		renderEngine->updateBuffers(*m_cage, true, false, false, false);
-	
-		//TODO: add in call to deformModel() if its not null
-		deformModel();
-	}
+	renderEngine->updateBuffers(*m_cage, true, false, false, false);
+	m_cagePicker.invalidate();
+
+	deformModel(selected, translation);
+}
+
+
+void Program::finishCageTranslation() {
+	if (m_deltaDeformCount > 0) deformModel();
 }
 
 
@@ -871,57 +1097,80 @@ void Program::translateSelectedCageVerts(glm::vec3 const& translation) {
 // reference: http://www.cad.zju.edu.cn/home/hwlin/pdf_files/Automatic-cage-generation-by-improved-OBBs-for-mesh-deformation.pdf
 // reference: http://www-home.htwg-konstanz.de/~umlauf/Papers/cagesurvSinCom.pdf
 // reference: https://hewjunwei.wordpress.com/2013/01/26/obb-generation-via-principal-component-analysis/
+//NOTE: the pipeline is split into stages...
+// 1. point set P (dedup, PCA, voxelization, inner voxel fill) - depends on the model, voxel resolution and OBB fit options
+// 2. obb space (2nd PCA + binning of P) - same dependencies
+// 3. mesh tree - depends on the termination constants
+// 4. welding + cage assembly
+// stages 1 and 2 are cached (keyed by their inputs), so tweaking the termination constants only reruns stages 3 and 4
 void Program::generateCage2() {
 	if (nullptr == m_model) return;
 
 	std::shared_ptr<MeshObject> out_obb = std::make_shared<MeshObject>();
 	std::shared_ptr<MeshObject> out_pointSetP = std::make_shared<MeshObject>();
-	std::vector<glm::vec3> pointSetP = generatePointSetP2(*out_obb, *out_pointSetP);
-	std::vector<std::vector<std::vector<unsigned int>>> obbSpace = generateOBBSpace(pointSetP);
-	MeshTree const meshTree = generateMeshTree(obbSpace, 0, obbSpace.at(0).at(0).size() - 1, 0, obbSpace.at(0).size() - 1, 0, obbSpace.size() - 1, 0);
-	
-	//TODO: construct cage out of meshTree for rendering (e.g. add colours/picking colours, flags, etc.)
+	//NOTE: out_obb and out_pointSetP (only used by the debug renders below) are only filled in when stages 1 and 2 actually rerun
 
-	// clear old cage if any...
-	clearCage();
+	// STAGES 1 + 2 (CACHED)...
+	uint64_t const modelHash = getModelHash();
+	bool const isCacheHit = m_cageGenerationCache.m_isValid &&
+		modelHash == m_cageGenerationCache.m_modelHash &&
+		m_voxelResolution == m_cageGenerationCache.m_voxelResolution &&
+		m_obbFitOptions.m_useConvexHull == m_cageGenerationCache.m_useConvexHull &&
+		m_obbFitOptions.m_useHullFaceSearch == m_cageGenerationCache.m_useHullFaceSearch;
+
+	if (!isCacheHit) {
+		m_cageGenerationCache = CageGenerationCache();
+
+		std::vector<glm::vec3> pointSetP = generatePointSetP2(*out_obb, *out_pointSetP);
+		m_cageGenerationCache.m_obbSpace = generateOBBSpace(pointSetP);
+		if (m_cageGenerationCache.m_obbSpace.empty()) return;
+
+		m_cageGenerationCache.m_modelHash = modelHash;
+		m_cageGenerationCache.m_voxelResolution = m_voxelResolution;
+		m_cageGenerationCache.m_useConvexHull = m_obbFitOptions.m_useConvexHull;
+		m_cageGenerationCache.m_useHullFaceSearch = m_obbFitOptions.m_useHullFaceSearch;
+		m_cageGenerationCache.m_isValid = true;
+	}
+
+	std::vector<std::vector<std::vector<unsigned int>>> const& obbSpace = m_cageGenerationCache.m_obbSpace;
+
+	// STAGE 3...
+	MeshTree meshTree;
+	if (m_useBestFirstSplitting) {
+		generateMeshTreeBestFirst(obbSpace, meshTree);
+	}
+	else {
+		meshTree.reserveLeaves(size_t(1) << glm::min<unsigned int>(m_maxRecursiveDepth, 10)); // grows (amortized) past this if the tree gets really deep
+		generateMeshTree(obbSpace, 0, obbSpace.at(0).at(0).size() - 1, 0, obbSpace.at(0).size() - 1, 0, obbSpace.size() - 1, 0, meshTree);
+	}
+
+	// STAGE 4...
+	// weld the leaf OBBs into a single watertight surface (internal faces removed, faces on the split planes registered, shared verts merged)...
+	MeshTree const weldedTree = CageWelder::weld(meshTree.m_leafBoxes);
 
 	///////////////////////////////////////////////////////////////////////////////////////
 	// RENDER ACTUAL CAGE...
 
 //
-	m_cage = std::make_shared<MeshObject>();
-	
+	std::vector<glm::vec3> cageVerts;
+	cageVerts.reserve(weldedTree.m_vertexCoords.size());
+
 	//RECALL: .x for V1, .y for V2, .z for V3
-	for (glm::vec3 const& p : meshTree.m_vertexCoords) {
+	for (glm::uvec3 const& gridCoord : weldedTree.m_vertexCoords) {
+		glm::vec3 const p = glm::vec3(gridCoord);
 		glm::vec3 const p_cage = (p.x * m_voxelSize + m_expandedMinScalarAlongV1) * m_eigenV1 + (p.y * m_voxelSize + m_expandedMinScalarAlongV2) * m_eigenV2 + (p.z * m_voxelSize + m_expandedMinScalarAlongV3) * m_eigenV3;
-		m_cage->drawVerts.push_back(p_cage);
-	}
-	m_cage->drawFaces = meshTree.m_faceIndices;
-
-	// init vert colours (uniform light grey for now)
-	for (unsigned int i = 0; i < m_cage->drawVerts.size(); ++i) {
-		m_cage->colours.push_back(glm::vec3(0.8f, 0.8f, 0.8f));
+		cageVerts.push_back(p_cage);
 	}
+	std::vector<GLuint> cageFaces = weldedTree.m_faceIndices;
 
-	// set cage black and also set picking colours...
-	for (unsigned int i = 0; i < m_cage->colours.size(); ++i) {
-		// render colour...
-		m_cage->colours.at(i) = s_CAGE_UNSELECTED_COLOUR;
-
-		// reference: http://www.opengl-tutorial.org/miscellaneous/clicking-on-objects/picking-with-an-opengl-hack/
-		// reference: https://github.com/opengl-tutorials/ogl/blob/master/misc05_picking/misc05_picking_slow_easy.cpp
-		// picking colour...
-		//NOTE: this assumes that this cage will be the only object with picking colours (these colours must be unique)
-		unsigned int const r = (i & 0x000000FF) >> 0;
-		unsigned int const g = (i & 0x0000FF00) >> 8;
-		unsigned int const b = (i & 0x00FF0000) >> 16;
-		m_cage->pickingColours.push_back(glm::vec3(r / 255.0f, g / 255.0f, b / 255.0f));
+	// the welded faces are CCW (outward) in the V1, V2, V3 index space, so they have to be flipped if the eigenbasis is left-handed...
+	if (glm::dot(glm::cross(m_eigenV1, m_eigenV2), m_eigenV3) < 0.0f) {
+		for (unsigned int f = 0; f < cageFaces.size(); f += 3) {
+			std::swap(cageFaces.at(f + 1), cageFaces.at(f + 2));
+		}
 	}
-	m_cage->m_polygonMode = PolygonMode::LINE; // set wireframe
-	m_cage->m_renderPoints = true; // hack to render the cage as points as well (2nd polygon mode)
 
-	meshObjects.push_back(m_cage);
-	renderEngine->assignBuffers(*m_cage);
+	assignGeneratedCage(cageVerts, cageFaces);
 //
 
 	///////////////////////////////////////////////////////////////////////////////////////
@@ -936,19 +1185,9 @@ void Program::generateCage2() {
 		m_cage->colours.push_back(glm::vec3(0.8f, 0.8f, 0.8f));
 	}
 
-	// set cage black and also set picking colours...
+	// set cage black...
 	for (unsigned int i = 0; i < m_cage->colours.size(); ++i) {
-		// render colour...
 		m_cage->colours.at(i) = s_CAGE_UNSELECTED_COLOUR;
-
-		// reference: http://www.opengl-tutorial.org/miscellaneous/clicking-on-objects/picking-with-an-opengl-hack/
-		// reference: https://github.com/opengl-tutorials/ogl/blob/master/misc05_picking/misc05_picking_slow_easy.cpp
-		// picking colour...
-		//NOTE: this assumes that this cage will be the only object with picking colours (these colours must be unique)
-		unsigned int const r = (i & 0x000000FF) >> 0;
-		unsigned int const g = (i & 0x0000FF00) >> 8;
-		unsigned int const b = (i & 0x00FF0000) >> 16;
-		m_cage->pickingColours.push_back(glm::vec3(r / 255.0f, g / 255.0f, b / 255.0f));
 	}
 	m_cage->m_polygonMode = PolygonMode::LINE; // set wireframe
 
@@ -967,19 +1206,9 @@ void Program::generateCage2() {
 		m_cage->colours.push_back(glm::vec3(0.8f, 0.8f, 0.8f));
 	}
 
-	// set cage black and also set picking colours...
+	// set cage black...
 	for (unsigned int i = 0; i < m_cage->colours.size(); ++i) {
-		// render colour...
 		m_cage->colours.at(i) = s_CAGE_UNSELECTED_COLOUR;
-
-		// reference: http://www.opengl-tutorial.org/miscellaneous/clicking-on-objects/picking-with-an-opengl-hack/
-		// reference: https://github.com/opengl-tutorials/ogl/blob/master/misc05_picking/misc05_picking_slow_easy.cpp
-		// picking colour...
-		//NOTE: this assumes that this cage will be the only object with picking colours (these colours must be unique)
-		unsigned int const r = (i & 0x000000FF) >> 0;
-		unsigned int const g = (i & 0x0000FF00) >> 8;
-		unsigned int const b = (i & 0x00FF0000) >> 16;
-		m_cage->pickingColours.push_back(glm::vec3(r / 255.0f, g / 255.0f, b / 255.0f));
 	}
 	m_cage->m_polygonMode = PolygonMode::POINT;
 
@@ -992,6 +1221,38 @@ void Program::generateCage2() {
 
 
 
+// reference: http://www.isthe.com/chongo/tech/comp/fnv/index.html#FNV-1a
+uint64_t Program::getModelHash() {
+	if (!m_isModelHashValid) {
+		m_modelHash = computeModelHash(*m_model);
+		m_isModelHashValid = true;
+	}
+	return m_modelHash;
+}
+
+
+uint64_t Program::computeModelHash(MeshObject const& model) {
+	uint64_t hash = 14695981039346656037ull; // FNV offset basis
+
+	auto hashBytes = [&hash](void const* data, size_t const byteCount) {
+		unsigned char const* bytes = static_cast<unsigned char const*>(data);
+		for (size_t b = 0; b < byteCount; ++b) {
+			hash ^= bytes[b];
+			hash *= 1099511628211ull; // FNV prime
+		}
+	};
+
+	size_t const vertCount = model.drawVerts.size();
+	size_t const faceIndexCount = model.drawFaces.size();
+	hashBytes(&vertCount, sizeof(vertCount));
+	hashBytes(&faceIndexCount, sizeof(faceIndexCount));
+	if (0 != vertCount) hashBytes(model.drawVerts.data(), vertCount * sizeof(glm::vec3));
+	if (0 != faceIndexCount) hashBytes(model.drawFaces.data(), faceIndexCount * sizeof(GLuint));
+
+	return hash;
+}
+
+
 std::vector<glm::vec3> Program::generatePointSetP2(MeshObject &out_obb, MeshObject &out_pointSetP) {
 	if (nullptr == m_model) return std::vector<glm::vec3>();
 
@@ -1004,100 +1265,26 @@ std::vector<glm::vec3> Program::generatePointSetP2(MeshObject &out_obb, MeshObje
 		}
 	}
 
-	// 2. generate initial OBB O of pointSetM using Principal Component Analysis...
-
-	// low covariance of 2 values means more independent (less correlated)
-	// covariance(x,x) = variance(x)
-	// covariance matrix A generalizes the concept of variance in multiple dimensions
-	// we want to diagonalize the covariance matrix to make signals strong (big diagonal entries) and distortions weak (low (in this case 0) off-diagonal entries)
-	// A is REAL and SYMMETRIC ===> guaranteed to have 3 eigenvectors in the similarity transformation (change of basis matrix) when we diagonalize A.
-	// THE 3 EIGENVECTORS OF COVARIANCE MATRIX WILL MAKE UP ORIENTATION OF OBB
-	// large eigenvalues mean large variance, thus align OBB along eigenvector corresponding to largest eigenvalue
-
-	//TODO: could improve this algo by working on the convex hull points only (but it might not be worth it)
-	//TODO: could improve this program by using a more exact OBB method (slower) for low vert count models.
-
-	// reference: https://stackoverflow.com/questions/6189229/creating-oobb-from-points
-	// 3. compute centroid mu of points...
-	glm::vec3 mu = glm::vec3(0.0f, 0.0f, 0.0f);
-	for (glm::vec3 const& p : pointSetM) {
-		mu += p;
-	}
-	mu /= pointSetM.size();
-
-	// 4. compute covariance matrix...
-	glm::mat3 covarianceMatrix = glm::mat3(0.0f);
-	for (glm::vec3 const& p : pointSetM) {
-		glm::vec3 const dev = p - mu;
-		glm::mat3 const covMat_i = glm::outerProduct(dev, dev); // dev * (dev)^T
-		covarianceMatrix += covMat_i;
-	}
-	//NOTE: this matrix should be REAL and SYMMETRIC
+	// 2. generate initial OBB O of pointSetM using Principal Component Analysis (see OBBTools)...
+	//NOTE: a tighter (slower) hull face OBB search can be enabled through m_obbFitOptions for models where PCA is poor
+	OBB const obb = OBBTools::fitOBB(pointSetM, m_obbFitOptions);
 
-	// 5. get sorted eigenvalues (ascending) + corresponding eigenvectors...
+	//NOTE: basis vectors come sorted (v3 >= v2 >= V1)
+	glm::vec3 const eigenV1 = obb.m_axes[0];
+	glm::vec3 const eigenV2 = obb.m_axes[1];
+	glm::vec3 const eigenV3 = obb.m_axes[2];
 
-	// convert matrix form (glm -> eigen) to work with eigensolver...
-	Eigen::Matrix3f covMatEigen;
-	for (unsigned int i = 0; i < covarianceMatrix.length(); ++i) { // loop over columns
-		for (unsigned int j = 0; j < covarianceMatrix[i].length(); ++j) { // loop over rows
-			covMatEigen(j, i) = covarianceMatrix[i][j]; //NOTE: eigen(row, col) vs glm(col, row)
-		}
-	}
+	float const minScalarAlongV1 = obb.m_min[0];
+	float const minScalarAlongV2 = obb.m_min[1];
+	float const minScalarAlongV3 = obb.m_min[2];
 
-	// reference: https://stackoverflow.com/questions/50458712/c-find-eigenvalues-and-eigenvectors-of-matrix
-	Eigen::SelfAdjointEigenSolver<Eigen::Matrix3f> eigenSolver;
-	eigenSolver.compute(covMatEigen);
-	Eigen::Vector3f eigenValues = eigenSolver.eigenvalues(); //NOTE: eigenvalues come sorted in ascending order
-	Eigen::Matrix3f eigenVectors = eigenSolver.eigenvectors(); //NOTE: eigenvectors come sorted corresponding to returned eigenvalues and are normalized. This returned matrix also corresponds to P in the diagonalization formula A = P*D*P^-1. Here A =:= covariance matrix
-
-	// convert eigenvector forms (eigen -> glm)...
-	glm::vec3 eigenV1 = glm::vec3(eigenVectors(0, 0), eigenVectors(1, 0), eigenVectors(2, 0));
-	glm::vec3 eigenV2 = glm::vec3(eigenVectors(0, 1), eigenVectors(1, 1), eigenVectors(2, 1));
-	glm::vec3 eigenV3 = glm::vec3(eigenVectors(0, 2), eigenVectors(1, 2), eigenVectors(2, 2));
-
-	// find the 8 bounding vertices by finding the min/max coordinates of the projected points along each of the 3 mutually orthonormal eigenvectors that form our basis...
-	float minScalarAlongV1 = std::numeric_limits<float>::max();
-	float maxScalarAlongV1 = std::numeric_limits<float>::lowest();
-	float minScalarAlongV2 = std::numeric_limits<float>::max();
-	float maxScalarAlongV2 = std::numeric_limits<float>::lowest();
-	float minScalarAlongV3 = std::numeric_limits<float>::max();
-	float maxScalarAlongV3 = std::numeric_limits<float>::lowest();
-	for (glm::vec3 const& p : pointSetM) {
-		// project along eigenV1 axis...
-		float const projScalarV1 = glm::dot(p, eigenV1) / glm::length2(eigenV1);
-		if (projScalarV1 < minScalarAlongV1) minScalarAlongV1 = projScalarV1;
-		if (projScalarV1 > maxScalarAlongV1) maxScalarAlongV1 = projScalarV1;
-
-		// project along eigenV2 axis...
-		float const projScalarV2 = glm::dot(p, eigenV2) / glm::length2(eigenV2);
-		if (projScalarV2 < minScalarAlongV2) minScalarAlongV2 = projScalarV2;
-		if (projScalarV2 > maxScalarAlongV2) maxScalarAlongV2 = projScalarV2;
-
-		// project along eigenV3 axis...
-		float const projScalarV3 = glm::dot(p, eigenV3) / glm::length2(eigenV3);
-		if (projScalarV3 < minScalarAlongV3) minScalarAlongV3 = projScalarV3;
-		if (projScalarV3 > maxScalarAlongV3) maxScalarAlongV3 = projScalarV3;
-	}
-
-	// 5.5 sort basis vectors (v3 >= v2 >= V1)...
-	std::vector<SortableAxis> axes = { SortableAxis(eigenV1, minScalarAlongV1, maxScalarAlongV1), SortableAxis(eigenV2, minScalarAlongV2, maxScalarAlongV2), SortableAxis(eigenV3, minScalarAlongV3, maxScalarAlongV3) };
-	std::sort(axes.begin(), axes.end());
-
-	eigenV1 = axes.at(0).m_axis;
-	eigenV2 = axes.at(1).m_axis;
-	eigenV3 = axes.at(2).m_axis;
-
-	minScalarAlongV1 = axes.at(0).m_min;
-	minScalarAlongV2 = axes.at(1).m_min;
-	minScalarAlongV3 = axes.at(2).m_min;
-
-	maxScalarAlongV1 = axes.at(0).m_max;
-	maxScalarAlongV2 = axes.at(1).m_max;
-	maxScalarAlongV3 = axes.at(2).m_max;
+	float const maxScalarAlongV1 = obb.m_max[0];
+	float const maxScalarAlongV2 = obb.m_max[1];
+	float const maxScalarAlongV3 = obb.m_max[2];
 
 	// 6. compute a cubic voxel size (side length)...
 	float const avgExtent = ((maxScalarAlongV1 - minScalarAlongV1) + (maxScalarAlongV2 - minScalarAlongV2) + (maxScalarAlongV3 - minScalarAlongV3)) / 3;
-	float const voxelSize = avgExtent / 100; // NOTE: increase denominator in order to increase voxel resolution (voxel count) - NOTE: that scaling the denom causes a cubic scale to the voxel count (so RAM explodes pretty quickly)
+	float const voxelSize = avgExtent / m_voxelResolution; // NOTE: increase m_voxelResolution in order to increase voxel count - NOTE: that scaling it causes a cubic scale to the voxel count (so RAM explodes pretty quickly)
 	m_voxelSize = voxelSize;
 
 	// 7. voxelize our OBB into a slightly larger 3D grid of cubes...
@@ -1124,26 +1311,12 @@ std::vector<glm::vec3> Program::generatePointSetP2(MeshObject &out_obb, MeshObje
 	float const expandedMinScalarAlongV3 = midScalarAlongV3 - expandedHalfExtentV3;
 	float const expandedMaxScalarAlongV3 = midScalarAlongV3 + expandedHalfExtentV3;
 
-	// coloured voxel array (BLACK =:= OUTER (default), CYAN =:= FEATURE, MAGENTA =:= INNER)
-	// those colours can be assigned later if we want to render the voxels, but for now treat BLACK == 0, CYAN == 1, MAGENTA = 2
-
-	unsigned int const OUTER_BLACK = 0;
-	unsigned int const FEATURE_CYAN = 1;
-	unsigned int const INNER_MAGENTA = 2;
-
 	unsigned int const nV1 = 2 * voxelCountAlongHalfV1;
 	unsigned int const nV2 = 2 * voxelCountAlongHalfV2;
 	unsigned int const nV3 = 2 * voxelCountAlongHalfV3;
 
-	//TODO: fix the inner voxel issue
-	// either 0, 1, or 2
-	std::vector<std::vector<std::vector<unsigned int>>> voxelClasses(nV3, std::vector<std::vector<unsigned int>>(nV2, std::vector<unsigned int>(nV1, OUTER_BLACK)));
-	//NOTE: below, this 3D array maps voxel [V3][V2][V1] with either glm::vec3(0.0f, 0.0f, 0.0f) or another non-zero vec3.
-	//~~~~~ this vec3 will be non-zero if this voxel is found to be a FEATURE VOXEL (meaning it has intersected at least 1 triangle face of model).
-	//~~~~~ if this feature voxel is found to intersect multiple triangle faces, then this vec3 is taken as the trivial average of the face normals (normalized sum of them)
-	//TODO: there is a known issue with some voxels being wrongly marker INNER, this is likely due to the wrong normal being considered since we just take the average right now
-	//~~~~~ this can be fixed/improved by instead using the face normal with intersection point with smallest projected scalar along eigenV1 (scan direction)
-	std::vector<std::vector<std::vector<glm::vec3>>> voxelIntersectedFaceAvgNormals(nV3, std::vector<std::vector<glm::vec3>>(nV2, std::vector<glm::vec3>(nV1, glm::vec3(0.0f, 0.0f, 0.0f))));
+	// packed voxel class grid, every voxel starts as OUTER (see VoxelGrid.h for the colour meanings)
+	VoxelGrid voxelGrid(nV1, nV2, nV3);
 
 	// 8. CLASSIFY FEATURE VOXELS...
 
@@ -1156,20 +1329,34 @@ std::vector<glm::vec3> Program::generatePointSetP2(MeshObject &out_obb, MeshObje
 
 		// project these 3 points into OBB frame (measured by scalars along each of the 3 basis eigenvectors)...
 		// .x will be eigenV1 scalar, .y is V2, .z is V3
-		glm::vec3 const tV1 = glm::vec3(glm::dot(tV1xyz, eigenV1) / glm::length2(eigenV1), glm::dot(tV1xyz, eigenV2) / glm::length2(eigenV2), glm::dot(tV1xyz, eigenV3) / glm::length2(eigenV3));
-		glm::vec3 const tV2 = glm::vec3(glm::dot(tV2xyz, eigenV1) / glm::length2(eigenV1), glm::dot(tV2xyz, eigenV2) / glm::length2(eigenV2), glm::dot(tV2xyz, eigenV3) / glm::length2(eigenV3));
-		glm::vec3 const tV3 = glm::vec3(glm::dot(tV3xyz, eigenV1) / glm::length2(eigenV1), glm::dot(tV3xyz, eigenV2) / glm::length2(eigenV2), glm::dot(tV3xyz, eigenV3) / glm::length2(eigenV3));
+		//NOTE: the basis vectors are normalized, so each scalar is just a dot product
+		glm::vec3 const tV1 = glm::vec3(glm::dot(tV1xyz, eigenV1), glm::dot(tV1xyz, eigenV2), glm::dot(tV1xyz, eigenV3));
+		glm::vec3 const tV2 = glm::vec3(glm::dot(tV2xyz, eigenV1), glm::dot(tV2xyz, eigenV2), glm::dot(tV2xyz, eigenV3));
+		glm::vec3 const tV3 = glm::vec3(glm::dot(tV3xyz, eigenV1), glm::dot(tV3xyz, eigenV2), glm::dot(tV3xyz, eigenV3));
 
 		// DISCRETIZE TRIANGLE FACE BY BARYCENTRIC COORDS...
 
-		//NOTE: this will be susceptible to duplicates
+		//NOTE: this will be susceptible to duplicates (harmless, since marking a voxel as FEATURE twice does nothing)
 		//TODO: make sure bounds actually are [0, 1] exactly (rather than stopping short before 1) - should be done now
 
+		// NOW FOR EVERY TRIANGLE POINT...
+		// check voxel its in (by mapping formula) and mark FEATURE VOXEL
+		// inverse mapping formula (position to voxel index)
+		// i on V3, j on V2, k on V1
+		auto markFeatureVoxel = [&](glm::vec3 const& tPt) {
+			// inverse map back to indices i,j,k (single voxel)...
+			//NOTE: clamped to the grid, a point on the far boundary would otherwise floor to index == dimension (VoxelGrid::set doesn't check bounds)
+			unsigned int const indexI = (unsigned int)glm::clamp((int)glm::floor((tPt.z - expandedMinScalarAlongV3) / voxelSize), 0, (int)voxelGrid.getNV3() - 1);
+			unsigned int const indexJ = (unsigned int)glm::clamp((int)glm::floor((tPt.y - expandedMinScalarAlongV2) / voxelSize), 0, (int)voxelGrid.getNV2() - 1);
+			unsigned int const indexK = (unsigned int)glm::clamp((int)glm::floor((tPt.x - expandedMinScalarAlongV1) / voxelSize), 0, (int)voxelGrid.getNV1() - 1);
+
+			voxelGrid.set(indexI, indexJ, indexK, VoxelClass::FEATURE_CYAN);
+		};
+
 		// NOTE: all these points will be in OBB space
-		std::vector<glm::vec3> discreteTrianglePts;
-		discreteTrianglePts.push_back(tV1);
-		discreteTrianglePts.push_back(tV2);
-		discreteTrianglePts.push_back(tV3);
+		markFeatureVoxel(tV1);
+		markFeatureVoxel(tV2);
+		markFeatureVoxel(tV3);
 
 		float const du = voxelSize / (glm::distance(tV1, glm::proj(tV1, tV3 - tV2)));
 		float const dv = voxelSize / (glm::distance(tV2, glm::proj(tV2, tV3 - tV1)));
@@ -1177,114 +1364,32 @@ std::vector<glm::vec3> Program::generatePointSetP2(MeshObject &out_obb, MeshObje
 		for (float u = 0.0f; u <= 1.0f; u += glm::min<float>(du, 1.0f - u > 0.0f ? 1.0f - u : du)) {
 			for (float v = 0.0f; v <= 1.0f - u; v += glm::min<float>(dv, 1.0f - u - v > 0.0f ? 1.0f - u - v : dv)) {
 				float const w = 1.0f - u - v;
-				discreteTrianglePts.push_back(u * tV1 + v * tV2 + w * tV3);
+				markFeatureVoxel(u * tV1 + v * tV2 + w * tV3);
 			}
 		}
+	}
 
-		// NOW FOR EVERY TRIANGLE POINT...
-		// check voxel its in (by mapping formula) and mark FEATURE VOXEL, add to list of considered voxels for this tri-face and if not already considered add this face normal as contribution
-		// inverse mapping formula (position to voxel index)
-		// i on V3, j on V2, k on V1
-		// storing already considered (by this face) feature voxels as vec3(i,j,k)
-
-		std::vector<glm::vec3> consideredVoxels;
-		for (glm::vec3 const& tPt : discreteTrianglePts) {
-			// inverse map back to indices i,j,k (single voxel)...
-
-			unsigned int const indexI = glm::floor((tPt.z - expandedMinScalarAlongV3) / voxelSize);
-			unsigned int const indexJ = glm::floor((tPt.y - expandedMinScalarAlongV2) / voxelSize);
-			unsigned int const indexK = glm::floor((tPt.x - expandedMinScalarAlongV1) / voxelSize);
-
-			glm::vec3 const intersectedVoxel = glm::vec3(indexI, indexJ, indexK);
-			auto it = std::find(consideredVoxels.begin(), consideredVoxels.end(), intersectedVoxel);
-			if (consideredVoxels.end() == it) { // new considered voxel
-
-				// mark voxel as FEATURE...
-				voxelClasses.at(indexI).at(indexJ).at(indexK) = FEATURE_CYAN;
-
-				// contribute this face's normal to voxel
-				voxelIntersectedFaceAvgNormals.at(indexI).at(indexJ).at(indexK) += m_model->faceNormals.at(f / 3);
+	// 9. CLASSIFY INNER VOXELS (EXTERIOR FLOOD FILL)...
+	// everything not reachable from the grid boundary without crossing a feature voxel is INNER
+	voxelGrid.classifyInnerVoxels();
 
-				// mark voxel as considered by this tri-face
-				consideredVoxels.push_back(intersectedVoxel);
-			}
-		}
-	}
+	// 10. GENERATE THE POINT SET P = {MODEL VERTS} + {INNER VOXEL BARYCENTRES} + {FEATURE VOXEL BARYCENTRES}...
+	//NOTE: i'm including feature voxels as well (differ from paper) since inner voxels may not exist for skinny parts of model (e.g. long skinny triangle faces)
 
-	// 8.5. foreach voxel, normalize (avg) the contributed face normals
+	std::vector<glm::vec3> pointSetP = pointSetM; // copy all unique model verts into our new set
 
+	// add INNER/FEATURE VOXEL BARYCENTRES...
 	// per voxel...
 	for (unsigned int i = 0; i < nV3; ++i) {
 		for (unsigned int j = 0; j < nV2; ++j) {
 			for (unsigned int k = 0; k < nV1; ++k) {
-				// if voxel was marked as FEATURE...
-				if (FEATURE_CYAN == voxelClasses.at(i).at(j).at(k)) {
-					//TODO: make sure the tri-face normals weren't symbolic 0 vector due to being really small???
-					voxelIntersectedFaceAvgNormals.at(i).at(j).at(k) = glm::normalize(voxelIntersectedFaceAvgNormals.at(i).at(j).at(k));
-				}
-			}
-		}
-	}
-
-	// 9. CLASSIFY INNER VOXELS (SCAN-ALGORITHM)...
-	// reference: http://blog.wolfire.com/2009/11/Triangle-mesh-voxelization
-	for (unsigned int i = 0; i < nV3; ++i) {
-		for (unsigned int j = 0; j < nV2; ++j) {
-			std::vector<glm::vec3> voxelStore;
-
-			// find start/end feature voxels in this line...
-			// voxels outside of these bounds have to remain outer voxels
-			bool foundMin = false;
-			unsigned int minK = 0;
-			unsigned int maxK = 0;
-
-			for (unsigned int k = 0; k < nV1; ++k) {
-				if (FEATURE_CYAN == voxelClasses.at(i).at(j).at(k)) {
-					maxK = k;
-					if (!foundMin) {
-						minK = k;
-						foundMin = true;
-					}
-				}
-			}
-
-			for (unsigned int k = minK; k <= maxK; ++k) {
-				// DIRECTION OF SCAN VECTOR IS eigenV1 basis vector
-
-				if (FEATURE_CYAN == voxelClasses.at(i).at(j).at(k)) {
-					if (glm::dot(voxelIntersectedFaceAvgNormals.at(i).at(j).at(k), eigenV1) > 0.0f) {
-
-						// mark all stored voxels as inner...
-						for (glm::vec3 const& voxel : voxelStore) {
-							voxelClasses.at(voxel.x).at(voxel.y).at(voxel.z) = INNER_MAGENTA;
-						}
-					}
-					voxelStore.clear();
-				}
-				else {
-					voxelStore.push_back(glm::vec3(i, j, k));
-				}
-			}
-		}
-	}
-
-	// 10. GENERATE THE POINT SET P = {MODEL VERTS} + {INNER VOXEL BARYCENTRES} + {FEATURE VOXEL BARYCENTRES}...
-	//NOTE: i'm including feature voxels as well (differ from paper) since inner voxels may not exist for skinny parts of model (e.g. long skinny triangle faces)
-
-	std::vector<glm::vec3> pointSetP = pointSetM; // copy all unique model verts into our new set
-
-	// add INNER/FEATURE VOXEL BARYCENTRES...
-	// per voxel...
-	for (unsigned int i = 0; i < nV3; ++i) {
-		for (unsigned int j = 0; j < nV2; ++j) {
-			for (unsigned int k = 0; k < nV1; ++k) {
-				// if voxel was marked as INNER/FEATURE...
-				if (INNER_MAGENTA == voxelClasses.at(i).at(j).at(k) || FEATURE_CYAN == voxelClasses.at(i).at(j).at(k)) {
-					float const v1Coord = (k + 0.5) * voxelSize + expandedMinScalarAlongV1;
-					float const v2Coord = (j + 0.5) * voxelSize + expandedMinScalarAlongV2;
-					float const v3Coord = (i + 0.5) * voxelSize + expandedMinScalarAlongV3;
-					glm::vec3 const barycentre = v1Coord * eigenV1 + v2Coord * eigenV2 + v3Coord * eigenV3;
-					pointSetP.push_back(barycentre);
+				// if voxel was marked as INNER/FEATURE...
+				if (VoxelClass::OUTER_BLACK != voxelGrid.get(i, j, k)) {
+					float const v1Coord = (k + 0.5) * voxelSize + expandedMinScalarAlongV1;
+					float const v2Coord = (j + 0.5) * voxelSize + expandedMinScalarAlongV2;
+					float const v3Coord = (i + 0.5) * voxelSize + expandedMinScalarAlongV3;
+					glm::vec3 const barycentre = v1Coord * eigenV1 + v2Coord * eigenV2 + v3Coord * eigenV3;
+					pointSetP.push_back(barycentre);
 				}
 			}
 		}
@@ -1380,110 +1485,142 @@ std::vector<glm::vec3> Program::generatePointSetP2(MeshObject &out_obb, MeshObje
 
 
 
-/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// replaces the current cage (if any) with a generated one and sets it up for rendering/picking
+void Program::assignGeneratedCage(std::vector<glm::vec3> const& verts, std::vector<GLuint> const& faces) {
+	// clear old cage if any...
+	clearCage();
 
-std::vector<std::vector<std::vector<unsigned int>>> Program::generateOBBSpace(std::vector<glm::vec3> const& pointSetP) {
-	if (pointSetP.empty()) return std::vector<std::vector<std::vector<unsigned int>>>();
+	m_cage = std::make_shared<MeshObject>();
+	m_cage->drawVerts = verts;
+	m_cage->drawFaces = faces;
+
+	// init vert colours (uniform light grey for now)
+	for (unsigned int i = 0; i < m_cage->drawVerts.size(); ++i) {
+		m_cage->colours.push_back(glm::vec3(0.8f, 0.8f, 0.8f));
+	}
+
+	// set cage black...
+	for (unsigned int i = 0; i < m_cage->colours.size(); ++i) {
+		m_cage->colours.at(i) = s_CAGE_UNSELECTED_COLOUR;
+	}
+	m_cage->m_polygonMode = PolygonMode::LINE; // set wireframe
+	m_cage->m_renderPoints = true; // hack to render the cage as points as well (2nd polygon mode)
+	m_cageSelection.reset(m_cage->drawVerts.size());
 
-	glm::vec3 eigenV1 = glm::vec3(0.0f, 0.0f, 0.0f);
-	glm::vec3 eigenV2 = glm::vec3(0.0f, 0.0f, 0.0f);
-	glm::vec3 eigenV3 = glm::vec3(0.0f, 0.0f, 0.0f);
+	meshObjects.push_back(m_cage);
+	renderEngine->assignBuffers(*m_cage);
+	m_isCageGenerated = true;
+}
 
-	// recompute OBB, get 3 new axes that will be used for everything in the future...
-	// 1. generate OBB of point set P using Principal Component Analysis...
-
-	// low covariance of 2 values means more independent (less correlated)
-	// covariance(x,x) = variance(x)
-	// covariance matrix A generalizes the concept of variance in multiple dimensions
-	// we want to diagonalize the covariance matrix to make signals strong (big diagonal entries) and distortions weak (low (in this case 0) off-diagonal entries)
-	// A is REAL and SYMMETRIC ===> guaranteed to have 3 eigenvectors in the similarity transformation (change of basis matrix) when we diagonalize A.
-	// THE 3 EIGENVECTORS OF COVARIANCE MATRIX WILL MAKE UP ORIENTATION OF OBB
-	// large eigenvalues mean large variance, thus align OBB along eigenvector corresponding to largest eigenvalue
-
-	//TODO: could improve this algo by working on the convex hull points only (but it might not be worth it)
-	//TODO: could improve this program by using a more exact OBB method (slower) for low vert count models.
-
-	// reference: https://stackoverflow.com/questions/6189229/creating-oobb-from-points
-	// 2. compute centroid mu of points...
-	glm::vec3 mu = glm::vec3(0.0f, 0.0f, 0.0f);
-	for (glm::vec3 const& p : pointSetP) {
-		mu += p;
+
+
+// MESH SIMPLIFICATION CAGE...
+// 1. weld the model's verts by position (the loader splits verts along uv/normal seams) and build a half-edge mesh
+// 2. offset the surface outward - either as the iso-surface of the model's signed distance field (robust, but resamples the surface on the voxel grid) or along the vert normals (can self-intersect in concave regions)
+// 3. QEM decimation down to the target vert count, only allowing collapses that keep the cage enclosing the offset surface
+//NOTE: needs a closed, manifold model
+void Program::generateCageSimplified() {
+	if (nullptr == m_model) return;
+
+	// 1. weld...
+	std::vector<glm::vec3> verts;
+	std::vector<unsigned int> faceIndices;
+	//NOTE: linear time - each position is looked up in a hash map over its float bits (-0 is folded into +0, so equal positions always match)
+	IndexHashMap<glm::uvec3> vertIndices(m_model->drawVerts.size());
+	std::vector<unsigned int> remap(m_model->drawVerts.size());
+	for (unsigned int i = 0; i < m_model->drawVerts.size(); ++i) {
+		glm::vec3 const position = m_model->drawVerts.at(i) + glm::vec3(0.0f, 0.0f, 0.0f);
+		glm::uvec3 key;
+		std::memcpy(&key.x, &position.x, sizeof(key));
+
+		bool isNew = false;
+		remap.at(i) = vertIndices.findOrInsert(key, (unsigned int)verts.size(), isNew);
+		if (isNew) verts.push_back(m_model->drawVerts.at(i));
+	}
+	for (unsigned int f = 0; f + 2 < m_model->drawFaces.size(); f += 3) {
+		unsigned int const a = remap.at(m_model->drawFaces.at(f + 0));
+		unsigned int const b = remap.at(m_model->drawFaces.at(f + 1));
+		unsigned int const c = remap.at(m_model->drawFaces.at(f + 2));
+		if (a == b || b == c || c == a) continue; // collapsed by the weld
+		faceIndices.push_back(a);
+		faceIndices.push_back(b);
+		faceIndices.push_back(c);
+	}
+
+	HalfEdgeMesh mesh;
+	if (!mesh.build(verts, faceIndices)) {
+		std::cout << "ERROR (Program.cpp) - mesh simplification needs a closed, manifold model" << std::endl;
+		return;
 	}
-	mu /= pointSetP.size();
 
-	// 3. compute covariance matrix...
-	glm::mat3 covarianceMatrix = glm::mat3(0.0f);
-	for (glm::vec3 const& p : pointSetP) {
-		glm::vec3 const dev = p - mu;
-		glm::mat3 const covMat_i = glm::outerProduct(dev, dev); // dev * (dev)^T
-		covarianceMatrix += covMat_i;
+	// 2. offset...
+	glm::vec3 minCorner(std::numeric_limits<float>::max());
+	glm::vec3 maxCorner(std::numeric_limits<float>::lowest());
+	for (glm::vec3 const& p : verts) {
+		minCorner = glm::min(minCorner, p);
+		maxCorner = glm::max(maxCorner, p);
 	}
-	//NOTE: this matrix should be REAL and SYMMETRIC
+	float const offset = m_simplificationOffset * glm::length(maxCorner - minCorner);
 
-	// 4. get sorted eigenvalues (ascending) + corresponding eigenvectors...
+	if (m_useSDFOffset) {
+		//NOTE: same OBB and voxel size as the voxel cage generator, so m_voxelResolution controls the resolution of the offset surface too
+		OBB const obb = OBBTools::fitOBB(verts, m_obbFitOptions);
+		float const voxelSize = ((obb.getExtent(0) + obb.getExtent(1) + obb.getExtent(2)) / 3.0f) / m_voxelResolution;
 
-	// convert matrix form (glm -> eigen) to work with eigensolver...
-	Eigen::Matrix3f covMatEigen;
-	for (unsigned int i = 0; i < covarianceMatrix.length(); ++i) { // loop over columns
-		for (unsigned int j = 0; j < covarianceMatrix[i].length(); ++j) { // loop over rows
-			covMatEigen(j, i) = covarianceMatrix[i][j]; //NOTE: eigen(row, col) vs glm(col, row)
+		SignedDistanceField sdf;
+		if (!sdf.build(verts, faceIndices, GridFrame::aroundOBB(obb, voxelSize, offset + 2.0f * voxelSize))) return;
+
+		std::vector<glm::vec3> offsetVerts;
+		std::vector<unsigned int> offsetFaces;
+		sdf.extractSurface(offset, offsetVerts, offsetFaces);
+		if (!mesh.build(offsetVerts, offsetFaces)) {
+			std::cout << "ERROR (Program.cpp) - offset surface isn't a closed, manifold mesh" << std::endl;
+			return;
 		}
 	}
+	else {
+		MeshSimplifier::offsetAlongNormals(mesh, offset);
+	}
 
-	// reference: https://stackoverflow.com/questions/50458712/c-find-eigenvalues-and-eigenvectors-of-matrix
-	Eigen::SelfAdjointEigenSolver<Eigen::Matrix3f> eigenSolver;
-	eigenSolver.compute(covMatEigen);
-	Eigen::Vector3f eigenValues = eigenSolver.eigenvalues(); //NOTE: eigenvalues come sorted in ascending order
-	Eigen::Matrix3f eigenVectors = eigenSolver.eigenvectors(); //NOTE: eigenvectors come sorted corresponding to returned eigenvalues and are normalized. This returned matrix also corresponds to P in the diagonalization formula A = P*D*P^-1. Here A =:= covariance matrix
-
-	// convert eigenvector forms (eigen -> glm)...
-	eigenV1 = glm::vec3(eigenVectors(0, 0), eigenVectors(1, 0), eigenVectors(2, 0));
-	eigenV2 = glm::vec3(eigenVectors(0, 1), eigenVectors(1, 1), eigenVectors(2, 1));
-	eigenV3 = glm::vec3(eigenVectors(0, 2), eigenVectors(1, 2), eigenVectors(2, 2));
-
-	// find the 8 bounding vertices by finding the min/max coordinates of the projected points along each of the 3 mutually orthonormal eigenvectors that form our basis...
-	float minScalarAlongV1 = std::numeric_limits<float>::max();
-	float maxScalarAlongV1 = std::numeric_limits<float>::lowest();
-	float minScalarAlongV2 = std::numeric_limits<float>::max();
-	float maxScalarAlongV2 = std::numeric_limits<float>::lowest();
-	float minScalarAlongV3 = std::numeric_limits<float>::max();
-	float maxScalarAlongV3 = std::numeric_limits<float>::lowest();
-	for (glm::vec3 const& p : pointSetP) {
-		// project along eigenV1 axis...
-		float const projScalarV1 = glm::dot(p, eigenV1) / glm::length2(eigenV1);
-		if (projScalarV1 < minScalarAlongV1) minScalarAlongV1 = projScalarV1;
-		if (projScalarV1 > maxScalarAlongV1) maxScalarAlongV1 = projScalarV1;
+	// 3. decimate...
+	SimplifyOptions options;
+	options.m_targetVertCount = m_simplificationTargetVertCount;
+	options.m_keepEnclosing = true;
+	MeshSimplifier::simplify(mesh, options);
 
-		// project along eigenV2 axis...
-		float const projScalarV2 = glm::dot(p, eigenV2) / glm::length2(eigenV2);
-		if (projScalarV2 < minScalarAlongV2) minScalarAlongV2 = projScalarV2;
-		if (projScalarV2 > maxScalarAlongV2) maxScalarAlongV2 = projScalarV2;
+	std::vector<glm::vec3> cageVerts;
+	std::vector<unsigned int> cageFaces;
+	mesh.toTriangles(cageVerts, cageFaces);
+	assignGeneratedCage(cageVerts, cageFaces);
+}
 
-		// project along eigenV3 axis...
-		float const projScalarV3 = glm::dot(p, eigenV3) / glm::length2(eigenV3);
-		if (projScalarV3 < minScalarAlongV3) minScalarAlongV3 = projScalarV3;
-		if (projScalarV3 > maxScalarAlongV3) maxScalarAlongV3 = projScalarV3;
-	}
 
-	// 4.5 sort basis vectors (v3 >= v2 >= V1)...
-	std::vector<SortableAxis> axes = { SortableAxis(eigenV1, minScalarAlongV1, maxScalarAlongV1), SortableAxis(eigenV2, minScalarAlongV2, maxScalarAlongV2), SortableAxis(eigenV3, minScalarAlongV3, maxScalarAlongV3) };
-	std::sort(axes.begin(), axes.end());
 
-	eigenV1 = axes.at(0).m_axis;
-	eigenV2 = axes.at(1).m_axis;
-	eigenV3 = axes.at(2).m_axis;
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+std::vector<std::vector<std::vector<unsigned int>>> Program::generateOBBSpace(std::vector<glm::vec3> const& pointSetP) {
+	if (pointSetP.empty()) return std::vector<std::vector<std::vector<unsigned int>>>();
+
+	// recompute OBB, get 3 new axes that will be used for everything in the future...
+	// 1. generate OBB of point set P using Principal Component Analysis (see OBBTools)...
+	OBB const obb = OBBTools::fitOBB(pointSetP, m_obbFitOptions);
+
+	//NOTE: basis vectors come sorted (v3 >= v2 >= V1)
+	glm::vec3 const eigenV1 = obb.m_axes[0];
+	glm::vec3 const eigenV2 = obb.m_axes[1];
+	glm::vec3 const eigenV3 = obb.m_axes[2];
 
 	m_eigenV1 = eigenV1;
 	m_eigenV2 = eigenV2;
 	m_eigenV3 = eigenV3;
 
-	minScalarAlongV1 = axes.at(0).m_min;
-	minScalarAlongV2 = axes.at(1).m_min;
-	minScalarAlongV3 = axes.at(2).m_min;
+	float const minScalarAlongV1 = obb.m_min[0];
+	float const minScalarAlongV2 = obb.m_min[1];
+	float const minScalarAlongV3 = obb.m_min[2];
 
-	maxScalarAlongV1 = axes.at(0).m_max;
-	maxScalarAlongV2 = axes.at(1).m_max;
-	maxScalarAlongV3 = axes.at(2).m_max;
+	float const maxScalarAlongV1 = obb.m_max[0];
+	float const maxScalarAlongV2 = obb.m_max[1];
+	float const maxScalarAlongV3 = obb.m_max[2];
 
 	// 5. use voxel size of initial OBB and the parition length (side length)... 
 	float const voxelSize = m_voxelSize;
@@ -1530,7 +1667,8 @@ std::vector<std::vector<std::vector<unsigned int>>> Program::generateOBBSpace(st
 
 		// project the point into OBB frame (measured by scalars along each of the 3 basis eigenvectors)...
 		// .x will be eigenV1 scalar, .y is V2, .z is V3
-		glm::vec3 const pLocal = glm::vec3(glm::dot(p, eigenV1) / glm::length2(eigenV1), glm::dot(p, eigenV2) / glm::length2(eigenV2), glm::dot(p, eigenV3) / glm::length2(eigenV3));
+		//NOTE: the basis vectors are normalized, so each scalar is just a dot product
+		glm::vec3 const pLocal = glm::vec3(glm::dot(p, eigenV1), glm::dot(p, eigenV2), glm::dot(p, eigenV3));
 
 		// check voxel its in (by mapping formula)
 		// inverse mapping formula (position to voxel index)
@@ -1552,84 +1690,17 @@ std::vector<std::vector<std::vector<unsigned int>>> Program::generateOBBSpace(st
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-MeshTree Program::terminateMeshTree(unsigned int const minV1Index, unsigned int const maxV1Index, unsigned int const minV2Index, unsigned int const maxV2Index, unsigned int const minV3Index, unsigned int const maxV3Index) {
-	MeshTree meshTree;
-
-	//NOTE: must add 1 to max index to handle ceiling of bounding volume
-	meshTree.m_vertexCoords.push_back(glm::vec3(minV1Index, minV2Index, minV3Index));
-	meshTree.m_vertexCoords.push_back(glm::vec3(minV1Index, minV2Index, maxV3Index+1));
-	meshTree.m_vertexCoords.push_back(glm::vec3(minV1Index, maxV2Index+1, minV3Index));
-	meshTree.m_vertexCoords.push_back(glm::vec3(minV1Index, maxV2Index+1, maxV3Index+1));
-	meshTree.m_vertexCoords.push_back(glm::vec3(maxV1Index+1, minV2Index, minV3Index));
-	meshTree.m_vertexCoords.push_back(glm::vec3(maxV1Index+1, minV2Index, maxV3Index+1));
-	meshTree.m_vertexCoords.push_back(glm::vec3(maxV1Index+1, maxV2Index+1, minV3Index));
-	meshTree.m_vertexCoords.push_back(glm::vec3(maxV1Index+1, maxV2Index+1, maxV3Index+1));
-
-	//TODO: idk the proper order of V1 x V2 x V3 for right-hand-rule, but thats to be figured out
-	//THUS THE WINDING HERE MIGHT BE SCREWED UP!
-
-	// FROM 0 (000)
-
-	meshTree.m_faceIndices.push_back(0);
-	meshTree.m_faceIndices.push_back(2);
-	meshTree.m_faceIndices.push_back(6);
-
-	meshTree.m_faceIndices.push_back(0);
-	meshTree.m_faceIndices.push_back(6);
-	meshTree.m_faceIndices.push_back(4);
-
-
-	meshTree.m_faceIndices.push_back(0);
-	meshTree.m_faceIndices.push_back(1);
-	meshTree.m_faceIndices.push_back(3);
-
-	meshTree.m_faceIndices.push_back(0);
-	meshTree.m_faceIndices.push_back(3);
-	meshTree.m_faceIndices.push_back(2);
-
-
-	meshTree.m_faceIndices.push_back(0);
-	meshTree.m_faceIndices.push_back(4);
-	meshTree.m_faceIndices.push_back(5);
-
-	meshTree.m_faceIndices.push_back(0);
-	meshTree.m_faceIndices.push_back(5);
-	meshTree.m_faceIndices.push_back(1);
-
-	// FROM 7 (111)
-
-	meshTree.m_faceIndices.push_back(7);
-	meshTree.m_faceIndices.push_back(3);
-	meshTree.m_faceIndices.push_back(1);
-
-	meshTree.m_faceIndices.push_back(7);
-	meshTree.m_faceIndices.push_back(1);
-	meshTree.m_faceIndices.push_back(5);
-
-
-	meshTree.m_faceIndices.push_back(7);
-	meshTree.m_faceIndices.push_back(5);
-	meshTree.m_faceIndices.push_back(4);
-
-	meshTree.m_faceIndices.push_back(7);
-	meshTree.m_faceIndices.push_back(4);
-	meshTree.m_faceIndices.push_back(6);
-
-
-	meshTree.m_faceIndices.push_back(7);
-	meshTree.m_faceIndices.push_back(6);
-	meshTree.m_faceIndices.push_back(2);
-
-	meshTree.m_faceIndices.push_back(7);
-	meshTree.m_faceIndices.push_back(2);
-	meshTree.m_faceIndices.push_back(3);
-
-	return meshTree;
+void Program::terminateMeshTree(unsigned int const minV1Index, unsigned int const maxV1Index, unsigned int const minV2Index, unsigned int const maxV2Index, unsigned int const minV3Index, unsigned int const maxV3Index, MeshTree &out_meshTree) {
+	LeafBox leafBox;
+	leafBox.m_min = glm::uvec3(minV1Index, minV2Index, minV3Index);
+	leafBox.m_max = glm::uvec3(maxV1Index, maxV2Index, maxV3Index);
+	out_meshTree.appendLeafBox(leafBox);
 }
 
 
 
-MeshTree Program::generateMeshTree(std::vector<std::vector<std::vector<unsigned int>>> const& obbSpace, unsigned int minV1Index, unsigned int maxV1Index, unsigned int minV2Index, unsigned int maxV2Index, unsigned int minV3Index, unsigned int maxV3Index, unsigned int const recursiveDepth) {
+// shrinks the bounds to the tight bounds of the (non-empty) voxels inside them
+void Program::trimMeshTreeBounds(std::vector<std::vector<std::vector<unsigned int>>> const& obbSpace, unsigned int &minV1Index, unsigned int &maxV1Index, unsigned int &minV2Index, unsigned int &maxV2Index, unsigned int &minV3Index, unsigned int &maxV3Index) {
 	// TRIMMING...
 	// we must resize the bounds to mimic an obb's tight bounds
 
@@ -1722,429 +1793,304 @@ MeshTree Program::generateMeshTree(std::vector<std::vector<std::vector<unsigned
 			break;
 		}
 	}
+}
+
 
-	////////////////////////////////////////////////////////////////////////////////////////
-	
-	// TERMINATE...
-	if (recursiveDepth >= m_maxRecursiveDepth) {
-		return terminateMeshTree(minV1Index, maxV1Index, minV2Index, maxV2Index, minV3Index, maxV3Index);
-	}
 
+// searches the axes (longest first) for a splice index, returns -1 if none of them should be split
+//NOTE: out_jumpScore is the slope of the biggest jump that was found (the higher, the more the box benefits from being split)
+int Program::searchForSplice(std::vector<std::vector<std::vector<unsigned int>>> const& obbSpace, unsigned int const minV1Index, unsigned int const maxV1Index, unsigned int const minV2Index, unsigned int const maxV2Index, unsigned int const minV3Index, unsigned int const maxV3Index, SplitAxis &out_splitAxis, float &out_jumpScore) {
 	//NOTE: obbSpace is indexed [i][j][k] for i in V3, j in V2, k in V1
 
-	// 0. preprocess order of axis-searching (search longest axis first)
-	unsigned int const extentV1 = maxV1Index - minV1Index;
-	unsigned int const extentV2 = maxV2Index - minV2Index;
-	unsigned int const extentV3 = maxV3Index - minV3Index;
+	out_splitAxis = SplitAxis::SPLIT_NONE;
+	out_jumpScore = std::numeric_limits<float>::lowest();
 
-	int spliceIndex = -1;
-	unsigned int const SPLIT_V1 = 1;
-	unsigned int const SPLIT_V2 = 2;
-	unsigned int const SPLIT_V3 = 3;
+	// 0. preprocess order of axis-searching (search longest axis first, ties in V1, V2, V3 order)
+	glm::uvec3 const minIndex(minV1Index, minV2Index, minV3Index);
+	glm::uvec3 const maxIndex(maxV1Index, maxV2Index, maxV3Index);
+	glm::uvec3 const extent = maxIndex - minIndex;
 
-	unsigned int lastAxisSearched = 0;
+	SplitAxis axisOrder[3] = { SplitAxis::SPLIT_V1, SplitAxis::SPLIT_V2, SplitAxis::SPLIT_V3 };
+	std::stable_sort(axisOrder, axisOrder + 3, [&extent](SplitAxis const a, SplitAxis const b) {
+		return extent[a - SplitAxis::SPLIT_V1] > extent[b - SplitAxis::SPLIT_V1];
+	});
 
-	unsigned int const l_min = glm::min<unsigned int>(extentV1, glm::min<unsigned int>(extentV2, extentV3));
-	unsigned int const l_max = glm::max<unsigned int>(extentV1, glm::max<unsigned int>(extentV2, extentV3));
+	unsigned int const l_min = glm::min<unsigned int>(extent.x, glm::min<unsigned int>(extent.y, extent.z));
+	unsigned int const l_max = glm::max<unsigned int>(extent.x, glm::max<unsigned int>(extent.y, extent.z));
 	float const t2 = ((float)l_min) / ((float)l_max);
 
-	if (extentV1 >= extentV2 && extentV1 >= extentV3) {
-		// search V1...
-		spliceIndex = searchForSpliceIndexOverV1(obbSpace, minV1Index, maxV1Index, minV2Index, maxV2Index, minV3Index, maxV3Index, t2);
-		lastAxisSearched = SPLIT_V1;
-
-		if (-1 == spliceIndex) {
-			if (extentV2 >= extentV3) {
-				// search V2...
-				spliceIndex = searchForSpliceIndexOverV2(obbSpace, minV1Index, maxV1Index, minV2Index, maxV2Index, minV3Index, maxV3Index, t2);
-				lastAxisSearched = SPLIT_V2;
-
-				if (-1 == spliceIndex) {
-					// search V3...
-					spliceIndex = searchForSpliceIndexOverV3(obbSpace, minV1Index, maxV1Index, minV2Index, maxV2Index, minV3Index, maxV3Index, t2);
-					lastAxisSearched = SPLIT_V3;
-				}
-			}
-			else {
-				// search V3...
-				spliceIndex = searchForSpliceIndexOverV3(obbSpace, minV1Index, maxV1Index, minV2Index, maxV2Index, minV3Index, maxV3Index, t2);
-				lastAxisSearched = SPLIT_V3;
-
-				if (-1 == spliceIndex) {
-					// search V2...
-					spliceIndex = searchForSpliceIndexOverV2(obbSpace, minV1Index, maxV1Index, minV2Index, maxV2Index, minV3Index, maxV3Index, t2);
-					lastAxisSearched = SPLIT_V2;
-				}
-			}
-		}
-	}
-	else if (extentV2 >= extentV1 && extentV2 >= extentV3) {
-		// search V2...
-		spliceIndex = searchForSpliceIndexOverV2(obbSpace, minV1Index, maxV1Index, minV2Index, maxV2Index, minV3Index, maxV3Index, t2);
-		lastAxisSearched = SPLIT_V2;
-
-		if (-1 == spliceIndex) {
-			if (extentV1 >= extentV3) {
-				// search V1...
-				spliceIndex = searchForSpliceIndexOverV1(obbSpace, minV1Index, maxV1Index, minV2Index, maxV2Index, minV3Index, maxV3Index, t2);
-				lastAxisSearched = SPLIT_V1;
-
-				if (-1 == spliceIndex) {
-					// search V3...
-					spliceIndex = searchForSpliceIndexOverV3(obbSpace, minV1Index, maxV1Index, minV2Index, maxV2Index, minV3Index, maxV3Index, t2);
-					lastAxisSearched = SPLIT_V3;
-				}
-			}
-			else {
-				// search V3...
-				spliceIndex = searchForSpliceIndexOverV3(obbSpace, minV1Index, maxV1Index, minV2Index, maxV2Index, minV3Index, maxV3Index, t2);
-				lastAxisSearched = SPLIT_V3;
-
-				if (-1 == spliceIndex) {
-					// search V1...
-					spliceIndex = searchForSpliceIndexOverV1(obbSpace, minV1Index, maxV1Index, minV2Index, maxV2Index, minV3Index, maxV3Index, t2);
-					lastAxisSearched = SPLIT_V1;
-				}
-			}
-		}
-	}
-	else {
-		// search V3...
-		spliceIndex = searchForSpliceIndexOverV3(obbSpace, minV1Index, maxV1Index, minV2Index, maxV2Index, minV3Index, maxV3Index, t2);
-		lastAxisSearched = SPLIT_V3;
-
-		if (-1 == spliceIndex) {
-			if (extentV1 >= extentV2) {
-				// search V1...
-				spliceIndex = searchForSpliceIndexOverV1(obbSpace, minV1Index, maxV1Index, minV2Index, maxV2Index, minV3Index, maxV3Index, t2);
-				lastAxisSearched = SPLIT_V1;
-
-				if (-1 == spliceIndex) {
-					// search V2...
-					spliceIndex = searchForSpliceIndexOverV2(obbSpace, minV1Index, maxV1Index, minV2Index, maxV2Index, minV3Index, maxV3Index, t2);
-					lastAxisSearched = SPLIT_V2;
-				}
-			}
-			else {
-				// search V2...
-				spliceIndex = searchForSpliceIndexOverV2(obbSpace, minV1Index, maxV1Index, minV2Index, maxV2Index, minV3Index, maxV3Index, t2);
-				lastAxisSearched = SPLIT_V2;
-
-				if (-1 == spliceIndex) {
-					// search V1...
-					spliceIndex = searchForSpliceIndexOverV1(obbSpace, minV1Index, maxV1Index, minV2Index, maxV2Index, minV3Index, maxV3Index, t2);
-					lastAxisSearched = SPLIT_V1;
-				}
-			}
-		}
-	}
-
-	// TERMINATE...
-	if (-1 == spliceIndex) {
-		return terminateMeshTree(minV1Index, maxV1Index, minV2Index, maxV2Index, minV3Index, maxV3Index);
-	}
-
-
-	// SPLICE...
-	if (SPLIT_V1 == lastAxisSearched) {
-		MeshTree lowMeshTree = generateMeshTree(obbSpace, minV1Index, spliceIndex, minV2Index, maxV2Index, minV3Index, maxV3Index, recursiveDepth + 1);
-		MeshTree highMeshTree = generateMeshTree(obbSpace, spliceIndex + 1, maxV1Index, minV2Index, maxV2Index, minV3Index, maxV3Index, recursiveDepth + 1);
-
-		// REMOVE FACES ALONG SPLIT PLANE...
-/*
-		std::vector<unsigned int> tempFacesLow;
-		for (unsigned int f = 0; f < lowMeshTree.m_faceIndices.size(); f += 3) {
-			if ((spliceIndex+1) == lowMeshTree.m_vertexCoords.at(lowMeshTree.m_faceIndices.at(f)).x && (spliceIndex + 1) == lowMeshTree.m_vertexCoords.at(lowMeshTree.m_faceIndices.at(f + 1)).x && (spliceIndex + 1) == lowMeshTree.m_vertexCoords.at(lowMeshTree.m_faceIndices.at(f + 2)).x) {
-				// REMOVE FACE (3 indices)...
-				// by not adding them
-			}
-			else {
-				tempFacesLow.push_back(lowMeshTree.m_faceIndices.at(f));
-				tempFacesLow.push_back(lowMeshTree.m_faceIndices.at(f+1));
-				tempFacesLow.push_back(lowMeshTree.m_faceIndices.at(f+2));
-			}
-		}
-		lowMeshTree.m_faceIndices = tempFacesLow;
+	// 1. build the cross-section area profile along every axis in a single pass over the box
+	std::vector<unsigned int> profiles[3];
+	for (unsigned int a = 0; a < 3; ++a) profiles[a].assign(extent[a] + 1, 0);
 
-		std::vector<unsigned int> tempFacesHigh;
-		for (unsigned int f = 0; f < highMeshTree.m_faceIndices.size(); f += 3) {
-			if ((spliceIndex + 1) == highMeshTree.m_vertexCoords.at(highMeshTree.m_faceIndices.at(f)).x && (spliceIndex + 1) == highMeshTree.m_vertexCoords.at(highMeshTree.m_faceIndices.at(f + 1)).x && (spliceIndex + 1) == highMeshTree.m_vertexCoords.at(highMeshTree.m_faceIndices.at(f + 2)).x) {
-				// REMOVE FACE (3 indices)...
-				// by not adding them
-			}
-			else {
-				tempFacesHigh.push_back(highMeshTree.m_faceIndices.at(f));
-				tempFacesHigh.push_back(highMeshTree.m_faceIndices.at(f + 1));
-				tempFacesHigh.push_back(highMeshTree.m_faceIndices.at(f + 2));
+	for (unsigned int i = minV3Index; i <= maxV3Index; ++i) {
+		for (unsigned int j = minV2Index; j <= maxV2Index; ++j) {
+			std::vector<unsigned int> const& row = obbSpace.at(i).at(j);
+			unsigned int rowArea = 0;
+			for (unsigned int k = minV1Index; k <= maxV1Index; ++k) {
+				profiles[0].at(k - minV1Index) += row.at(k);
+				rowArea += row.at(k);
 			}
+			profiles[1].at(j - minV2Index) += rowArea;
+			profiles[2].at(i - minV3Index) += rowArea;
 		}
-		highMeshTree.m_faceIndices = tempFacesHigh;
-*/
-
-		// stitching...
-		MeshTree stitchedTree;
-		stitchedTree.m_vertexCoords = lowMeshTree.m_vertexCoords;
-		stitchedTree.m_vertexCoords.insert(stitchedTree.m_vertexCoords.end(), highMeshTree.m_vertexCoords.begin(), highMeshTree.m_vertexCoords.end());
+	}
 
-		stitchedTree.m_faceIndices = lowMeshTree.m_faceIndices;
-		for (unsigned int const& f : highMeshTree.m_faceIndices) {
-			// must update these face indices since the high OBB verts were appended to end of low OBB verts and thus have a shifted index
-			stitchedTree.m_faceIndices.push_back(f + lowMeshTree.m_vertexCoords.size());
+	// 2. search the profiles in order, the first axis with a splice wins
+	for (SplitAxis const axis : axisOrder) {
+		unsigned int const a = axis - SplitAxis::SPLIT_V1;
+		float jumpScore = 0.0f;
+		int const spliceIndex = searchProfileForSplice(profiles[a], t2, jumpScore);
+		if (-1 != spliceIndex) {
+			out_splitAxis = axis;
+			out_jumpScore = jumpScore;
+			return minIndex[a] + spliceIndex;
 		}
-
-		return stitchedTree;
 	}
-	else if (SPLIT_V2 == lastAxisSearched) {
-		MeshTree lowMeshTree = generateMeshTree(obbSpace, minV1Index, maxV1Index, minV2Index, spliceIndex, minV3Index, maxV3Index, recursiveDepth + 1);
-		MeshTree highMeshTree = generateMeshTree(obbSpace, minV1Index, maxV1Index, spliceIndex + 1, maxV2Index, minV3Index, maxV3Index, recursiveDepth + 1);
 
-		// REMOVE FACES ALONG SPLIT PLANE...
-/*
-		std::vector<unsigned int> tempFacesLow;
-		for (unsigned int f = 0; f < lowMeshTree.m_faceIndices.size(); f += 3) {
-			if ((spliceIndex + 1) == lowMeshTree.m_vertexCoords.at(lowMeshTree.m_faceIndices.at(f)).y && (spliceIndex + 1) == lowMeshTree.m_vertexCoords.at(lowMeshTree.m_faceIndices.at(f + 1)).y && (spliceIndex + 1) == lowMeshTree.m_vertexCoords.at(lowMeshTree.m_faceIndices.at(f + 2)).y) {
-				// REMOVE FACE (3 indices)...
-				// by not adding them
-			}
-			else {
-				tempFacesLow.push_back(lowMeshTree.m_faceIndices.at(f));
-				tempFacesLow.push_back(lowMeshTree.m_faceIndices.at(f + 1));
-				tempFacesLow.push_back(lowMeshTree.m_faceIndices.at(f + 2));
-			}
-		}
-		lowMeshTree.m_faceIndices = tempFacesLow;
+	return -1;
+}
 
-		std::vector<unsigned int> tempFacesHigh;
-		for (unsigned int f = 0; f < highMeshTree.m_faceIndices.size(); f += 3) {
-			if ((spliceIndex + 1) == highMeshTree.m_vertexCoords.at(highMeshTree.m_faceIndices.at(f)).y && (spliceIndex + 1) == highMeshTree.m_vertexCoords.at(highMeshTree.m_faceIndices.at(f + 1)).y && (spliceIndex + 1) == highMeshTree.m_vertexCoords.at(highMeshTree.m_faceIndices.at(f + 2)).y) {
-				// REMOVE FACE (3 indices)...
-				// by not adding them
-			}
-			else {
-				tempFacesHigh.push_back(highMeshTree.m_faceIndices.at(f));
-				tempFacesHigh.push_back(highMeshTree.m_faceIndices.at(f + 1));
-				tempFacesHigh.push_back(highMeshTree.m_faceIndices.at(f + 2));
-			}
-		}
-		highMeshTree.m_faceIndices = tempFacesHigh;
-*/
 
-		// stitching...
-		MeshTree stitchedTree;
-		stitchedTree.m_vertexCoords = lowMeshTree.m_vertexCoords;
-		stitchedTree.m_vertexCoords.insert(stitchedTree.m_vertexCoords.end(), highMeshTree.m_vertexCoords.begin(), highMeshTree.m_vertexCoords.end());
 
-		stitchedTree.m_faceIndices = lowMeshTree.m_faceIndices;
-		for (unsigned int const& f : highMeshTree.m_faceIndices) {
-			// must update these face indices since the high OBB verts were appended to end of low OBB verts and thus have a shifted index
-			stitchedTree.m_faceIndices.push_back(f + lowMeshTree.m_vertexCoords.size());
-		}
+void Program::generateMeshTree(std::vector<std::vector<std::vector<unsigned int>>> const& obbSpace, unsigned int minV1Index, unsigned int maxV1Index, unsigned int minV2Index, unsigned int maxV2Index, unsigned int minV3Index, unsigned int maxV3Index, unsigned int const recursiveDepth, MeshTree &out_meshTree) {
+	// TRIMMING...
+	trimMeshTreeBounds(obbSpace, minV1Index, maxV1Index, minV2Index, maxV2Index, minV3Index, maxV3Index);
 
-		return stitchedTree;
+	// TERMINATE...
+	if (recursiveDepth >= m_maxRecursiveDepth) {
+		terminateMeshTree(minV1Index, maxV1Index, minV2Index, maxV2Index, minV3Index, maxV3Index, out_meshTree);
+		return;
 	}
-	else if (SPLIT_V3 == lastAxisSearched) {
-		MeshTree lowMeshTree = generateMeshTree(obbSpace, minV1Index, maxV1Index, minV2Index, maxV2Index, minV3Index, spliceIndex, recursiveDepth + 1);
-		MeshTree highMeshTree = generateMeshTree(obbSpace, minV1Index, maxV1Index, minV2Index, maxV2Index, spliceIndex + 1, maxV3Index, recursiveDepth + 1);
 
-		// REMOVE FACES ALONG SPLIT PLANE...
-/*
-		std::vector<unsigned int> tempFacesLow;
-		for (unsigned int f = 0; f < lowMeshTree.m_faceIndices.size(); f += 3) {
-			if ((spliceIndex + 1) == lowMeshTree.m_vertexCoords.at(lowMeshTree.m_faceIndices.at(f)).z && (spliceIndex + 1) == lowMeshTree.m_vertexCoords.at(lowMeshTree.m_faceIndices.at(f + 1)).z && (spliceIndex + 1) == lowMeshTree.m_vertexCoords.at(lowMeshTree.m_faceIndices.at(f + 2)).z) {
-				// REMOVE FACE (3 indices)...
-				// by not adding them
-			}
-			else {
-				tempFacesLow.push_back(lowMeshTree.m_faceIndices.at(f));
-				tempFacesLow.push_back(lowMeshTree.m_faceIndices.at(f + 1));
-				tempFacesLow.push_back(lowMeshTree.m_faceIndices.at(f + 2));
-			}
-		}
-		lowMeshTree.m_faceIndices = tempFacesLow;
+	SplitAxis splitAxis = SplitAxis::SPLIT_NONE;
+	float jumpScore = 0.0f;
+	int const spliceIndex = searchForSplice(obbSpace, minV1Index, maxV1Index, minV2Index, maxV2Index, minV3Index, maxV3Index, splitAxis, jumpScore);
 
-		std::vector<unsigned int> tempFacesHigh;
-		for (unsigned int f = 0; f < highMeshTree.m_faceIndices.size(); f += 3) {
-			if ((spliceIndex + 1) == highMeshTree.m_vertexCoords.at(highMeshTree.m_faceIndices.at(f)).z && (spliceIndex + 1) == highMeshTree.m_vertexCoords.at(highMeshTree.m_faceIndices.at(f + 1)).z && (spliceIndex + 1) == highMeshTree.m_vertexCoords.at(highMeshTree.m_faceIndices.at(f + 2)).z) {
-				// REMOVE FACE (3 indices)...
-				// by not adding them
-			}
-			else {
-				tempFacesHigh.push_back(highMeshTree.m_faceIndices.at(f));
-				tempFacesHigh.push_back(highMeshTree.m_faceIndices.at(f + 1));
-				tempFacesHigh.push_back(highMeshTree.m_faceIndices.at(f + 2));
-			}
-		}
-		highMeshTree.m_faceIndices = tempFacesHigh;
-*/
-
-		// stitching...
-		MeshTree stitchedTree;
-		stitchedTree.m_vertexCoords = lowMeshTree.m_vertexCoords;
-		stitchedTree.m_vertexCoords.insert(stitchedTree.m_vertexCoords.end(), highMeshTree.m_vertexCoords.begin(), highMeshTree.m_vertexCoords.end());
+	// TERMINATE...
+	if (-1 == spliceIndex) {
+		terminateMeshTree(minV1Index, maxV1Index, minV2Index, maxV2Index, minV3Index, maxV3Index, out_meshTree);
+		return;
+	}
 
-		stitchedTree.m_faceIndices = lowMeshTree.m_faceIndices;
-		for (unsigned int const& f : highMeshTree.m_faceIndices) {
-			// must update these face indices since the high OBB verts were appended to end of low OBB verts and thus have a shifted index
-			stitchedTree.m_faceIndices.push_back(f + lowMeshTree.m_vertexCoords.size());
-		}
 
-		return stitchedTree;
+	// SPLICE...
+	//NOTE: both halves append straight into the same arena (no stitching needed, internal faces along the split plane get removed when the leaves are welded)
+	if (SplitAxis::SPLIT_V1 == splitAxis) {
+		generateMeshTree(obbSpace, minV1Index, spliceIndex, minV2Index, maxV2Index, minV3Index, maxV3Index, recursiveDepth + 1, out_meshTree);
+		generateMeshTree(obbSpace, spliceIndex + 1, maxV1Index, minV2Index, maxV2Index, minV3Index, maxV3Index, recursiveDepth + 1, out_meshTree);
+	}
+	else if (SplitAxis::SPLIT_V2 == splitAxis) {
+		generateMeshTree(obbSpace, minV1Index, maxV1Index, minV2Index, spliceIndex, minV3Index, maxV3Index, recursiveDepth + 1, out_meshTree);
+		generateMeshTree(obbSpace, minV1Index, maxV1Index, spliceIndex + 1, maxV2Index, minV3Index, maxV3Index, recursiveDepth + 1, out_meshTree);
 	}
-	else { //NOTE: this case should never happen
-		return MeshTree();
+	else if (SplitAxis::SPLIT_V3 == splitAxis) {
+		generateMeshTree(obbSpace, minV1Index, maxV1Index, minV2Index, maxV2Index, minV3Index, spliceIndex, recursiveDepth + 1, out_meshTree);
+		generateMeshTree(obbSpace, minV1Index, maxV1Index, minV2Index, maxV2Index, spliceIndex + 1, maxV3Index, recursiveDepth + 1, out_meshTree);
 	}
+	//NOTE: there is no other case
 }
 
 
 
-//NOTE: RETURN -1 on no index found
-int Program::searchForSpliceIndexOverV1(std::vector<std::vector<std::vector<unsigned int>>> const& obbSpace, unsigned int const minV1Index, unsigned int const maxV1Index, unsigned int const minV2Index, unsigned int const maxV2Index, unsigned int const minV3Index, unsigned int const maxV3Index, float const t2) {
-	
-	unsigned int const nV1 = (maxV1Index - minV1Index) + 1;
-	unsigned int const nV2 = (maxV2Index - minV2Index) + 1;
-	unsigned int const nV3 = (maxV3Index - minV3Index) + 1;
+// BEST-FIRST DRIVER...
+// alternative to the depth-first recursion of generateMeshTree: every unsplit box waits in a priority queue keyed by the best jump score of its splice search
+// and the globally best box is always split next, until no box wants to be split anymore or the cage vert/face budget or time budget is reached
+//NOTE: the termination constants (max depth, eta, zeta) still stop individual boxes from being split
+void Program::generateMeshTreeBestFirst(std::vector<std::vector<std::vector<unsigned int>>> const& obbSpace, MeshTree &out_meshTree) {
+	struct SplitCandidate {
+		LeafBox m_box; // trimmed
+		unsigned int m_depth;
+		int m_spliceIndex; // -1 if the box shouldn't be split
+		SplitAxis m_splitAxis;
+		float m_jumpScore;
+
+		bool operator<(SplitCandidate const& c) const {
+			return m_jumpScore < c.m_jumpScore;
+		}
+	};
+
+	auto evaluate = [&](LeafBox box, unsigned int const depth) -> SplitCandidate {
+		trimMeshTreeBounds(obbSpace, box.m_min.x, box.m_max.x, box.m_min.y, box.m_max.y, box.m_min.z, box.m_max.z);
+
+		SplitCandidate candidate;
+		candidate.m_box = box;
+		candidate.m_depth = depth;
+		candidate.m_spliceIndex = -1;
+		candidate.m_splitAxis = SplitAxis::SPLIT_NONE;
+		candidate.m_jumpScore = std::numeric_limits<float>::lowest();
+		if (depth < m_maxRecursiveDepth) {
+			candidate.m_spliceIndex = searchForSplice(obbSpace, box.m_min.x, box.m_max.x, box.m_min.y, box.m_max.y, box.m_min.z, box.m_max.z, candidate.m_splitAxis, candidate.m_jumpScore);
+		}
+		return candidate;
+	};
+
+	std::vector<LeafBox> finalLeaves; // boxes that won't be split anymore
+	std::vector<SplitCandidate> heap; // max-heap on the jump score (a plain vector so that it can be iterated when measuring the cage)
+
+	auto enqueue = [&](SplitCandidate const& candidate) {
+		if (-1 == candidate.m_spliceIndex) {
+			finalLeaves.push_back(candidate.m_box);
+		}
+		else {
+			heap.push_back(candidate);
+			std::push_heap(heap.begin(), heap.end());
+		}
+	};
+
+	LeafBox rootBox;
+	rootBox.m_min = glm::uvec3(0, 0, 0);
+	rootBox.m_max = glm::uvec3(obbSpace.at(0).at(0).size() - 1, obbSpace.at(0).size() - 1, obbSpace.size() - 1);
+	enqueue(evaluate(rootBox, 0));
+
+	// the welded cage size is only known after welding, so it is estimated from the leaf count and only measured exactly when the estimate gets close to a budget
+	//NOTE: starts from the unwelded upper bound of verts per leaf (faces per leaf can exceed 12 after welding, hence the larger start value)
+	//NOTE: welding costs as much as all the leaves together, so after a measurement the next one is only due once about half of the estimated headroom has been split away (O(log) welds instead of 1 per split near the budget)
+	//NOTE: the leaves are kept from every measurement within budget - if a later one is over budget (the estimate was too optimistic), the splits since then are undone and from there on every split gets measured
+	//NOTE: if the state before the over budget split was only estimated, it may be over budget as well, so the splits are undone (see the end) until the welded cage fits
+	bool const hasVertBudget = 0 != m_targetCageVertCount;
+	bool const hasFaceBudget = 0 != m_targetCageFaceCount;
+	float vertsPerLeaf = (float)MeshTree::s_VERTS_PER_LEAF;
+	float facesPerLeaf = 24.0f;
+	float const estimateMargin = 1.25f;
+
+	size_t nextMeasureLeafCount = 0; // leaf count at which the next measurement is due (0 until the first one)
+	bool isMeasuringEverySplit = false;
+	bool hasMeasuredLeaves = false;
+	std::vector<LeafBox> measuredFinalLeaves; // finalLeaves + heap at the last measurement within budget
+	std::vector<SplitCandidate> measuredHeap;
+	size_t measuredSplitCount = 0;
+
+	struct Split {
+		LeafBox m_parent;
+		LeafBox m_low;
+		LeafBox m_high;
+	};
+	std::vector<Split> splits; // in the order they were made (so they can be undone from the back)
+	size_t fittingSplitCount = 0; // splits at the last measurement within budget (any number of them, unlike measuredSplitCount)
+	bool isWithinBudget = true; // the current leaves were measured within budget (or no budget was near yet)
+	bool isOverBudget = false;
+
+	auto const startTime = std::chrono::steady_clock::now();
+
+	while (!heap.empty()) {
+		// time budget...
+		if (m_splitTimeBudget > 0.0f) {
+			std::chrono::duration<float> const elapsed = std::chrono::steady_clock::now() - startTime;
+			if (elapsed.count() >= m_splitTimeBudget) break;
+		}
+
+		std::pop_heap(heap.begin(), heap.end());
+		SplitCandidate const best = heap.back();
+		heap.pop_back();
+
+		// split the best box...
+		unsigned int const axis = best.m_splitAxis - SplitAxis::SPLIT_V1; // 0 for V1, 1 for V2, 2 for V3
+		LeafBox lowBox = best.m_box;
+		LeafBox highBox = best.m_box;
+		lowBox.m_max[axis] = best.m_spliceIndex;
+		highBox.m_min[axis] = best.m_spliceIndex + 1;
+		SplitCandidate const low = evaluate(lowBox, best.m_depth + 1);
+		SplitCandidate const high = evaluate(highBox, best.m_depth + 1);
+
+		// cage size budget...
+		size_t const leafCount = finalLeaves.size() + heap.size() + 2;
+		bool const isNearVertBudget = hasVertBudget && leafCount * vertsPerLeaf * estimateMargin >= m_targetCageVertCount;
+		bool const isNearFaceBudget = hasFaceBudget && leafCount * facesPerLeaf * estimateMargin >= m_targetCageFaceCount;
+		if ((isNearVertBudget || isNearFaceBudget) && (isMeasuringEverySplit || leafCount >= nextMeasureLeafCount)) {
+			std::vector<LeafBox> leaves = finalLeaves;
+			for (SplitCandidate const& candidate : heap) leaves.push_back(candidate.m_box);
+			leaves.push_back(low.m_box);
+			leaves.push_back(high.m_box);
+
+			MeshTree const welded = CageWelder::weld(leaves);
+			size_t const vertCount = welded.m_vertexCoords.size();
+			size_t const faceCount = welded.m_faceIndices.size() / 3;
+			vertsPerLeaf = (float)vertCount / leafCount;
+			facesPerLeaf = (float)faceCount / leafCount;
+
+			if ((hasVertBudget && vertCount > m_targetCageVertCount) || (hasFaceBudget && faceCount > m_targetCageFaceCount)) {
+				if (hasMeasuredLeaves && !isMeasuringEverySplit) {
+					// undo the unmeasured splits and redo them 1 measured split at a time
+					finalLeaves = measuredFinalLeaves;
+					heap = measuredHeap;
+					splits.resize(measuredSplitCount);
+					fittingSplitCount = measuredSplitCount;
+					isMeasuringEverySplit = true;
+					isWithinBudget = true;
+					continue;
+				}
 
-	std::vector<unsigned int> fx(nV1, 0);
-	std::vector<int> classifyFx(nV1, 0);
+				// this split would go over budget, so keep the box whole and stop
+				finalLeaves.push_back(best.m_box);
+				isOverBudget = true;
+				break;
+			}
 
-	for (unsigned int k = minV1Index; k <= maxV1Index; ++k) {
-		unsigned int area = 0;
-		for (unsigned int j = minV2Index; j <= maxV2Index; ++j) {
-			for (unsigned int i = minV3Index; i <= maxV3Index; ++i) {
-				area += obbSpace.at(i).at(j).at(k);
+			// leaves (at the current rates) that fit into what is left of the budgets...
+			float headroomLeaves = std::numeric_limits<float>::max();
+			if (hasVertBudget) headroomLeaves = std::min(headroomLeaves, (m_targetCageVertCount - vertCount) / (vertsPerLeaf * estimateMargin));
+			if (hasFaceBudget) headroomLeaves = std::min(headroomLeaves, (m_targetCageFaceCount - faceCount) / (facesPerLeaf * estimateMargin));
+			nextMeasureLeafCount = leafCount + std::max<size_t>(1, (size_t)(headroomLeaves / 2));
+
+			enqueue(low);
+			enqueue(high);
+			splits.push_back({ best.m_box, low.m_box, high.m_box });
+			fittingSplitCount = splits.size();
+			isWithinBudget = true;
+			if (!isMeasuringEverySplit) {
+				measuredFinalLeaves = finalLeaves;
+				measuredHeap = heap;
+				measuredSplitCount = splits.size();
+				hasMeasuredLeaves = true;
 			}
+			continue;
 		}
-		fx.at(k - minV1Index) = area;
-	}
-
-	// handle boundaries, if we have something like 1, 1, 1, 1, 5 - then the 4th 1 should be marked as a local minimum
-	// if we have something like 0, 0, 0, 1, 5 - then we trim the 0's and the 1 is NOT marked as a local minimum
-	// if we have something like 0, 0, 0, 1, 1, 1, 1, 5 - then we trim the 0's and get same situation as 1, 1, 1, 1, 5 and treat 4th 1 as a local minimum
-
-	int startIndex = -1;
-	int endIndex = -1;
 
-	// trim any leading 0's...
-	for (unsigned int i = minV1Index; i <= maxV1Index; ++i) {
-		if (fx.at(i - minV1Index) > 0) {
-			startIndex = i - minV1Index;
-			break;
-		}
+		enqueue(low);
+		enqueue(high);
+		splits.push_back({ best.m_box, low.m_box, high.m_box });
+		isWithinBudget = false;
 	}
-	// trim any trailing 0's...
-	for (unsigned int i = maxV1Index; i >= minV1Index; --i) {
-		if (fx.at(i - minV1Index) > 0) {
-			endIndex = i - minV1Index;
-			break;
-		}
-	}
-
-	// TERMINATE...
-	if (-1 == startIndex || -1 == endIndex || startIndex == endIndex) return -1;
-
 
-	unsigned int localMinCount = 0;
-	unsigned int minArea = std::numeric_limits<unsigned int>::max();
-	unsigned int maxArea = 0;
+	// everything that is still waiting stays unsplit...
+	for (SplitCandidate const& candidate : heap) finalLeaves.push_back(candidate.m_box);
 
-	// handle boundaries (can't be marked as local minima)...
-	if (fx.at(startIndex) > fx.at(startIndex + 1)) {
-		classifyFx.at(startIndex) = 1;
-		if (fx.at(startIndex) > maxArea) maxArea = fx.at(startIndex);
-		if (fx.at(startIndex) < minArea) minArea = fx.at(startIndex);
-	}
-	if (fx.at(endIndex) > fx.at(endIndex - 1)) {
-		classifyFx.at(endIndex) = 1;
-		if (fx.at(endIndex) > maxArea) maxArea = fx.at(endIndex);
-		if (fx.at(endIndex) < minArea) minArea = fx.at(endIndex);
-	}
-	for (unsigned int i = startIndex + 1; i < endIndex; ++i) {
-		//MAXIMUM...
-		if (fx.at(i - 1) < fx.at(i) && fx.at(i) >= fx.at(i + 1)) {
-			classifyFx.at(i) = 1;
-			if (fx.at(i) > maxArea) maxArea = fx.at(i);
-			if (fx.at(i) < minArea) minArea = fx.at(i);
-		}
-		else if (fx.at(i - 1) <= fx.at(i) && fx.at(i) > fx.at(i + 1)) {
-			classifyFx.at(i) = 1;
-			if (fx.at(i) > maxArea) maxArea = fx.at(i);
-			if (fx.at(i) < minArea) minArea = fx.at(i);
-		}
-		//MINIMUM...
-		//TODO: pass in this "10" as a user parameter
-		else if (i >= startIndex + 10 && i <= endIndex - 10) {
-			if (fx.at(i - 1) > fx.at(i) && fx.at(i) <= fx.at(i + 1)) {
-				classifyFx.at(i) = -1;
-				if (fx.at(i) > maxArea) maxArea = fx.at(i);
-				if (fx.at(i) < minArea) minArea = fx.at(i);
-				++localMinCount;
+	// stopped at an over budget split whose previous state was only estimated, so the last splits are undone (their 2 boxes merged back into 1) until the cage fits
+	//NOTE: binary search on how many of the splits are kept (the cage grows with the splits), so O(log) welds - from the last measurement within budget (or the root box) up to now
+	if (isOverBudget && !isWithinBudget) {
+		auto leavesAfterSplits = [&](size_t const splitCount) {
+			std::vector<LeafBox> leaves = finalLeaves;
+			for (size_t s = splits.size(); s > splitCount; --s) {
+				Split const& split = splits.at(s - 1);
+				leaves.erase(std::remove_if(leaves.begin(), leaves.end(), [&split](LeafBox const& box) {
+					return (box.m_min == split.m_low.m_min && box.m_max == split.m_low.m_max) || (box.m_min == split.m_high.m_min && box.m_max == split.m_high.m_max);
+				}), leaves.end());
+				leaves.push_back(split.m_parent);
 			}
-			else if (fx.at(i - 1) >= fx.at(i) && fx.at(i) < fx.at(i + 1)) {
-				classifyFx.at(i) = -1;
-				if (fx.at(i) > maxArea) maxArea = fx.at(i);
-				if (fx.at(i) < minArea) minArea = fx.at(i);
-				++localMinCount;
-			}
-		}
-	}
-
-	float const t1 = ((float)minArea) / maxArea;
-	// TERMINATE...
-	if (0 == localMinCount || (t1 > m_eta && t2 > m_zeta)) return -1;
+			return leaves;
+		};
 
-
-	//TODO: ignore local minima with more than 1 part in cross-section
-	// find the biggest JUMP...
-	int spliceIndex = -1;
-	float maxDYDX = std::numeric_limits<float>::lowest();
-
-	for (unsigned int i = startIndex; i <= endIndex; ++i) {
-		// if at a minimum...
-		if (-1 == classifyFx.at(i)) {
-
-			// find slope between this minimum and every other maximum...
-			for (unsigned int j = startIndex; j <= endIndex; ++j) {
-				if (1 == classifyFx.at(j)) {
-					//NOTE: if the minimum is higher up than maximum, the slope will be negative/0 and thus be too small to even consider
-					int const dx = glm::abs<int>((int)j - (int)i);
-					int const dy = fx.at(j) - fx.at(i);
-					float const dydx = ((float)dy) / dx;
-
-					//TODO: could handle ties differently
-					if (dydx > maxDYDX) {
-						maxDYDX = dydx;
-						spliceIndex = minV1Index + i;
-					}
-				}
-			}
+		size_t maxSplitCount = splits.size();
+		while (fittingSplitCount < maxSplitCount) {
+			size_t const splitCount = (fittingSplitCount + maxSplitCount + 1) / 2;
+			MeshTree const welded = CageWelder::weld(leavesAfterSplits(splitCount));
+			bool const isFitting = (!hasVertBudget || welded.m_vertexCoords.size() <= m_targetCageVertCount) && (!hasFaceBudget || welded.m_faceIndices.size() / 3 <= m_targetCageFaceCount);
+			if (isFitting) fittingSplitCount = splitCount;
+			else maxSplitCount = splitCount - 1;
 		}
+		finalLeaves = leavesAfterSplits(fittingSplitCount);
 	}
 
-	return spliceIndex;
+	out_meshTree.reserveLeaves(finalLeaves.size());
+	for (LeafBox const& leafBox : finalLeaves) out_meshTree.appendLeafBox(leafBox);
 }
 
 
 
-//NOTE: RETURN -1 on no index found
-int Program::searchForSpliceIndexOverV2(std::vector<std::vector<std::vector<unsigned int>>> const& obbSpace, unsigned int const minV1Index, unsigned int const maxV1Index, unsigned int const minV2Index, unsigned int const maxV2Index, unsigned int const minV3Index, unsigned int const maxV3Index, float const t2) {
-
-	unsigned int const nV1 = (maxV1Index - minV1Index) + 1;
-	unsigned int const nV2 = (maxV2Index - minV2Index) + 1;
-	unsigned int const nV3 = (maxV3Index - minV3Index) + 1;
-
-	std::vector<unsigned int> fx(nV2, 0);
-	std::vector<int> classifyFx(nV2, 0);
-
-	for (unsigned int j = minV2Index; j <= maxV2Index; ++j) {
-		unsigned int area = 0;
-		for (unsigned int i = minV3Index; i <= maxV3Index; ++i) {
-			for (unsigned int k = minV1Index; k <= maxV1Index; ++k) {
-				area += obbSpace.at(i).at(j).at(k);
-			}
-		}
-		fx.at(j - minV2Index) = area;
-	}
-
+//NOTE: RETURN -1 on no index found, otherwise the index of the splice (a local minimum) in fx
+// fx is the cross-section area profile of a box along one axis
+int Program::searchProfileForSplice(std::vector<unsigned int> const& fx, float const t2, float &out_jumpScore) const {
 	// handle boundaries, if we have something like 1, 1, 1, 1, 5 - then the 4th 1 should be marked as a local minimum
 	// if we have something like 0, 0, 0, 1, 5 - then we trim the 0's and the 1 is NOT marked as a local minimum
 	// if we have something like 0, 0, 0, 1, 1, 1, 1, 5 - then we trim the 0's and get same situation as 1, 1, 1, 1, 5 and treat 4th 1 as a local minimum
@@ -2153,16 +2099,16 @@ int Program::searchForSpliceIndexOverV2(std::vector<std::vector<std::vector<unsi
 	int endIndex = -1;
 
 	// trim any leading 0's...
-	for (unsigned int i = minV2Index; i <= maxV2Index; ++i) {
-		if (fx.at(i - minV2Index) > 0) {
-			startIndex = i - minV2Index;
+	for (int i = 0; i < (int)fx.size(); ++i) {
+		if (fx.at(i) > 0) {
+			startIndex = i;
 			break;
 		}
 	}
 	// trim any trailing 0's...
-	for (unsigned int i = maxV2Index; i >= minV2Index; --i) {
-		if (fx.at(i - minV2Index) > 0) {
-			endIndex = i - minV2Index;
+	for (int i = (int)fx.size() - 1; i >= 0; --i) {
+		if (fx.at(i) > 0) {
+			endIndex = i;
 			break;
 		}
 	}
@@ -2171,46 +2117,31 @@ int Program::searchForSpliceIndexOverV2(std::vector<std::vector<std::vector<unsi
 	if (-1 == startIndex || -1 == endIndex || startIndex == endIndex) return -1;
 
 
+	std::vector<int> classifyFx(fx.size(), 0);
 	unsigned int localMinCount = 0;
 	unsigned int minArea = std::numeric_limits<unsigned int>::max();
 	unsigned int maxArea = 0;
 
+	auto classify = [&](int const i, int const type) {
+		classifyFx.at(i) = type;
+		if (fx.at(i) > maxArea) maxArea = fx.at(i);
+		if (fx.at(i) < minArea) minArea = fx.at(i);
+	};
+
 	// handle boundaries (can't be marked as local minima)...
-	if (fx.at(startIndex) > fx.at(startIndex + 1)) {
-		classifyFx.at(startIndex) = 1;
-		if (fx.at(startIndex) > maxArea) maxArea = fx.at(startIndex);
-		if (fx.at(startIndex) < minArea) minArea = fx.at(startIndex);
-	}
-	if (fx.at(endIndex) > fx.at(endIndex - 1)) {
-		classifyFx.at(endIndex) = 1;
-		if (fx.at(endIndex) > maxArea) maxArea = fx.at(endIndex);
-		if (fx.at(endIndex) < minArea) minArea = fx.at(endIndex);
-	}
-	for (unsigned int i = startIndex + 1; i < endIndex; ++i) {
+	if (fx.at(startIndex) > fx.at(startIndex + 1)) classify(startIndex, 1);
+	if (fx.at(endIndex) > fx.at(endIndex - 1)) classify(endIndex, 1);
+
+	int const margin = (int)m_minSpliceDistance;
+	for (int i = startIndex + 1; i < endIndex; ++i) {
 		//MAXIMUM...
-		if (fx.at(i - 1) < fx.at(i) && fx.at(i) >= fx.at(i + 1)) {
-			classifyFx.at(i) = 1;
-			if (fx.at(i) > maxArea) maxArea = fx.at(i);
-			if (fx.at(i) < minArea) minArea = fx.at(i);
+		if ((fx.at(i - 1) < fx.at(i) && fx.at(i) >= fx.at(i + 1)) || (fx.at(i - 1) <= fx.at(i) && fx.at(i) > fx.at(i + 1))) {
+			classify(i, 1);
 		}
-		else if (fx.at(i - 1) <= fx.at(i) && fx.at(i) > fx.at(i + 1)) {
-			classifyFx.at(i) = 1;
-			if (fx.at(i) > maxArea) maxArea = fx.at(i);
-			if (fx.at(i) < minArea) minArea = fx.at(i);
-		}
-		//MINIMUM...
-		//TODO: pass in this "10" as a user parameter
-		else if (i >= startIndex + 10 && i <= endIndex - 10) {
-			if (fx.at(i - 1) > fx.at(i) && fx.at(i) <= fx.at(i + 1)) {
-				classifyFx.at(i) = -1;
-				if (fx.at(i) > maxArea) maxArea = fx.at(i);
-				if (fx.at(i) < minArea) minArea = fx.at(i);
-				++localMinCount;
-			}
-			else if (fx.at(i - 1) >= fx.at(i) && fx.at(i) < fx.at(i + 1)) {
-				classifyFx.at(i) = -1;
-				if (fx.at(i) > maxArea) maxArea = fx.at(i);
-				if (fx.at(i) < minArea) minArea = fx.at(i);
+		//MINIMUM... (not too close to either end of the box)
+		else if (i >= startIndex + margin && i <= endIndex - margin) {
+			if ((fx.at(i - 1) > fx.at(i) && fx.at(i) <= fx.at(i + 1)) || (fx.at(i - 1) >= fx.at(i) && fx.at(i) < fx.at(i + 1))) {
+				classify(i, -1);
 				++localMinCount;
 			}
 		}
@@ -2222,325 +2153,230 @@ int Program::searchForSpliceIndexOverV2(std::vector<std::vector<std::vector<unsi
 
 
 	//TODO: ignore local minima with more than 1 part in cross-section
-	// find the biggest JUMP...
-	int spliceIndex = -1;
-	float maxDYDX = std::numeric_limits<float>::lowest();
-
-	for (unsigned int i = startIndex; i <= endIndex; ++i) {
-		// if at a minimum...
-		if (-1 == classifyFx.at(i)) {
-
-			// find slope between this minimum and every other maximum...
-			for (unsigned int j = startIndex; j <= endIndex; ++j) {
-				if (1 == classifyFx.at(j)) {
-					//NOTE: if the minimum is higher up than maximum, the slope will be negative/0 and thus be too small to even consider
-					int const dx = glm::abs<int>((int)j - (int)i);
-					int const dy = fx.at(j) - fx.at(i);
-					float const dydx = ((float)dy) / dx;
-
-					//TODO: could handle ties differently
-					if (dydx > maxDYDX) {
-						maxDYDX = dydx;
-						spliceIndex = minV2Index + i;
-					}
+	// find the biggest JUMP... (the steepest slope from any minimum to any maximum, on either side of it)
+	// the best maximum for a minimum is the tangent point from the minimum to the upper convex hull of the maxima on that side,
+	// so sweep once in each direction, growing the hull of the maxima passed so far and binary searching it for the tangent of every minimum
+	//NOTE: O(n log n) instead of O(minima * maxima)
+	struct ProfilePoint {
+		int64_t m_x; // distance along the sweep
+		int64_t m_y; // area
+	};
+	std::vector<float> bestDYDX(fx.size(), std::numeric_limits<float>::lowest());
+	std::vector<ProfilePoint> hull; // upper hull of the maxima passed so far, the last one is the most recently added (closest) one
+
+	for (int const step : { -1, 1 }) {
+		hull.clear();
+
+		int const first = (-1 == step) ? endIndex : startIndex;
+		int const last = (-1 == step) ? startIndex : endIndex;
+		for (int i = first; i != last + step; i += step) {
+			//NOTE: x grows away from the direction of the sweep, so every point on the hull is to the right of the current one
+			ProfilePoint const p = { -(int64_t)step * i, (int64_t)fx.at(i) };
+
+			if (-1 == classifyFx.at(i) && !hull.empty()) {
+				// the slope from p along the hull is unimodal, binary search for its peak
+				auto isSteeper = [&p](ProfilePoint const& a, ProfilePoint const& b) {
+					return (a.m_y - p.m_y) * (b.m_x - p.m_x) > (b.m_y - p.m_y) * (a.m_x - p.m_x);
+				};
+				size_t lo = 0;
+				size_t hi = hull.size() - 1;
+				while (lo < hi) {
+					size_t const mid = (lo + hi) / 2;
+					if (isSteeper(hull.at(mid + 1), hull.at(mid))) lo = mid + 1;
+					else hi = mid;
 				}
-			}
-		}
-	}
 
-	return spliceIndex;
-}
-
-
-
-//NOTE: RETURN -1 on no index found
-int Program::searchForSpliceIndexOverV3(std::vector<std::vector<std::vector<unsigned int>>> const& obbSpace, unsigned int const minV1Index, unsigned int const maxV1Index, unsigned int const minV2Index, unsigned int const maxV2Index, unsigned int const minV3Index, unsigned int const maxV3Index, float const t2) {
-
-	unsigned int const nV1 = (maxV1Index - minV1Index) + 1;
-	unsigned int const nV2 = (maxV2Index - minV2Index) + 1;
-	unsigned int const nV3 = (maxV3Index - minV3Index) + 1;
-
-	std::vector<unsigned int> fx(nV3, 0);
-	std::vector<int> classifyFx(nV3, 0);
-
-	for (unsigned int i = minV3Index; i <= maxV3Index; ++i) {
-		unsigned int area = 0;
-		for (unsigned int j = minV2Index; j <= maxV2Index; ++j) {
-			for (unsigned int k = minV1Index; k <= maxV1Index; ++k) {
-				area += obbSpace.at(i).at(j).at(k);
+				//NOTE: if the minimum is higher up than maximum, the slope will be negative/0 and thus be too small to even consider
+				int const dx = (int)(hull.at(lo).m_x - p.m_x);
+				int const dy = (int)(hull.at(lo).m_y - p.m_y);
+				float const dydx = ((float)dy) / dx;
+				if (dydx > bestDYDX.at(i)) bestDYDX.at(i) = dydx;
 			}
-		}
-		fx.at(i - minV3Index) = area;
-	}
-
-	// handle boundaries, if we have something like 1, 1, 1, 1, 5 - then the 4th 1 should be marked as a local minimum
-	// if we have something like 0, 0, 0, 1, 5 - then we trim the 0's and the 1 is NOT marked as a local minimum
-	// if we have something like 0, 0, 0, 1, 1, 1, 1, 5 - then we trim the 0's and get same situation as 1, 1, 1, 1, 5 and treat 4th 1 as a local minimum
-
-	int startIndex = -1;
-	int endIndex = -1;
-
-	// trim any leading 0's...
-	for (unsigned int i = minV3Index; i <= maxV3Index; ++i) {
-		if (fx.at(i - minV3Index) > 0) {
-			startIndex = i - minV3Index;
-			break;
-		}
-	}
-	// trim any trailing 0's...
-	for (unsigned int i = maxV3Index; i >= minV3Index; --i) {
-		if (fx.at(i - minV3Index) > 0) {
-			endIndex = i - minV3Index;
-			break;
-		}
-	}
-
-	// TERMINATE...
-	if (-1 == startIndex || -1 == endIndex || startIndex == endIndex) return -1;
-
-
-	unsigned int localMinCount = 0;
-	unsigned int minArea = std::numeric_limits<unsigned int>::max();
-	unsigned int maxArea = 0;
-
-	// handle boundaries (can't be marked as local minima)...
-	if (fx.at(startIndex) > fx.at(startIndex + 1)) {
-		classifyFx.at(startIndex) = 1;
-		if (fx.at(startIndex) > maxArea) maxArea = fx.at(startIndex);
-		if (fx.at(startIndex) < minArea) minArea = fx.at(startIndex);
-	}
-	if (fx.at(endIndex) > fx.at(endIndex - 1)) {
-		classifyFx.at(endIndex) = 1;
-		if (fx.at(endIndex) > maxArea) maxArea = fx.at(endIndex);
-		if (fx.at(endIndex) < minArea) minArea = fx.at(endIndex);
-	}
-	for (unsigned int i = startIndex + 1; i < endIndex; ++i) {
-		//MAXIMUM...
-		if (fx.at(i - 1) < fx.at(i) && fx.at(i) >= fx.at(i + 1)) {
-			classifyFx.at(i) = 1;
-			if (fx.at(i) > maxArea) maxArea = fx.at(i);
-			if (fx.at(i) < minArea) minArea = fx.at(i);
-		}
-		else if (fx.at(i - 1) <= fx.at(i) && fx.at(i) > fx.at(i + 1)) {
-			classifyFx.at(i) = 1;
-			if (fx.at(i) > maxArea) maxArea = fx.at(i);
-			if (fx.at(i) < minArea) minArea = fx.at(i);
-		}
-		//MINIMUM...
-		//TODO: pass in this "10" as a user parameter
-		else if (i >= startIndex + 10 && i <= endIndex - 10) {
-			if (fx.at(i - 1) > fx.at(i) && fx.at(i) <= fx.at(i + 1)) {
-				classifyFx.at(i) = -1;
-				if (fx.at(i) > maxArea) maxArea = fx.at(i);
-				if (fx.at(i) < minArea) minArea = fx.at(i);
-				++localMinCount;
-			}
-			else if (fx.at(i - 1) >= fx.at(i) && fx.at(i) < fx.at(i + 1)) {
-				classifyFx.at(i) = -1;
-				if (fx.at(i) > maxArea) maxArea = fx.at(i);
-				if (fx.at(i) < minArea) minArea = fx.at(i);
-				++localMinCount;
+			else if (1 == classifyFx.at(i)) {
+				// p is the new leftmost point, drop the hull points that are no longer above the line from p to their right neighbour
+				while (hull.size() >= 2) {
+					ProfilePoint const& a = hull.at(hull.size() - 1);
+					ProfilePoint const& b = hull.at(hull.size() - 2);
+					if ((a.m_x - p.m_x) * (b.m_y - p.m_y) - (a.m_y - p.m_y) * (b.m_x - p.m_x) < 0) break;
+					hull.pop_back();
+				}
+				hull.push_back(p);
 			}
 		}
 	}
 
-	float const t1 = ((float)minArea) / maxArea;
-	// TERMINATE...
-	if (0 == localMinCount || (t1 > m_eta && t2 > m_zeta)) return -1;
-
-
-	//TODO: ignore local minima with more than 1 part in cross-section
-	// find the biggest JUMP...
 	int spliceIndex = -1;
 	float maxDYDX = std::numeric_limits<float>::lowest();
-
-	for (unsigned int i = startIndex; i <= endIndex; ++i) {
-		// if at a minimum...
-		if (-1 == classifyFx.at(i)) {
-
-			// find slope between this minimum and every other maximum...
-			for (unsigned int j = startIndex; j <= endIndex; ++j) {
-				if (1 == classifyFx.at(j)) {
-					//NOTE: if the minimum is higher up than maximum, the slope will be negative/0 and thus be too small to even consider
-					int const dx = glm::abs<int>((int)j - (int)i);
-					int const dy = fx.at(j) - fx.at(i);
-					float const dydx = ((float)dy) / dx;
-
-					//TODO: could handle ties differently
-					if (dydx > maxDYDX) {
-						maxDYDX = dydx;
-						spliceIndex = minV3Index + i;
-					}
-				}
-			}
+	for (int i = startIndex; i <= endIndex; ++i) {
+		//TODO: could handle ties differently
+		if (-1 == classifyFx.at(i) && bestDYDX.at(i) > maxDYDX) {
+			maxDYDX = bestDYDX.at(i);
+			spliceIndex = i;
 		}
 	}
 
+	//NOTE: a minimum with no maximum on either side can't be spliced at
+	if (-1 == spliceIndex) return -1;
+
+	out_jumpScore = maxDYDX;
 	return spliceIndex;
 }
 
 
 
-bool Program::exportModelOBJ(std::string const& filePath) const {
-	if (nullptr == m_model) return false;
+void Program::drawPoseExportUI() {
+	ImGui::Text("POSES (glTF morph targets)");
+	if (ImGui::Button("SAVE POSE")) m_savedPoses.push_back(MeshPose{ m_model->drawVerts, m_model->normals });
+	ImGui::SameLine();
+	ImGui::Text("%u saved", (unsigned int)m_savedPoses.size());
+	if (!m_savedPoses.empty()) {
+		ImGui::SameLine();
+		if (ImGui::Button("CLEAR POSES")) m_savedPoses.clear();
+	}
 
-	// open file for writing only if it doesn't exist yet
-	FILE *fp = fopen(filePath.c_str(), "wx");
-	if (NULL == fp) return false;
+	ImGui::PushItemWidth(200.0f);
+	ImGui::InputFloat("MORPH THRESHOLD", &m_morphThreshold, 0.0f, 0.0f, "%.6f");
+	m_morphThreshold = std::max(m_morphThreshold, 0.0f);
+	ImGui::PopItemWidth();
 
+	//NOTE: it seems that imgui only allows typing in the text box upto maxFileNameLength - 1 chars.
+	unsigned int const maxFileNameLength = 256;
+	char filename[maxFileNameLength] = "";
+	ImGuiInputTextFlags const flags = ImGuiInputTextFlags_EnterReturnsTrue;
+	ImGui::Text("EXPORT POSES");
+	ImGui::Text(".../models/exports/");
+	ImGui::SameLine();
+	if (ImGui::InputText(".glb##4", filename, IM_ARRAYSIZE(filename), flags)) {
+		exportPosesGLB("models/exports/" + std::string(filename) + ".glb");
+	}
+}
 
-	//NOTE: verts/ (per-vertex) normals will always be present
-	//NOTE: if UVS aren't present then vec3.y will be -1
-	std::vector<glm::vec3> uniqueVerts;
-	std::vector<glm::vec2> uniqueUVS;
-	std::vector<glm::vec3> uniqueNormals;
-	std::vector<glm::vec3> faces; // 3 3-tuples in a row constitutes a tri-face
 
-	//NOTE: i'll increment the face indices since OBJ require 1-indexing 
 
-	// get data into good formats...
-	for (unsigned int f = 0; f < m_model->drawFaces.size(); ++f) {
-		unsigned int const raw_index = m_model->drawFaces.at(f);
-		unsigned int v_index = -1;
-		unsigned int vt_index = -1;
-		unsigned int vn_index = -1;
+void Program::drawAnimationCacheUI() {
+	//NOTE: it seems that imgui only allows typing in the text box upto maxFileNameLength - 1 chars.
+	unsigned int const maxFileNameLength = 256;
+	char filename[maxFileNameLength] = "";
+	ImGuiInputTextFlags const flags = ImGuiInputTextFlags_EnterReturnsTrue;
 
-		auto it1 = std::find(uniqueVerts.begin(), uniqueVerts.end(), m_model->drawVerts.at(raw_index));
-		if (uniqueVerts.end() != it1) { // already stored
-			unsigned int const index = it1 - uniqueVerts.begin();
-			v_index = index + 1;
+	ImGui::Text("ANIMATION CACHE (every deformation is 1 frame)");
+	if (m_animationRecorder.isOpen()) {
+		ImGui::Text("RECORDING - %u frames", m_animationRecorder.getFrameCount());
+		ImGui::SameLine();
+		if (ImGui::Button("STOP RECORDING")) {
+			if (!m_animationRecorder.close()) std::cout << "ERROR (Program.cpp) - failed to finish writing the animation cache" << std::endl;
 		}
-		else { // new vert 
-			uniqueVerts.push_back(m_model->drawVerts.at(raw_index));
-			v_index = uniqueVerts.size();
+	} else if (!m_vertWeights.empty() && !m_animationPlayer.isOpen()) {
+		ImGui::Text("RECORD TO .../models/exports/");
+		ImGui::SameLine();
+		if (ImGui::InputText(".animcache##5", filename, IM_ARRAYSIZE(filename), flags)) {
+			startAnimationRecording("models/exports/" + std::string(filename) + ".animcache");
 		}
+	}
 
-		// if the model has uvs...
-		if (m_model->uvs.size() > 0) {
-			auto it2 = std::find(uniqueUVS.begin(), uniqueUVS.end(), m_model->uvs.at(raw_index));
-			if (uniqueUVS.end() != it2) { // already stored
-				unsigned int const index = it2 - uniqueUVS.begin();
-				vt_index = index + 1;
-			}
-			else { // new uv 
-				uniqueUVS.push_back(m_model->uvs.at(raw_index));
-				vt_index = uniqueUVS.size();
-			}
+	if (m_animationPlayer.isOpen()) {
+		ImGui::PushItemWidth(200.0f);
+		int frame = (int)m_animationFrame;
+		if (ImGui::SliderInt("FRAME", &frame, 0, (int)m_animationPlayer.getFrameCount() - 1)) showAnimationFrame((unsigned int)frame);
+		ImGui::PopItemWidth();
+		ImGui::SameLine();
+		if (ImGui::Button("CLOSE ANIMATION")) closeAnimation();
+	} else if (!m_animationRecorder.isOpen()) {
+		ImGui::Text("PLAY .../models/exports/");
+		ImGui::SameLine();
+		if (ImGui::InputText(".animcache##6", filename, IM_ARRAYSIZE(filename), flags)) {
+			openAnimation("models/exports/" + std::string(filename) + ".animcache");
 		}
+	}
+}
 
-		auto it3 = std::find(uniqueNormals.begin(), uniqueNormals.end(), m_model->normals.at(raw_index));
-		if (uniqueNormals.end() != it3) { // already stored
-			unsigned int const index = it3 - uniqueNormals.begin();
-			vn_index = index + 1;
-		}
-		else { // new normal 
-			uniqueNormals.push_back(m_model->normals.at(raw_index));
-			vn_index = uniqueNormals.size();
-		}
 
-		
-		faces.push_back(glm::vec3(v_index, vt_index, vn_index));
+void Program::startAnimationRecording(std::string const& filePath) {
+	if (nullptr == m_model) return;
+
+	if (!m_animationRecorder.open(filePath, (unsigned int)m_model->drawVerts.size())) {
+		std::cout << "ERROR (Program.cpp) - can't create " << filePath << " (it might already exist)" << std::endl;
+		return;
 	}
+	m_animationRecorder.addFrame(m_model->drawVerts); // the model as it is now is the 1st frame
+}
 
-	// write to file...
-	fprintf(fp, "# Exported from Cage-Tool\n");
 
-	fprintf(fp, "\n\n# -----VERTS-----\n");
-	for (glm::vec3 const& v : uniqueVerts) {
-		fprintf(fp, "\nv %f %f %f", v.x, v.y, v.z);
-	}
+void Program::openAnimation(std::string const& filePath) {
+	if (nullptr == m_model) return;
 
-	if (m_model->uvs.size() > 0) {
-		fprintf(fp, "\n\n# -----UVS-----\n");
-		for (glm::vec2 const& uv : uniqueUVS) {
-			fprintf(fp, "\nvt %f %f", uv.x, uv.y);
-		}
+	if (!m_animationPlayer.open(filePath)) {
+		std::cout << "ERROR (Program.cpp) - " << filePath << " is not a (finished) animation cache" << std::endl;
+		return;
 	}
-
-	fprintf(fp, "\n\n# -----NORMALS-----\n");
-	for (glm::vec3 const& normal : uniqueNormals) {
-		fprintf(fp, "\nvn %f %f %f", normal.x, normal.y, normal.z);
+	if (m_animationPlayer.getVertexCount() != m_model->drawVerts.size() || 0 == m_animationPlayer.getFrameCount()) {
+		std::cout << "ERROR (Program.cpp) - " << filePath << " doesn't animate this model (different vert count)" << std::endl;
+		m_animationPlayer.close();
+		return;
 	}
+	showAnimationFrame(0);
+}
 
-	fprintf(fp, "\n\n# -----FACES-----\n");
-	if (m_model->uvs.size() > 0) {
-		for (unsigned int f = 0; f < faces.size(); f += 3) {
-			glm::vec3 const& p1 = faces.at(f);
-			glm::vec3 const& p2 = faces.at(f+1);
-			glm::vec3 const& p3 = faces.at(f+2);
 
-			fprintf(fp, "\nf %u/%u/%u %u/%u/%u %u/%u/%u", (unsigned int)p1.x, (unsigned int)p1.y, (unsigned int)p1.z, (unsigned int)p2.x, (unsigned int)p2.y, (unsigned int)p2.z, (unsigned int)p3.x, (unsigned int)p3.y, (unsigned int)p3.z);
-		}
+void Program::showAnimationFrame(unsigned int const frame) {
+	if (!m_animationPlayer.readFrame(frame, m_model->drawVerts)) {
+		std::cout << "ERROR (Program.cpp) - corrupt animation cache frame " << frame << std::endl;
+		closeAnimation();
+		return;
 	}
-	else {
-		for (unsigned int f = 0; f < faces.size(); f += 3) {
-			glm::vec3 const& p1 = faces.at(f);
-			glm::vec3 const& p2 = faces.at(f + 1);
-			glm::vec3 const& p3 = faces.at(f + 2);
+	m_animationFrame = frame;
+	updateDeformedModel();
+}
 
-			fprintf(fp, "\nf %u//%u %u//%u %u//%u", (unsigned int)p1.x, (unsigned int)p1.z, (unsigned int)p2.x, (unsigned int)p2.z, (unsigned int)p3.x, (unsigned int)p3.z);
-		}
-	}
 
-	fclose(fp);
+void Program::closeAnimation() {
+	m_animationPlayer.close();
+	m_animationFrame = 0;
 
-	return true;
+	// back to the deformation of the current cage (if there is one, otherwise the model just stays at the last shown frame)
+	if (nullptr != m_model && !m_vertWeights.empty()) deformModel();
 }
 
 
 
-bool Program::exportCageOBJ(std::string const& filePath) const {
-	if (nullptr == m_cage) return false;
+bool Program::exportPosesGLB(std::string const& filePath) const {
+	if (nullptr == m_model || m_restPose.m_verts.empty()) return false;
 
-	// open file for writing only if it doesn't exist yet
-	FILE *fp = fopen(filePath.c_str(), "wx");
-	if (NULL == fp) return false;
+	// the threshold is relative to the model's size
+	glm::vec3 minCorner = m_restPose.m_verts.at(0);
+	glm::vec3 maxCorner = m_restPose.m_verts.at(0);
+	for (glm::vec3 const& vert : m_restPose.m_verts) {
+		minCorner = glm::min(minCorner, vert);
+		maxCorner = glm::max(maxCorner, vert);
+	}
+	float const displacementThreshold = m_morphThreshold * glm::length(maxCorner - minCorner);
 
-	//NOTE: only verts will be present
+	return ObjectExporter::exportMorphTargetsGLB(filePath, *m_model, m_restPose, m_savedPoses, displacementThreshold);
+}
 
-	std::vector<glm::vec3> uniqueVerts;
-	std::vector<glm::vec3> faces; // 3 3-tuples in a row constitutes a tri-face
 
-	//NOTE: i'll increment the face indices since OBJ require 1-indexing 
 
-	// get data into good formats...
-	for (unsigned int f = 0; f < m_cage->drawFaces.size(); ++f) {
-		unsigned int const raw_index = m_cage->drawFaces.at(f);
-		unsigned int v_index = -1;
-		unsigned int vt_index = -1;
-		unsigned int vn_index = -1;
+bool Program::exportModel(std::string const& filePath) const {
+	if (nullptr == m_model) return false;
 
-		auto it1 = std::find(uniqueVerts.begin(), uniqueVerts.end(), m_cage->drawVerts.at(raw_index));
-		if (uniqueVerts.end() != it1) { // already stored
-			unsigned int const index = it1 - uniqueVerts.begin();
-			v_index = index + 1;
-		}
-		else { // new vert 
-			uniqueVerts.push_back(m_cage->drawVerts.at(raw_index));
-			v_index = uniqueVerts.size();
-		}
+	//NOTE: verts/ (per-vertex) normals will always be present, uvs only if the model has them (stl files only ever get verts)
+	return ObjectExporter::exportTriMesh(filePath, *m_model, m_model->uvs.size() > 0, true);
+}
 
-		faces.push_back(glm::vec3(v_index, vt_index, vn_index));
-	}
 
-	// write to file...
-	fprintf(fp, "# Exported from Cage-Tool\n");
 
-	fprintf(fp, "\n\n# -----VERTS-----\n");
-	for (glm::vec3 const& v : uniqueVerts) {
-		fprintf(fp, "\nv %f %f %f", v.x, v.y, v.z);
-	}
+bool Program::exportCage(std::string const& filePath) const {
+	if (nullptr == m_cage) return false;
 
-	fprintf(fp, "\n\n# -----FACES-----\n");
-	for (unsigned int f = 0; f < faces.size(); f += 3) {
-		glm::vec3 const& p1 = faces.at(f);
-		glm::vec3 const& p2 = faces.at(f + 1);
-		glm::vec3 const& p3 = faces.at(f + 2);
+	//NOTE: only verts will be present
+	return ObjectExporter::exportTriMesh(filePath, *m_cage, false, false);
+}
 
-		fprintf(fp, "\nf %u %u %u", (unsigned int)p1.x, (unsigned int)p2.x, (unsigned int)p3.x);
-	}
 
-	fclose(fp);
 
-	return true;
+void Program::drawMeshFileFormatCombo(char const* label, int &format) {
+	ImGui::SameLine();
+	ImGui::PushItemWidth(60.0f);
+	ImGui::Combo(label, &format, s_MESH_FILE_EXTENSIONS, IM_ARRAYSIZE(s_MESH_FILE_EXTENSIONS));
+	ImGui::PopItemWidth();
 }
@@ -7,35 +7,47 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 
+#include <cstdint>
 #include <iostream>
 #include <vector>
 
+#include "AnimationCache.h"
+#include "BackgroundJob.h"
+#include "BVH.h"
+#include "CagePicker.h"
+#include "CageSelection.h"
 #include "Camera.h"
 #include "InputHandler.h"
 #include "MeshObject.h"
+#include "MeshTree.h"
+#include "OBBTools.h"
+#include "ObjectExporter.h"
 #include "ObjectLoader.h"
 #include "RenderEngine.h"
 
 
 
-struct MeshTree {
-	std::vector<glm::vec3> m_vertexCoords; // .x (in V1 axis), .y (in V2 axis), .z (in V3 axis) - most will be integers, except for verts added for triangulation of cutting plane area
-	std::vector<unsigned int> m_faceIndices; // 3 indices in a row correspond to a triangle face (CCW winding) of 3 verts in m_vertexCoords
-};
+// cached outputs of the cage generation stages that don't depend on the termination constants (see Program::generateCage2)
+struct CageGenerationCache {
+	bool m_isValid = false;
 
+	// inputs that the cached outputs were computed from...
+	uint64_t m_modelHash = 0;
+	unsigned int m_voxelResolution = 0;
+	bool m_useConvexHull = false;
+	bool m_useHullFaceSearch = false;
 
-//NOTE: m_axis should be normalized
-//NOTE: m_max >= m_min is assumed
-struct SortableAxis {
-	glm::vec3 m_axis;
-	float m_min;
-	float m_max;
+	// outputs (m_voxelSize, m_eigenV1/2/3 and m_expandedMinScalarAlongV1/2/3 of the Program also belong to these stages)...
+	std::vector<std::vector<std::vector<unsigned int>>> m_obbSpace;
+};
 
-	SortableAxis(glm::vec3 const axis, float const min, float const max) : m_axis(axis), m_min(min), m_max(max) {}
 
-	bool operator<(SortableAxis const& sa) const {
-		return (m_max - m_min) < (sa.m_max - sa.m_min);
-	}
+// axis that a mesh tree box gets spliced along
+enum SplitAxis {
+	SPLIT_NONE = 0,
+	SPLIT_V1 = 1,
+	SPLIT_V2 = 2,
+	SPLIT_V3 = 3,
 };
 
 
@@ -53,6 +65,9 @@ class Program {
 public:
 	static glm::vec3 const s_CAGE_UNSELECTED_COLOUR;
 	static glm::vec3 const s_CAGE_SELECTED_COLOUR;
+	static glm::vec3 const s_MODEL_COLOUR;
+	static glm::vec3 const s_MODEL_OUTSIDE_CAGE_COLOUR;
+	static glm::vec3 const s_MODEL_ON_CAGE_COLOUR;
 
 	Program();
 	void start();
@@ -65,6 +80,18 @@ public:
 	void toggleCageVerts(unsigned int const startIndex, unsigned int const count);
 
 	void translateSelectedCageVerts(glm::vec3 const& translation);
+	// the model gets fully re-deformed once a translation (key press/hold) ends, so the float error of its delta updates doesn't pile up
+	void finishCageTranslation();
+
+	// RETURNS the visible cage vert under the cursor (window coords, +y down), CagePicker::s_NONE if there is none
+	unsigned int pickCageVert(glm::vec2 const& cursor, glm::ivec2 const& windowSize);
+
+	// box (or lasso) selection of the cage verts, dragged with the cursor (window coords, +y down)...
+	void beginCageRegionSelection(glm::vec2 const& cursor, bool const isLasso);
+	void updateCageRegionSelection(glm::vec2 const& cursor);
+	// selects (or unselects) the cage verts inside the dragged region
+	// RETURNS false if the cursor barely moved since beginCageRegionSelection (i.e. it was a click, nothing gets selected)
+	bool endCageRegionSelection(glm::ivec2 const& windowSize, bool const isUnselect);
 
 	float getDeltaMove() const {
 		return m_deltaMove;
@@ -87,8 +114,26 @@ private:
 	void initScene();
 	void clearModel();
 	void clearCage();
+	// loading runs on a worker thread (the previous scene stays interactive meanwhile), the loaded mesh replaces the current one in finishLoading
 	void loadModel(std::string const& filePath);
 	void loadCage(std::string const& filePath);
+	void finishLoading(); // (once per frame) puts finished loads into the scene - the only part that needs the GL context (buffers, texture)
+	void drawLoadingProgress(char const* label, BackgroundJob const& job);
+
+	// everything about a mesh that can be prepared off the GL thread
+	struct LoadedMesh {
+		std::shared_ptr<MeshObject> m_mesh = nullptr; // nullptr if loading failed
+		BVH m_bvh; // (model only) occluder for cage vert picking
+		uint64_t m_hash = 0; // (model only) computeModelHash of the mesh
+		std::vector<unsigned char> m_textureImage; // (model only, if it has uvs) decoded, not uploaded yet
+		unsigned int m_textureWidth = 0;
+		unsigned int m_textureHeight = 0;
+	};
+	LoadedMesh m_loadedModel; // only touched by the task of m_modelLoadJob while it is busy
+	LoadedMesh m_loadedCage; // only touched by the task of m_cageLoadJob while it is busy
+	//NOTE: the jobs are declared after what their tasks write to, so they get joined before that is destroyed
+	BackgroundJob m_modelLoadJob;
+	BackgroundJob m_cageLoadJob;
 
 
 	std::shared_ptr<MeshObject> m_yzPlane = nullptr;
@@ -96,11 +141,48 @@ private:
 	std::shared_ptr<MeshObject> m_xyPlane = nullptr;
 
 
+	BVH m_modelBVH; // over the model's drawVerts/drawFaces (refit whenever the model gets deformed)
+	CagePicker m_cagePicker;
+	CageSelection m_cageSelection;
+	void updateCageSelectionColours();
+
+	std::vector<glm::vec2> m_selectionRegion; // box: its 2 opposite corners, lasso: its polygon (empty while not dragging)
+	bool m_isLassoSelection = false;
+	bool m_ignoreHiddenCageVerts = true; // box/lasso selection leaves out cage verts hidden behind the model
+	void drawCageRegionSelection();
+
+
 	std::vector<std::vector<float>> m_vertWeights; // [i][j] represents the weight of cage vert j on model vert i
+	void clearCageWeights(); // also clears the poses (they only make sense with these weights)
+
+	// model poses saved while deforming it, exported together as glTF morph targets (see ObjectExporter::exportMorphTargetsGLB)
+	MeshPose m_restPose; // the model when the cage weights were computed
+	std::vector<MeshPose> m_savedPoses;
+	float m_morphThreshold = 0.0001f; // verts displaced less than this (as a fraction of the model's bounding box diagonal) are left out of a morph target
+	void drawPoseExportUI();
+	bool exportPosesGLB(std::string const& filePath) const;
+
+	// recording every deformation of the model into an animation cache (encoded in the background), and playing one back frame by frame
+	AnimationCacheWriter m_animationRecorder;
+	AnimationCacheReader m_animationPlayer;
+	unsigned int m_animationFrame = 0; // shown frame of m_animationPlayer
+	void drawAnimationCacheUI();
+	void startAnimationRecording(std::string const& filePath);
+	void openAnimation(std::string const& filePath);
+	void showAnimationFrame(unsigned int const frame);
+	void closeAnimation(); // the model goes back to following the cage
 	//std::vector<std::vector<float>> m_normalWeights; // [i][j] represents the weight of cage face normal j on model vert i (only used for GC)
 
 	void computeCageWeights();
+	// winding number test of every model vert against the cage (MVC is only well behaved strictly inside the cage), the offending verts get highlighted
+	// RETURNS false if any model vert is outside of or on the cage
+	bool validateCageEnclosure();
 	void deformModel();
+	// delta update after only movedCageVerts were moved (all by translation) since the last deformation
+	void deformModel(std::vector<unsigned int> const& movedCageVerts, glm::vec3 const& translation);
+	unsigned int m_deltaDeformCount = 0; // delta updates since the last full deformModel()
+	static unsigned int const s_MAX_DELTA_DEFORMS; // a full deformModel() is forced after this many delta updates in a row
+	void updateDeformedModel(); // normals, buffers and BVH of the model after its verts changed
 
 
 	CoordinateTypes m_coordinateType = CoordinateTypes::MVC; // default is MVC
@@ -108,6 +190,28 @@ private:
 
 	void generateCage2();
 	std::vector<glm::vec3> generatePointSetP2(MeshObject &out_obb, MeshObject &out_pointSetP);
+	void drawCageGenerationUI();
+	void assignGeneratedCage(std::vector<glm::vec3> const& verts, std::vector<GLuint> const& faces);
+
+	// second cage generator - offset + QEM decimation of the model itself (see Program::generateCageSimplified)
+	void generateCageSimplified();
+	float m_simplificationOffset = 0.02f; // outward offset as a fraction of the model's bounding box diagonal
+	unsigned int m_simplificationTargetVertCount = 200;
+	bool m_useSDFOffset = true; // offset surface = iso-surface of the model's signed distance field (otherwise the verts are moved along their normals)
+
+	// FNV-1a hash of the model's verts + faces (the cache key for the model dependent cage generation stages)
+	static uint64_t computeModelHash(MeshObject const& model);
+	//NOTE: hashing every byte of the model on every (live preview) regeneration would eat up much of what the cache saves, so the hash is kept with the model
+	uint64_t m_modelHash = 0; // computeModelHash of the model as it is now (only valid while m_isModelHashValid)
+	bool m_isModelHashValid = false; // set once the model is loaded, reset whenever its verts change (rehashed by the next generation that needs it)
+	uint64_t getModelHash();
+
+	OBBFitOptions m_obbFitOptions; // shared by both PCA stages of the cage generation
+	unsigned int m_voxelResolution = 100; // voxel count along the average extent of the initial OBB (NOTE: the voxel count scales cubically with this, so RAM explodes pretty quickly)
+
+	CageGenerationCache m_cageGenerationCache;
+	bool m_isCageGenerated = false; // false if the current cage was loaded from a file
+	bool m_isLivePreviewOn = false; // regenerate the cage while the termination constants are being dragged
 
 	float m_voxelSize = 0.0f;
 	glm::vec3 m_eigenV1 = glm::vec3(0.0f, 0.0f, 0.0f);
@@ -118,24 +222,37 @@ private:
 	float m_expandedMinScalarAlongV3 = 0.0f;
 
 	std::vector<std::vector<std::vector<unsigned int>>> generateOBBSpace(std::vector<glm::vec3> const& pointSetP);
-	MeshTree generateMeshTree(std::vector<std::vector<std::vector<unsigned int>>> const& obbSpace, unsigned int minV1Index, unsigned int maxV1Index, unsigned int minV2Index, unsigned int maxV2Index, unsigned int minV3Index, unsigned int maxV3Index, unsigned int const recursiveDepth);
-	MeshTree terminateMeshTree(unsigned int const minV1Index, unsigned int const maxV1Index, unsigned int const minV2Index, unsigned int const maxV2Index, unsigned int const minV3Index, unsigned int const maxV3Index);
+	void generateMeshTree(std::vector<std::vector<std::vector<unsigned int>>> const& obbSpace, unsigned int minV1Index, unsigned int maxV1Index, unsigned int minV2Index, unsigned int maxV2Index, unsigned int minV3Index, unsigned int maxV3Index, unsigned int const recursiveDepth, MeshTree &out_meshTree);
+	void terminateMeshTree(unsigned int const minV1Index, unsigned int const maxV1Index, unsigned int const minV2Index, unsigned int const maxV2Index, unsigned int const minV3Index, unsigned int const maxV3Index, MeshTree &out_meshTree);
+	void generateMeshTreeBestFirst(std::vector<std::vector<std::vector<unsigned int>>> const& obbSpace, MeshTree &out_meshTree);
+	void trimMeshTreeBounds(std::vector<std::vector<std::vector<unsigned int>>> const& obbSpace, unsigned int &minV1Index, unsigned int &maxV1Index, unsigned int &minV2Index, unsigned int &maxV2Index, unsigned int &minV3Index, unsigned int &maxV3Index);
 
 	unsigned int m_maxRecursiveDepth = 100;
 	float m_eta = 1.1f; // for t1
 	float m_zeta = 1.1f; // for t2
+	unsigned int m_minSpliceDistance = 10; // a local minimum closer than this to either end of the profile is never spliced at
+
+	bool m_useBestFirstSplitting = false;
+	unsigned int m_targetCageVertCount = 500; // (best-first only) 0 means no limit
+	unsigned int m_targetCageFaceCount = 0; // (best-first only) 0 means no limit
+	float m_splitTimeBudget = 0.0f; // (best-first only) in seconds, 0 means no limit
 
 
 	//NOTE: RETURN -1 on no index found
-	int searchForSpliceIndexOverV1(std::vector<std::vector<std::vector<unsigned int>>> const& obbSpace, unsigned int const minV1Index, unsigned int const maxV1Index, unsigned int const minV2Index, unsigned int const maxV2Index, unsigned int const minV3Index, unsigned int const maxV3Index, float const t2);
-	int searchForSpliceIndexOverV2(std::vector<std::vector<std::vector<unsigned int>>> const& obbSpace, unsigned int const minV1Index, unsigned int const maxV1Index, unsigned int const minV2Index, unsigned int const maxV2Index, unsigned int const minV3Index, unsigned int const maxV3Index, float const t2);
-	int searchForSpliceIndexOverV3(std::vector<std::vector<std::vector<unsigned int>>> const& obbSpace, unsigned int const minV1Index, unsigned int const maxV1Index, unsigned int const minV2Index, unsigned int const maxV2Index, unsigned int const minV3Index, unsigned int const maxV3Index, float const t2);
+	int searchForSplice(std::vector<std::vector<std::vector<unsigned int>>> const& obbSpace, unsigned int const minV1Index, unsigned int const maxV1Index, unsigned int const minV2Index, unsigned int const maxV2Index, unsigned int const minV3Index, unsigned int const maxV3Index, SplitAxis &out_splitAxis, float &out_jumpScore);
+	int searchProfileForSplice(std::vector<unsigned int> const& fx, float const t2, float &out_jumpScore) const;
 
 	// scalar for translating cage verts
 	float m_deltaMove = 1.0f;
 
 
 
-	bool exportModelOBJ(std::string const& filePath) const;
-	bool exportCageOBJ(std::string const& filePath) const;
+	// model/cage files can be obj, ply or stl (picked by the extension, see ObjectLoader::createTriMeshObject and ObjectExporter::exportTriMesh)
+	static char const* const s_MESH_FILE_EXTENSIONS[3];
+	int m_importFormat = 0; // index into s_MESH_FILE_EXTENSIONS
+	int m_exportFormat = 0; // index into s_MESH_FILE_EXTENSIONS
+	void drawMeshFileFormatCombo(char const* label, int &format);
+
+	bool exportModel(std::string const& filePath) const;
+	bool exportCage(std::string const& filePath) const;
 };
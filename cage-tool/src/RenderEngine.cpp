@@ -7,7 +7,6 @@ RenderEngine::RenderEngine(GLFWwindow *window, std::shared_ptr<Camera> camera) :
 	trivialProgram = ShaderTools::compileShaders("shaders/trivial.vert", "shaders/trivial.frag");
 	mainProgram = ShaderTools::compileShaders("shaders/main.vert", "shaders/main.frag");
 	lightProgram = ShaderTools::compileShaders("shaders/light.vert", "shaders/light.frag");
-	pickingProgram = ShaderTools::compileShaders("shaders/picking.vert", "shaders/picking.frag");
 
 	//NOTE: currently placing the light at the top of the y-axis
 	lightPos = glm::vec3(0.0f, 500.0f, 0.0f);
@@ -24,39 +23,6 @@ RenderEngine::RenderEngine(GLFWwindow *window, std::shared_ptr<Camera> camera) :
 }
 
 
-//NOTE: this currently will ignore visibility flag
-//NOTE: if the model has been imported, the model gets rendered as well since it is needed for occlusion tests (all "occlusion" objects should be passed here along with cage, but currently only the model makes sense)
-//NOTE: currently assuming the cage is passed in with polygon mode as POINT
-//NOTE: currently assuming the cage is passed in with pickingColours bound to its colour buffer
-void RenderEngine::renderPicking(std::vector<std::shared_ptr<MeshObject>> const& objects) {
-
-	glm::mat4 const view = camera->getLookAt();
-
-	//NOTE: must clear to white here in case user changed the clear colour for normal rendering (white is assigned as the colour of non-interest (picking was false))
-	glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
-	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-	//NOTE: not sure if blending matters here (or even should be disabled?), but i'll keep this here to be consistent with the other rendering
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-	glUseProgram(pickingProgram);
-
-	for (std::shared_ptr<MeshObject const> o : objects) {
-		glBindVertexArray(o->vao);
-
-		glm::mat4 const mvp = projection * view * o->getModel();
-
-		glUniformMatrix4fv(glGetUniformLocation(pickingProgram, "mvp"), 1, GL_FALSE, glm::value_ptr(mvp));
-		glUniform1i(glGetUniformLocation(pickingProgram, "hasPickingColour"), o->pickingColours.size() > 0);
-
-		// POINT, LINE or FILL...
-		glPolygonMode(GL_FRONT_AND_BACK, o->m_polygonMode);
-
-		glDrawElements(o->m_primitiveMode, o->drawFaces.size(), GL_UNSIGNED_INT, (void*)0);
-		glBindVertexArray(0);
-	}
-}
-
-
 // Called to render provided objects under view matrix
 void RenderEngine::render(std::vector<std::shared_ptr<MeshObject>> const& objects) {
 
@@ -244,8 +210,7 @@ void RenderEngine::updateBuffers(MeshObject &object, bool const updateVerts, boo
 	}
 
 	if (updateColours && 0 != object.colourBuffer) {
-		//NOTE: currently only 2 colour modes
-		std::vector<glm::vec3> const& newColours = object.m_colourMode == ColourMode::NORMAL ? object.colours : object.pickingColours;
+		std::vector<glm::vec3> const& newColours = object.colours;
 		unsigned int const newSize = sizeof(glm::vec3)*newColours.size();
 
 		GLint oldSize = 0;
@@ -273,13 +238,23 @@ unsigned int RenderEngine::loadTexture(std::string filename) {
 	std::vector<unsigned char> _image;
 	unsigned int _imageWidth, _imageHeight;
 
-	unsigned int error = lodepng::decode(_image, _imageWidth, _imageHeight, filename.c_str());
+	decodeTexture(filename, _image, _imageWidth, _imageHeight);
+
+	return createTexture(_image, _imageWidth, _imageHeight);
+}
+
+bool RenderEngine::decodeTexture(std::string const& filename, std::vector<unsigned char> &out_image, unsigned int &out_width, unsigned int &out_height) {
+	unsigned int error = lodepng::decode(out_image, out_width, out_height, filename.c_str());
 	if (error)
 	{
 		std::cout << "reading error" << error << ":" << lodepng_error_text(error) << std::endl;
+		return false;
 	}
+	return true;
+}
 
-	unsigned int id = Texture::create2DTexture(_image, _imageWidth, _imageHeight);
+unsigned int RenderEngine::createTexture(std::vector<unsigned char> &image, unsigned int const width, unsigned int const height) {
+	unsigned int id = Texture::create2DTexture(image, width, height);
 	return id;
 }
 
@@ -288,6 +263,20 @@ void RenderEngine::updateLightPos(glm::vec3 add) {
 	lightPos += add;
 }
 
+// Updates the colour buffer of an object after some of its colours changed
+//NOTE: only re-uploads the colours [first, first + count), same assumptions as updateBuffers
+void RenderEngine::updateColours(MeshObject &object, unsigned int const first, unsigned int const count) {
+
+	// nothing bound
+	if (0 == object.vao || 0 == object.colourBuffer) return;
+
+	// out of range
+	if (count == 0 || first + count > object.colours.size()) return;
+
+	glBindBuffer(GL_ARRAY_BUFFER, object.colourBuffer);
+	glBufferSubData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * first, sizeof(glm::vec3) * count, object.colours.data() + first);
+}
+
 // Sets projection and viewport for new width and height
 void RenderEngine::setWindowSize(int width, int height) {
 	projection = glm::perspective(45.0f, (float)width / height, 0.01f, 2000.0f);
@@ -20,17 +20,21 @@ class RenderEngine {
 public:
 	RenderEngine(GLFWwindow *window, std::shared_ptr<Camera> camera);
 
-	void renderPicking(std::vector<std::shared_ptr<MeshObject>> const& objects);
 	void render(std::vector<std::shared_ptr<MeshObject>> const& objects);
 	//void renderLight();
 	void assignBuffers(MeshObject &object);
 	void updateBuffers(MeshObject &object, bool const updateVerts, bool const updateUVs, bool const updateNormals, bool const updateColours);
+	void updateColours(MeshObject &object, unsigned int const first, unsigned int const count);
 
 	void setWindowSize(int width, int height);
+	glm::mat4 getProjection() const { return projection; }
 
 	void updateLightPos(glm::vec3 add);
 
 	unsigned int loadTexture(std::string filename);
+	// loadTexture split in 2: decoding the png (no GL, so it can run on any thread) and creating the texture from it (GL thread only)
+	static bool decodeTexture(std::string const& filename, std::vector<unsigned char> &out_image, unsigned int &out_width, unsigned int &out_height);
+	unsigned int createTexture(std::vector<unsigned char> &image, unsigned int const width, unsigned int const height);
 
 private:
 	GLFWwindow *window = nullptr;
@@ -39,7 +43,6 @@ private:
 	GLuint trivialProgram;
 	GLuint mainProgram;
 	GLuint lightProgram;
-	GLuint pickingProgram;
 
 	glm::mat4 projection;
 	glm::vec3 lightPos;
@@ -0,0 +1,410 @@
+#include "SignedDistanceField.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+
+#include "BVH.h"
+#include "ParallelTools.h"
+#include "VoxelGrid.h"
+
+namespace {
+	// eikonal update of a node from its smallest neighbour along each axis (unit grid spacing)
+	float solveEikonal(float a1, float a2, float a3) {
+		if (a1 > a2) std::swap(a1, a2);
+		if (a2 > a3) std::swap(a2, a3);
+		if (a1 > a2) std::swap(a1, a2);
+
+		float u = a1 + 1.0f;
+		if (u <= a2) return u;
+
+		u = 0.5f * (a1 + a2 + glm::sqrt(2.0f - (a1 - a2) * (a1 - a2)));
+		if (u <= a3) return u;
+
+		float const s = a1 + a2 + a3;
+		return (s + glm::sqrt(glm::max(0.0f, s * s - 3.0f * (a1 * a1 + a2 * a2 + a3 * a3 - 1.0f)))) / 3.0f;
+	}
+}
+
+
+GridFrame GridFrame::aroundOBB(OBB const& obb, float const voxelSize, float const padding) {
+	GridFrame frame;
+	frame.m_voxelSize = voxelSize;
+	frame.m_origin = glm::vec3(0.0f, 0.0f, 0.0f);
+
+	unsigned int const paddingCount = (unsigned int)glm::ceil(padding / voxelSize);
+	for (unsigned int a = 0; a < 3; ++a) {
+		frame.m_axes[a] = obb.m_axes[a];
+
+		//NOTE: adding 1 voxel to each side to handle edge cases (same as the voxelized OBB)
+		float const mid = (obb.m_min[a] + obb.m_max[a]) / 2;
+		unsigned int const halfCount = (unsigned int)glm::ceil((obb.m_max[a] - mid) / voxelSize) + 1 + paddingCount;
+		frame.m_nodeCounts[a] = 2 * halfCount + 1;
+		frame.m_origin += (mid - halfCount * voxelSize) * obb.m_axes[a];
+	}
+	return frame;
+}
+
+
+
+bool SignedDistanceField::build(std::vector<glm::vec3> const& verts, std::vector<unsigned int> const& faceIndices, GridFrame const& frame, unsigned int const bandWidth) {
+	m_frame = frame;
+	m_values.clear();
+
+	glm::uvec3 const n = frame.m_nodeCounts;
+	size_t const nodeCount = (size_t)n.x * n.y * n.z;
+	unsigned int const faceCount = (unsigned int)(faceIndices.size() / 3);
+	if (0 == nodeCount || 0 == faceCount) return false;
+
+	float const band = (float)glm::max<unsigned int>(bandWidth, 1); //NOTE: the sign flood fill needs at least 1 voxel of exact distances
+	auto toGridDirection = [&frame](glm::vec3 const& d) {
+		return glm::vec3(glm::dot(d, frame.m_axes[0]), glm::dot(d, frame.m_axes[1]), glm::dot(d, frame.m_axes[2]));
+	};
+
+	// 0. triangles in grid coords + pseudo-normals of every face, edge and vert...
+	//NOTE: the normals are computed from the world positions and only then rotated into the grid, so they stay correct if the OBB axes are left-handed
+	std::vector<glm::vec3> gridVerts(verts.size());
+	ParallelTools::parallelFor(verts.size(), [&](size_t const v) {
+		gridVerts.at(v) = frame.toGrid(verts.at(v));
+	});
+
+	std::vector<glm::vec3> faceNormals(faceCount);
+	std::vector<glm::vec3> vertexNormals(verts.size(), glm::vec3(0.0f, 0.0f, 0.0f));
+	std::unordered_map<uint64_t, glm::vec3> edgeNormals;
+	edgeNormals.reserve(3 * faceCount / 2);
+	auto edgeKey = [](unsigned int a, unsigned int b) -> uint64_t {
+		if (a > b) std::swap(a, b);
+		return ((uint64_t)a << 32) | b;
+	};
+
+	for (unsigned int f = 0; f < faceCount; ++f) {
+		glm::vec3 const areaNormal = glm::cross(verts.at(faceIndices.at(3 * f + 1)) - verts.at(faceIndices.at(3 * f)), verts.at(faceIndices.at(3 * f + 2)) - verts.at(faceIndices.at(3 * f)));
+		float const length = glm::length(areaNormal);
+		glm::vec3 const normal = length > 0.0f ? areaNormal / length : glm::vec3(0.0f, 0.0f, 0.0f);
+		faceNormals.at(f) = normal;
+
+		for (unsigned int c = 0; c < 3; ++c) {
+			unsigned int const v = faceIndices.at(3 * f + c);
+			unsigned int const vNext = faceIndices.at(3 * f + (c + 1) % 3);
+			unsigned int const vPrev = faceIndices.at(3 * f + (c + 2) % 3);
+
+			// angle weighted...
+			glm::vec3 const e1 = verts.at(vNext) - verts.at(v);
+			glm::vec3 const e2 = verts.at(vPrev) - verts.at(v);
+			float const l1 = glm::length(e1);
+			float const l2 = glm::length(e2);
+			if (l1 > 0.0f && l2 > 0.0f) {
+				vertexNormals.at(v) += glm::acos(glm::clamp(glm::dot(e1, e2) / (l1 * l2), -1.0f, 1.0f)) * normal;
+			}
+
+			edgeNormals[edgeKey(v, vNext)] += normal;
+		}
+	}
+
+	std::vector<glm::vec3> faceFeatureNormals(7 * faceCount); // per face, indexed by BVH::TriangleRegion
+	ParallelTools::parallelFor(faceCount, [&](size_t const f) {
+		unsigned int const v[3] = { faceIndices.at(3 * f), faceIndices.at(3 * f + 1), faceIndices.at(3 * f + 2) };
+		glm::vec3 *featureNormals = &faceFeatureNormals.at(7 * f);
+		featureNormals[BVH::TriangleRegion::FACE] = toGridDirection(faceNormals.at(f));
+		for (unsigned int c = 0; c < 3; ++c) {
+			featureNormals[BVH::TriangleRegion::VERTEX_A + c] = toGridDirection(vertexNormals.at(v[c]));
+			featureNormals[BVH::TriangleRegion::EDGE_AB + c] = toGridDirection(edgeNormals.at(edgeKey(v[c], v[(c + 1) % 3])));
+		}
+	});
+
+	// 1. NARROW BAND...
+	// every face is binned once into the V3 layers its band touches, then each thread owns a slab of V3 layers, so no node is ever written by 2 threads
+	//NOTE: a layer only visits its own faces (in face order, so ties resolve the same as a plain loop over all faces)
+	std::vector<glm::uvec3> faceLows(faceCount);
+	std::vector<glm::uvec3> faceHighs(faceCount);
+	std::vector<unsigned char> isFaceInGrid(faceCount);
+	ParallelTools::parallelFor(faceCount, [&](size_t const f) {
+		glm::vec3 const& a = gridVerts.at(faceIndices.at(3 * f));
+		glm::vec3 const& b = gridVerts.at(faceIndices.at(3 * f + 1));
+		glm::vec3 const& c = gridVerts.at(faceIndices.at(3 * f + 2));
+
+		glm::vec3 const lo = glm::max(glm::ceil(glm::min(a, glm::min(b, c)) - band), glm::vec3(0.0f, 0.0f, 0.0f));
+		glm::vec3 const hi = glm::min(glm::floor(glm::max(a, glm::max(b, c)) + band), glm::vec3(n) - 1.0f);
+		isFaceInGrid[f] = (lo.x > hi.x || lo.y > hi.y || lo.z > hi.z) ? 0 : 1;
+		if (isFaceInGrid[f]) {
+			faceLows[f] = glm::uvec3(lo);
+			faceHighs[f] = glm::uvec3(hi);
+		}
+	});
+
+	std::vector<size_t> layerOffsets(n.z + 1, 0); // faces of layer i are layerFaces[layerOffsets[i], layerOffsets[i + 1])
+	for (unsigned int f = 0; f < faceCount; ++f) {
+		if (!isFaceInGrid[f]) continue;
+		for (unsigned int i = faceLows[f].z; i <= faceHighs[f].z; ++i) ++layerOffsets[i + 1];
+	}
+	for (unsigned int i = 0; i < n.z; ++i) layerOffsets[i + 1] += layerOffsets[i];
+	std::vector<unsigned int> layerFaces(layerOffsets[n.z]);
+	std::vector<size_t> layerFills(layerOffsets.begin(), layerOffsets.end() - 1);
+	for (unsigned int f = 0; f < faceCount; ++f) {
+		if (!isFaceInGrid[f]) continue;
+		for (unsigned int i = faceLows[f].z; i <= faceHighs[f].z; ++i) layerFaces[layerFills[i]++] = f;
+	}
+
+	std::vector<float> distances(nodeCount, std::numeric_limits<float>::max()); // in voxels
+	std::vector<signed char> signs(nodeCount, 1);
+	ParallelTools::parallelForRange(n.z, [&](size_t const begin, size_t const end, unsigned int const) {
+		for (unsigned int i = (unsigned int)begin; i < end; ++i) {
+			for (size_t l = layerOffsets[i]; l < layerOffsets[i + 1]; ++l) {
+				unsigned int const f = layerFaces[l];
+				glm::vec3 const& a = gridVerts.at(faceIndices.at(3 * f));
+				glm::vec3 const& b = gridVerts.at(faceIndices.at(3 * f + 1));
+				glm::vec3 const& c = gridVerts.at(faceIndices.at(3 * f + 2));
+
+				for (unsigned int j = faceLows[f].y; j <= faceHighs[f].y; ++j) {
+					for (unsigned int k = faceLows[f].x; k <= faceHighs[f].x; ++k) {
+						glm::vec3 const p((float)k, (float)j, (float)i);
+						BVH::TriangleRegion region;
+						glm::vec3 const q = BVH::closestPointOnTriangle(p, a, b, c, region);
+						float const d = glm::length(p - q);
+
+						size_t const index = toIndex(i, j, k);
+						if (d < distances[index]) {
+							distances[index] = d;
+							signs[index] = glm::dot(p - q, faceFeatureNormals.at(7 * f + region)) >= 0.0f ? 1 : -1;
+						}
+					}
+				}
+			}
+		}
+	}, 1);
+
+	std::vector<unsigned char> isFrozen(nodeCount);
+	ParallelTools::parallelFor(nodeCount, [&](size_t const index) {
+		isFrozen[index] = distances[index] <= band ? 1 : 0;
+	});
+
+	// 2. FAST SWEEPING...
+	// every round runs the 8 sweep orderings on their own copy in parallel and keeps the smallest value of each node
+	//NOTE: nodes outside the band keep whatever exact (but not necessarily closest) distance they got as an upper bound
+	auto sweep = [&](std::vector<float> &values, unsigned int const ordering) {
+		int const stepK = (ordering & 1) ? -1 : 1;
+		int const stepJ = (ordering & 2) ? -1 : 1;
+		int const stepI = (ordering & 4) ? -1 : 1;
+		float const far = std::numeric_limits<float>::max();
+
+		for (int i = (1 == stepI ? 0 : (int)n.z - 1); i >= 0 && i < (int)n.z; i += stepI) {
+			for (int j = (1 == stepJ ? 0 : (int)n.y - 1); j >= 0 && j < (int)n.y; j += stepJ) {
+				for (int k = (1 == stepK ? 0 : (int)n.x - 1); k >= 0 && k < (int)n.x; k += stepK) {
+					size_t const index = toIndex(i, j, k);
+					if (isFrozen[index]) continue;
+
+					float const aK = glm::min(k > 0 ? values[index - 1] : far, k + 1 < (int)n.x ? values[index + 1] : far);
+					float const aJ = glm::min(j > 0 ? values[index - n.x] : far, j + 1 < (int)n.y ? values[index + n.x] : far);
+					float const aI = glm::min(i > 0 ? values[index - (size_t)n.x * n.y] : far, i + 1 < (int)n.z ? values[index + (size_t)n.x * n.y] : far);
+					if (far == glm::min(aK, glm::min(aJ, aI))) continue;
+
+					values[index] = glm::min(values[index], solveEikonal(aK, aJ, aI));
+				}
+			}
+		}
+	};
+
+	std::vector<std::vector<float>> sweepValues(8);
+	for (unsigned int round = 0; round < 8; ++round) {
+		ParallelTools::parallelFor(8, [&](size_t const ordering) {
+			sweepValues.at(ordering) = distances;
+			sweep(sweepValues.at(ordering), (unsigned int)ordering);
+		}, 1);
+
+		unsigned int const threadCount = ParallelTools::getThreadCount();
+		std::vector<float> threadChanges(threadCount, 0.0f);
+		ParallelTools::parallelForRange(nodeCount, [&](size_t const begin, size_t const end, unsigned int const threadIndex) {
+			float change = 0.0f;
+			for (size_t index = begin; index < end; ++index) {
+				float value = distances[index];
+				for (std::vector<float> const& values : sweepValues) value = glm::min(value, values[index]);
+				if (value < distances[index]) {
+					change = glm::max(change, distances[index] - value);
+					distances[index] = value;
+				}
+			}
+			threadChanges.at(threadIndex) = change;
+		});
+
+		if (*std::max_element(threadChanges.begin(), threadChanges.end()) < 1e-3f) break;
+	}
+
+	// 3. SIGN...
+	// every node within 1 voxel of the surface blocks the flood fill (no 6-neighbour step can cross the surface without landing on one of them)
+	VoxelGrid nodeClasses(n.x, n.y, n.z);
+	for (unsigned int i = 0; i < n.z; ++i) {
+		for (unsigned int j = 0; j < n.y; ++j) {
+			for (unsigned int k = 0; k < n.x; ++k) {
+				if (distances[toIndex(i, j, k)] <= 1.0f) nodeClasses.set(i, j, k, VoxelClass::FEATURE_CYAN);
+			}
+		}
+	}
+	nodeClasses.classifyInnerVoxels();
+
+	m_values.resize(nodeCount);
+	std::vector<VoxelClass> const& classes = nodeClasses.getClasses();
+	ParallelTools::parallelFor(nodeCount, [&](size_t const index) {
+		float sign = 1.0f;
+		if (VoxelClass::FEATURE_CYAN == classes[index]) sign = signs[index];
+		else if (VoxelClass::INNER_MAGENTA == classes[index]) sign = -1.0f;
+		m_values[index] = sign * distances[index] * frame.m_voxelSize;
+	});
+
+	return true;
+}
+
+
+
+float SignedDistanceField::getDistance(glm::vec3 const& p) const {
+	if (m_values.empty()) return std::numeric_limits<float>::max();
+
+	glm::uvec3 const n = m_frame.m_nodeCounts;
+	glm::vec3 const g = glm::clamp(m_frame.toGrid(p), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(n) - 1.0f);
+	glm::uvec3 const base = glm::min(glm::uvec3(g), n - glm::uvec3(2, 2, 2)); //NOTE: assumes at least 2 nodes along every axis
+	glm::vec3 const t = g - glm::vec3(base);
+
+	float value = 0.0f;
+	for (unsigned int c = 0; c < 8; ++c) {
+		glm::uvec3 const offset((c & 1) ? 1 : 0, (c & 2) ? 1 : 0, (c & 4) ? 1 : 0);
+		glm::vec3 const w = glm::mix(glm::vec3(1.0f) - t, t, glm::vec3(offset));
+		value += w.x * w.y * w.z * getNodeValue(base.z + offset.z, base.y + offset.y, base.x + offset.x);
+	}
+	return value;
+}
+
+
+
+void SignedDistanceField::extractSurface(float const isoValue, std::vector<glm::vec3> &out_verts, std::vector<unsigned int> &out_faceIndices) const {
+	out_verts.clear();
+	out_faceIndices.clear();
+
+	glm::uvec3 const n = m_frame.m_nodeCounts;
+	if (m_values.empty() || n.x < 2 || n.y < 2 || n.z < 2) return;
+
+	// cube corner c has bit 0 = +1 along V1 (k), bit 1 = +1 along V2 (j), bit 2 = +1 along V3 (i)
+	// the 6 tetrahedra of a cube all share the main diagonal 0 -> 7 and walk to it along the cube edges in a different axis order
+	//NOTE: every tetrahedron edge goes from a corner to a corner with a superset of its bits, so an edge is identified by its lower node + the bits it adds
+	static unsigned int const s_TETRAHEDRA[6][4] = {
+		{ 0, 1, 3, 7 }, { 0, 1, 5, 7 }, { 0, 2, 3, 7 },
+		{ 0, 2, 6, 7 }, { 0, 4, 5, 7 }, { 0, 4, 6, 7 },
+	};
+
+	//NOTE: a node exactly on the iso-value is nudged outside, otherwise several edges could put a surface vert on the same node (zero area faces)
+	float const nudge = 1e-6f * m_frame.m_voxelSize;
+	auto valueAt = [&](size_t const index) {
+		float const value = m_values[index];
+		return value == isoValue ? isoValue + nudge : value;
+	};
+
+	// 1. per slab of cubes, the faces as 3 edge keys each + the surface vert of every key...
+	unsigned int const threadCount = ParallelTools::getThreadCount();
+	std::vector<std::vector<uint64_t>> threadKeys(threadCount);
+	std::vector<std::vector<glm::vec3>> threadPositions(threadCount);
+
+	ParallelTools::parallelForRange(n.z - 1, [&](size_t const begin, size_t const end, unsigned int const threadIndex) {
+		std::vector<uint64_t> &keys = threadKeys.at(threadIndex);
+		std::vector<glm::vec3> &positions = threadPositions.at(threadIndex);
+
+		for (unsigned int i = (unsigned int)begin; i < end; ++i) {
+			for (unsigned int j = 0; j + 1 < n.y; ++j) {
+				for (unsigned int k = 0; k + 1 < n.x; ++k) {
+					size_t cornerIndices[8];
+					float cornerValues[8];
+					unsigned int insideMask = 0;
+					for (unsigned int c = 0; c < 8; ++c) {
+						cornerIndices[c] = toIndex(i + ((c >> 2) & 1), j + ((c >> 1) & 1), k + (c & 1));
+						cornerValues[c] = valueAt(cornerIndices[c]);
+						if (cornerValues[c] < isoValue) insideMask |= 1 << c;
+					}
+					if (0 == insideMask || 0xFF == insideMask) continue;
+
+					glm::vec3 const cubeOrigin((float)k, (float)j, (float)i);
+					auto cornerPosition = [&cubeOrigin](unsigned int const c) {
+						return cubeOrigin + glm::vec3((float)(c & 1), (float)((c >> 1) & 1), (float)((c >> 2) & 1));
+					};
+
+					// surface vert on the edge between cube corners c0 and c1 (interpolated from the lower corner, so every cube computes the exact same position)
+					auto emitVert = [&](unsigned int c0, unsigned int c1) -> glm::vec3 {
+						if ((c0 & c1) != c0) std::swap(c0, c1);
+						keys.push_back(cornerIndices[c0] * 7 + ((c0 ^ c1) - 1));
+						float const t = (isoValue - cornerValues[c0]) / (cornerValues[c1] - cornerValues[c0]);
+						glm::vec3 const position = glm::mix(cornerPosition(c0), cornerPosition(c1), t);
+						positions.push_back(position);
+						return position;
+					};
+
+					for (unsigned int const (&tetrahedron)[4] : s_TETRAHEDRA) {
+						unsigned int inside[4];
+						unsigned int outside[4];
+						unsigned int insideCount = 0;
+						unsigned int outsideCount = 0;
+						for (unsigned int const c : tetrahedron) {
+							if (insideMask & (1 << c)) inside[insideCount++] = c;
+							else outside[outsideCount++] = c;
+						}
+						if (0 == insideCount || 0 == outsideCount) continue;
+
+						// the faces have to face the outside corners (the side with larger values)
+						glm::vec3 towardsOutside(0.0f, 0.0f, 0.0f);
+						for (unsigned int o = 0; o < outsideCount; ++o) towardsOutside += cornerPosition(outside[o]) / (float)outsideCount;
+						for (unsigned int o = 0; o < insideCount; ++o) towardsOutside -= cornerPosition(inside[o]) / (float)insideCount;
+
+						auto emitFace = [&](unsigned int const a0, unsigned int const a1, unsigned int const b0, unsigned int const b1, unsigned int const c0, unsigned int const c1) {
+							size_t const first = keys.size();
+							glm::vec3 const pa = emitVert(a0, a1);
+							glm::vec3 const pb = emitVert(b0, b1);
+							glm::vec3 const pc = emitVert(c0, c1);
+							if (glm::dot(glm::cross(pb - pa, pc - pa), towardsOutside) < 0.0f) {
+								std::swap(keys.at(first + 1), keys.at(first + 2));
+								std::swap(positions.at(first + 1), positions.at(first + 2));
+							}
+						};
+
+						if (1 == insideCount) {
+							emitFace(inside[0], outside[0], inside[0], outside[1], inside[0], outside[2]);
+						}
+						else if (3 == insideCount) {
+							emitFace(outside[0], inside[0], outside[0], inside[1], outside[0], inside[2]);
+						}
+						else {
+							// quad (x-z, x-w, y-w, y-z) for inside {x, y} and outside {z, w}
+							emitFace(inside[0], outside[0], inside[0], outside[1], inside[1], outside[1]);
+							emitFace(inside[0], outside[0], inside[1], outside[1], inside[1], outside[0]);
+						}
+					}
+				}
+			}
+		}
+	}, 1);
+
+	// 2. weld the surface verts by edge key...
+	std::vector<uint64_t> keys;
+	std::vector<glm::vec3> positions;
+	for (unsigned int t = 0; t < threadCount; ++t) {
+		keys.insert(keys.end(), threadKeys.at(t).begin(), threadKeys.at(t).end());
+		positions.insert(positions.end(), threadPositions.at(t).begin(), threadPositions.at(t).end());
+	}
+
+	std::vector<uint64_t> uniqueKeys = keys;
+	std::sort(uniqueKeys.begin(), uniqueKeys.end());
+	uniqueKeys.erase(std::unique(uniqueKeys.begin(), uniqueKeys.end()), uniqueKeys.end());
+
+	out_faceIndices.resize(keys.size());
+	ParallelTools::parallelFor(keys.size(), [&](size_t const occurrence) {
+		out_faceIndices[occurrence] = (unsigned int)(std::lower_bound(uniqueKeys.begin(), uniqueKeys.end(), keys[occurrence]) - uniqueKeys.begin());
+	});
+
+	out_verts.resize(uniqueKeys.size());
+	for (size_t occurrence = 0; occurrence < keys.size(); ++occurrence) {
+		out_verts[out_faceIndices[occurrence]] = positions[occurrence];
+	}
+
+	// 3. back to world space (a left-handed OBB basis mirrors the grid, so the winding has to be flipped back)...
+	ParallelTools::parallelFor(out_verts.size(), [&](size_t const v) {
+		out_verts[v] = m_frame.toWorld(out_verts[v]);
+	});
+	if (glm::dot(glm::cross(m_frame.m_axes[0], m_frame.m_axes[1]), m_frame.m_axes[2]) < 0.0f) {
+		for (size_t f = 0; f < out_faceIndices.size(); f += 3) std::swap(out_faceIndices[f + 1], out_faceIndices[f + 2]);
+	}
+}
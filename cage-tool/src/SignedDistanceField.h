@@ -0,0 +1,64 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "OBBTools.h"
+
+
+// OBB aligned lattice of sample points (the corners of the voxels of the cage generation grid)
+//NOTE: node (i, j, k) is i on V3, j on V2, k on V1 (same convention as the obb space and VoxelGrid)
+struct GridFrame {
+	glm::vec3 m_axes[3] = { glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f) }; // V1, V2, V3 (orthonormal)
+	glm::vec3 m_origin = glm::vec3(0.0f, 0.0f, 0.0f); // world position of node (0, 0, 0)
+	float m_voxelSize = 1.0f;
+	glm::uvec3 m_nodeCounts = glm::uvec3(0, 0, 0); // .x (along V1), .y (along V2), .z (along V3)
+
+	// grid coords are continuous node indices - .x (in V1 axis), .y (in V2 axis), .z (in V3 axis)
+	glm::vec3 toGrid(glm::vec3 const& p) const {
+		glm::vec3 const d = p - m_origin;
+		return glm::vec3(glm::dot(d, m_axes[0]), glm::dot(d, m_axes[1]), glm::dot(d, m_axes[2])) / m_voxelSize;
+	}
+	glm::vec3 toWorld(glm::vec3 const& gridCoord) const {
+		return m_origin + m_voxelSize * (gridCoord.x * m_axes[0] + gridCoord.y * m_axes[1] + gridCoord.z * m_axes[2]);
+	}
+
+	// same centring and voxel size as the voxelized OBB of Program::generatePointSetP2, grown by at least padding on every side
+	static GridFrame aroundOBB(OBB const& obb, float const voxelSize, float const padding);
+};
+
+
+// signed distance to a triangle mesh, sampled on a GridFrame (negative inside)
+// 1. narrow band - exact point-triangle distances for the nodes within bandWidth voxels of each triangle (faces binned into grid layers once, then parallel over slabs of layers)
+// 2. everywhere else - the distances are propagated out of the band by fast sweeping (the 8 sweep orderings run in parallel and get merged)
+// 3. sign - angle weighted pseudo-normals of the closest feature inside the band, an exterior flood fill (see VoxelGrid) outside of it
+// reference: https://en.wikipedia.org/wiki/Signed_distance_function
+// reference: Zhao - A fast sweeping method for Eikonal equations (2005), Zhao - Parallel implementations of the fast sweeping method (2007)
+// reference: Baerentzen, Aanaes - Signed distance computation using the angle weighted pseudonormal (2005)
+//NOTE: the sign is only meaningful for closed models, for models with holes the flood fill leaks and the inside is treated as outside
+class SignedDistanceField {
+
+public:
+	// RETURNS false if there is nothing to sample (no faces or an empty frame)
+	//NOTE: faces are 3 indices in a row into verts (CCW when seen from outside), coincident verts should be welded for the pseudo-normals to be correct
+	bool build(std::vector<glm::vec3> const& verts, std::vector<unsigned int> const& faceIndices, GridFrame const& frame, unsigned int const bandWidth = 2);
+
+	GridFrame const& getFrame() const { return m_frame; }
+	bool isEmpty() const { return m_values.empty(); }
+
+	size_t toIndex(unsigned int const i, unsigned int const j, unsigned int const k) const { return ((size_t)i * m_frame.m_nodeCounts.y + j) * m_frame.m_nodeCounts.x + k; }
+	float getNodeValue(unsigned int const i, unsigned int const j, unsigned int const k) const { return m_values[toIndex(i, j, k)]; }
+
+	// trilinear interpolation of the node values (clamped to the grid)
+	float getDistance(glm::vec3 const& p) const;
+	bool isInside(glm::vec3 const& p) const { return getDistance(p) < 0.0f; }
+
+	// iso-surface {distance == isoValue} as a closed triangle mesh (CCW when seen from outside, i.e. from the side with larger values)
+	// parallel marching tetrahedra - every cube is split into 6 tetrahedra along its main diagonal, so there are no ambiguous cases and the output is always a closed manifold
+	//NOTE: surface verts sit on (and are welded along) the edges of the tetrahedra, 3 indices in a row per face
+	void extractSurface(float const isoValue, std::vector<glm::vec3> &out_verts, std::vector<unsigned int> &out_faceIndices) const;
+
+private:
+	GridFrame m_frame;
+	std::vector<float> m_values; // indexed by toIndex
+};
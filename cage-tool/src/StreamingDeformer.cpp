@@ -0,0 +1,167 @@
+#include "StreamingDeformer.h"
+
+#include <boost/algorithm/string.hpp>
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "ByteOrder.h"
+#include "MappedFile.h"
+#include "MeanValueCoordinates.h"
+#include "ObjectLoader.h"
+#include "ParallelTools.h"
+#include "WindingNumber.h"
+
+
+namespace {
+	// just the verts + faces of a cage (as they are in the file, no MeshObject, so no OpenGL needed)
+	//NOTE: the parser is picked by the file extension (like ObjectLoader::createTriMeshObject)
+	bool loadCage(std::string const& filePath, std::vector<glm::vec3> &out_verts, std::vector<GLuint> &out_faces) {
+		size_t const dotIndex = filePath.find_last_of(".");
+		std::string const extension = std::string::npos == dotIndex ? "" : filePath.substr(dotIndex + 1);
+
+		std::vector<glm::vec2> uvs;
+		std::vector<glm::vec3> normals;
+		if (boost::iequals(extension, "ply")) {
+			return ObjectLoader::loadTriMeshPLY(filePath, out_verts, uvs, normals, out_faces);
+		}
+		if (boost::iequals(extension, "stl")) {
+			return ObjectLoader::loadTriMeshSTL(filePath, out_verts, out_faces);
+		}
+		if (boost::iequals(extension, "obj")) {
+			std::vector<glm::ivec3> facePoints;
+			if (!ObjectLoader::loadTriMeshOBJ(filePath, out_verts, uvs, normals, facePoints)) return false;
+			out_faces.resize(facePoints.size());
+			for (size_t i = 0; i < facePoints.size(); ++i) out_faces[i] = (GLuint)facePoints[i].x;
+			return true;
+		}
+
+		std::cout << "ERROR (StreamingDeformer.cpp) - unsupported cage file extension \"" << extension << "\" of " << filePath << " (supported: obj, ply, stl)" << std::endl;
+		return false;
+	}
+
+	bool writeBytes(FILE *fp, char const* data, size_t const size) {
+		return 0 == size || size == fwrite(data, 1, size, fp);
+	}
+}
+
+
+bool StreamingDeformer::deformPLY(std::string const& modelPath, std::string const& restCagePath, std::string const& posedCagePath, std::string const& outputPath, size_t const chunkVertCount) {
+
+	// 1. cages...
+	std::vector<glm::vec3> restCageVerts;
+	std::vector<GLuint> restCageFaces;
+	std::vector<glm::vec3> posedCageVerts;
+	std::vector<GLuint> posedCageFaces;
+	if (!loadCage(restCagePath, restCageVerts, restCageFaces) || !loadCage(posedCagePath, posedCageVerts, posedCageFaces)) {
+		std::cout << "ERROR (StreamingDeformer.cpp) - could not load the cages " << restCagePath << " and " << posedCagePath << std::endl;
+		return false;
+	}
+	if (restCageVerts.size() != posedCageVerts.size() || restCageFaces != posedCageFaces) {
+		std::cout << "ERROR (StreamingDeformer.cpp) - the rest and posed cage have different verts/faces" << std::endl;
+		return false;
+	}
+
+	WindingNumber windingNumber;
+	if (!windingNumber.build(restCageVerts, restCageFaces)) {
+		std::cout << "ERROR (StreamingDeformer.cpp) - cage has no faces" << std::endl;
+		return false;
+	}
+
+	// 2. model...
+	MappedFile model;
+	if (!model.open(modelPath)) {
+		std::cout << "ERROR (StreamingDeformer.cpp) - could not open " << modelPath << std::endl;
+		return false;
+	}
+	PLYVertexLayout layout;
+	if (!ObjectLoader::findPLYVertexLayout(model.getData(), model.getSize(), modelPath, layout)) return false;
+
+	FILE *fp = fopen(outputPath.c_str(), "wbx");
+	if (NULL == fp) {
+		std::cout << "ERROR (StreamingDeformer.cpp) - could not create " << outputPath << " (it may already exist)" << std::endl;
+		return false;
+	}
+
+	// 3. header as is, then the vertex records chunk by chunk...
+	//NOTE: chunk c is written (background thread) while chunk c+1 is computed, so the 2 buffers take turns
+	bool isWritten = writeBytes(fp, model.getData(), layout.m_dataOffset);
+	bool isEnclosed = true;
+	bool isWriteDone = true; // set by the writer thread
+	std::thread writer;
+	std::vector<char> chunks[2];
+
+	size_t const verts = std::max<size_t>(chunkVertCount, 1);
+	std::vector<std::vector<float>> threadWeights(ParallelTools::getThreadCount());
+	std::vector<size_t> threadOutsideCounts(threadWeights.size());
+	std::vector<size_t> threadOnCounts(threadWeights.size());
+
+	size_t chunkIndex = 0;
+	for (size_t chunkBegin = 0; isWritten && isEnclosed && chunkBegin < layout.m_vertCount; chunkBegin += verts, ++chunkIndex) {
+		size_t const chunkVerts = std::min(verts, layout.m_vertCount - chunkBegin);
+		std::vector<char> &records = chunks[chunkIndex % 2]; // (its last write was joined before the previous chunk's write started)
+		char const* in = model.getData() + layout.m_dataOffset + chunkBegin * layout.m_recordSize;
+		records.assign(in, in + chunkVerts * layout.m_recordSize);
+
+		ParallelTools::parallelForRange(chunkVerts, [&](size_t const begin, size_t const end, unsigned int const threadIndex) {
+			std::vector<float> &weights = threadWeights[threadIndex];
+			for (size_t i = begin; i < end; ++i) {
+				char *record = records.data() + i * layout.m_recordSize;
+				glm::vec3 x;
+				for (int c = 0; c < 3; ++c) x[c] = ByteOrder::read<float>(record + layout.m_positionOffsets[c], layout.m_isSwapped);
+
+				// same test as validating the cage enclosure in the tool (the weights are only valid inside the cage)
+				bool isOnCage = false;
+				if (windingNumber.evaluate(x, isOnCage) < 0.5f && !isOnCage) {
+					++threadOutsideCounts[threadIndex];
+					continue;
+				}
+				if (isOnCage || !MeanValueCoordinates::computeWeights(x, restCageVerts, restCageFaces, weights)) {
+					++threadOnCounts[threadIndex];
+					continue;
+				}
+
+				glm::vec3 deformed = glm::vec3(0.0f, 0.0f, 0.0f);
+				for (size_t j = 0; j < weights.size(); ++j) deformed += weights[j] * posedCageVerts[j];
+				for (int c = 0; c < 3; ++c) ByteOrder::write<float>(record + layout.m_positionOffsets[c], deformed[c], layout.m_isSwapped);
+			}
+		}, 256);
+
+		size_t outsideCount = 0;
+		size_t onCount = 0;
+		for (size_t t = 0; t < threadWeights.size(); ++t) {
+			outsideCount += threadOutsideCounts[t];
+			onCount += threadOnCounts[t];
+		}
+		if (outsideCount > 0 || onCount > 0) {
+			std::cout << "ERROR (StreamingDeformer.cpp) - cage doesn't enclose the model: " << outsideCount << " model verts outside of the cage, " << onCount << " on the cage (in verts " << chunkBegin << " to " << chunkBegin + chunkVerts << ")" << std::endl;
+			isEnclosed = false;
+			break;
+		}
+
+		if (writer.joinable()) writer.join();
+		isWritten = isWriteDone;
+		writer = std::thread([fp, &records, &isWriteDone]() { isWriteDone = writeBytes(fp, records.data(), records.size()); });
+	}
+	if (writer.joinable()) writer.join();
+	isWritten = isWritten && isWriteDone;
+
+	// 4. ...and whatever comes after the vertex records (faces, other elements) as is
+	size_t const tailOffset = layout.m_dataOffset + layout.m_vertCount * layout.m_recordSize;
+	isWritten = isWritten && isEnclosed && writeBytes(fp, model.getData() + tailOffset, model.getSize() - tailOffset);
+
+	bool const isClosed = 0 == fclose(fp);
+	if (!isEnclosed || !isWritten || !isClosed) {
+		std::remove(outputPath.c_str());
+		if (isEnclosed) std::cout << "ERROR (StreamingDeformer.cpp) - failed to write " << outputPath << std::endl;
+		return false;
+	}
+
+	std::cout << "deformed " << layout.m_vertCount << " verts of " << modelPath << " in chunks of " << verts << " verts into " << outputPath << std::endl;
+	return true;
+}
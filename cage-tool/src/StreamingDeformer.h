@@ -0,0 +1,21 @@
+#pragma once
+
+#include <string>
+
+
+// headless MVC deformation of models that don't have to fit into memory - the weight matrix (model verts x cage verts) never exists
+// 1. the model (binary PLY) is memory mapped, its header and everything after the vertex records are copied to the output as they are
+// 2. the vertex records are read in chunks, every chunk in parallel: each vert is checked to be inside the rest cage, gets its weights against the rest cage, and is moved to the weighted sum of the posed cage verts right away
+// 3. a finished chunk is written on a background thread while the next one gets computed
+//NOTE: memory use is 2 chunks + 1 weight vector per thread, no matter how large the model is
+//NOTE: only x, y and z are replaced, any other vertex property (incl. normals) is copied as is
+class StreamingDeformer {
+
+public:
+	static size_t const s_DEFAULT_CHUNK_VERT_COUNT = 65536;
+
+	// the rest and posed cage (obj, ply or stl) have to have the same verts (in the same order) and faces, e.g. a cage and its export after posing it
+	// RETURNS false if anything is invalid, a model vert isn't inside the rest cage, or the output could not be written (or already exists)
+	//NOTE: a partially written output is deleted again
+	static bool deformPLY(std::string const& modelPath, std::string const& restCagePath, std::string const& posedCagePath, std::string const& outputPath, size_t const chunkVertCount = s_DEFAULT_CHUNK_VERT_COUNT);
+};
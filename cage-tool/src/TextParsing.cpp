@@ -0,0 +1,147 @@
+#include "TextParsing.h"
+
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+
+namespace {
+	// every power of 10 up to 10^22 is exactly representable as a double
+	double const s_POWERS_OF_10[] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+		1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+	};
+
+	bool isDigit(char const c) {
+		return '0' <= c && c <= '9';
+	}
+}
+
+
+// reference: Clinger - How to Read Floating Point Numbers Accurately (1990)
+// 1. up to 19 significant decimal digits are accumulated into an integer mantissa, with a decimal exponent on the side
+// 2. if the mantissa fits in a double exactly (<= 2^53) and |exponent| <= 22, a single double multiply/divide is correctly rounded
+// 3. rounding that double to float is only ambiguous if it landed exactly halfway between 2 floats - those (rare) cases, and anything outside of 2., go through strtof
+char const* TextParsing::parseFloat(char const* begin, char const* end, float &out_value) {
+	char const* p = begin;
+	bool const isNegative = p < end && '-' == *p;
+	if (p < end && ('-' == *p || '+' == *p)) ++p;
+
+	// hex floats
+	if (p + 1 < end && '0' == p[0] && ('x' == p[1] || 'X' == p[1])) return parseFloatSlow(begin, end, out_value);
+
+	// 1. mantissa...
+	uint64_t mantissa = 0;
+	int digitCount = 0; // significant digits in mantissa
+	int exponent = 0;
+	bool isTruncated = false;
+	bool hasDigits = false;
+
+	for (; p < end && isDigit(*p); ++p) {
+		hasDigits = true;
+		if (0 == mantissa && '0' == *p) continue; // leading zero
+		if (digitCount < 19) {
+			mantissa = mantissa * 10 + (*p - '0');
+			++digitCount;
+		} else {
+			++exponent;
+			isTruncated |= '0' != *p;
+		}
+	}
+	if (p < end && '.' == *p) {
+		++p;
+		for (; p < end && isDigit(*p); ++p) {
+			hasDigits = true;
+			if (0 == mantissa && '0' == *p) {
+				--exponent;
+				continue;
+			}
+			if (digitCount < 19) {
+				mantissa = mantissa * 10 + (*p - '0');
+				++digitCount;
+				--exponent;
+			} else {
+				isTruncated |= '0' != *p;
+			}
+		}
+	}
+	if (!hasDigits) return parseFloatSlow(begin, end, out_value); // inf, nan or no number at all
+
+	// ...exponent (an 'e' without digits isn't part of the number)
+	if (p < end && ('e' == *p || 'E' == *p)) {
+		char const* q = p + 1;
+		bool const isExponentNegative = q < end && '-' == *q;
+		if (q < end && ('-' == *q || '+' == *q)) ++q;
+		if (q < end && isDigit(*q)) {
+			int exponentDigits = 0;
+			for (; q < end && isDigit(*q); ++q) {
+				if (exponentDigits < 100000) exponentDigits = exponentDigits * 10 + (*q - '0'); // large enough to over/underflow anyway
+			}
+			exponent += isExponentNegative ? -exponentDigits : exponentDigits;
+			p = q;
+		}
+	}
+
+	if (0 == mantissa) {
+		out_value = isNegative ? -0.0f : 0.0f;
+		return p;
+	}
+
+	// 2. fast path...
+	if (isTruncated || mantissa > (uint64_t(1) << 53) || exponent < -22 || exponent > 22) return parseFloatSlow(begin, end, out_value);
+
+	double const value = exponent < 0 ? (double)mantissa / s_POWERS_OF_10[-exponent] : (double)mantissa * s_POWERS_OF_10[exponent];
+
+	// 3. halfway between 2 floats? (the 29 low mantissa bits a float doesn't have are exactly 100...0)
+	//NOTE: value is in [1e-22, 1e41], so it is never a denormal float
+	uint64_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	uint64_t const lowBitsMask = (uint64_t(1) << 29) - 1;
+	if ((bits & lowBitsMask) == (uint64_t(1) << 28)) return parseFloatSlow(begin, end, out_value);
+
+	float const result = (float)value;
+	if (std::isinf(result)) return nullptr; // out of range
+	out_value = isNegative ? -result : result;
+	return p;
+}
+
+
+char const* TextParsing::parseFloatSlow(char const* begin, char const* end, float &out_value) {
+	// strtof needs a null terminated copy of the token
+	char const* tokenEnd = begin;
+	while (tokenEnd < end && !isSpace(*tokenEnd)) ++tokenEnd;
+	size_t const length = tokenEnd - begin;
+
+	char buffer[64];
+	std::string longToken;
+	char const* token = buffer;
+	if (length < sizeof(buffer)) {
+		std::memcpy(buffer, begin, length);
+		buffer[length] = '\0';
+	} else {
+		longToken.assign(begin, length);
+		token = longToken.c_str();
+	}
+
+	char *parseEnd = nullptr;
+	errno = 0;
+	float const value = std::strtof(token, &parseEnd);
+	if (parseEnd == token || ERANGE == errno) return nullptr;
+
+	out_value = value;
+	return begin + (parseEnd - token);
+}
+
+
+char const* TextParsing::parseInt(char const* begin, char const* end, int &out_value) {
+	char const* p = begin;
+	if (p + 1 < end && '+' == *p && isDigit(p[1])) ++p; // from_chars doesn't take a '+'
+
+	std::from_chars_result const result = std::from_chars(p, end, out_value);
+	if (std::errc() != result.ec) return nullptr;
+	return result.ptr;
+}
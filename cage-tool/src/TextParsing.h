@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+
+
+// allocation free number parsing straight out of a (not null terminated) text buffer, e.g. a MappedFile
+//NOTE: std::from_chars is only used for ints - floating point from_chars is missing from the v141 toolset, so floats get their own fast path (see parseFloat)
+class TextParsing {
+
+public:
+	// parse a number from the START of [begin, end), with the same rules as std::stof/std::stoi (optional leading '+'/'-', trailing characters are ignored)
+	// RETURNS nullptr if there is no number or it is out of range (i.e. whenever std::stof/std::stoi would throw), otherwise one past its last character
+	static char const* parseFloat(char const* begin, char const* end, float &out_value);
+	static char const* parseInt(char const* begin, char const* end, int &out_value);
+
+	// ' ' or '\t' (the separators between tokens within a line)
+	static bool isBlank(char const c) { return ' ' == c || '\t' == c; }
+	// std::isspace in the "C" locale
+	static bool isSpace(char const c) { return ' ' == c || ('\t' <= c && c <= '\r'); }
+
+private:
+	// correctly rounded (std::strtof) parse of whatever parseFloat's fast path can't handle (e.g. inf/nan, hex floats, > 19 significant digits)
+	static char const* parseFloatSlow(char const* begin, char const* end, float &out_value);
+};
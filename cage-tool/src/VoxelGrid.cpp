@@ -0,0 +1,89 @@
+#include "VoxelGrid.h"
+
+#include <atomic>
+
+#include "ParallelTools.h"
+
+VoxelGrid::VoxelGrid(unsigned int const nV1, unsigned int const nV2, unsigned int const nV3) :
+	m_nV1(nV1), m_nV2(nV2), m_nV3(nV3),
+	m_classes((size_t)nV1 * nV2 * nV3, VoxelClass::OUTER_BLACK) {
+
+}
+
+
+// EXTERIOR FLOOD FILL...
+// every voxel that is connected (6-neighbourhood) to the grid boundary through non-feature voxels is outside the model, everything else that isn't a feature voxel is enclosed by the model surface and thus INNER
+//NOTE: this replaces the old scanline algorithm that relied on averaged face normals (it wrongly marked voxels whenever the averaged normal pointed the wrong way)
+//NOTE: the fill is run as a parallel wavefront (BFS), each wave is split over the worker threads and every thread collects its part of the next wave in its own reusable buffer
+void VoxelGrid::classifyInnerVoxels() {
+	size_t const voxelCount = m_classes.size();
+	if (0 == voxelCount) return;
+
+	// reached[v] == 1 means voxel v has been reached from the boundary
+	//NOTE: value-initialized, so every flag starts at 0
+	std::vector<std::atomic<unsigned char>> reached(voxelCount);
+
+	// tries to claim voxel v for the exterior (true only for the one thread that actually claimed it)
+	auto claim = [this, &reached](size_t const v) -> bool {
+		if (VoxelClass::FEATURE_CYAN == m_classes[v]) return false;
+		if (0 != reached[v].load(std::memory_order_relaxed)) return false;
+		return 0 == reached[v].exchange(1, std::memory_order_relaxed);
+	};
+
+	// 1. seed the first wave with all the non-feature voxels on the 6 faces of the grid...
+	std::vector<size_t> wave;
+	for (unsigned int i = 0; i < m_nV3; ++i) {
+		for (unsigned int j = 0; j < m_nV2; ++j) {
+			bool const onBoundaryIJ = 0 == i || m_nV3 - 1 == i || 0 == j || m_nV2 - 1 == j;
+			if (onBoundaryIJ) {
+				for (unsigned int k = 0; k < m_nV1; ++k) {
+					size_t const v = toIndex(i, j, k);
+					if (claim(v)) wave.push_back(v);
+				}
+			} else {
+				size_t const vLow = toIndex(i, j, 0);
+				size_t const vHigh = toIndex(i, j, m_nV1 - 1);
+				if (claim(vLow)) wave.push_back(vLow);
+				if (claim(vHigh)) wave.push_back(vHigh);
+			}
+		}
+	}
+
+	// 2. expand the wavefront until no new voxels get reached...
+	size_t const strideV2 = m_nV1;
+	size_t const strideV3 = (size_t)m_nV1 * m_nV2;
+
+	std::vector<std::vector<size_t>> nextWaves(ParallelTools::getThreadCount());
+
+	while (!wave.empty()) {
+		for (std::vector<size_t> &nextWave : nextWaves) nextWave.clear(); // keeps capacity
+
+		ParallelTools::parallelForRange(wave.size(), [&](size_t const begin, size_t const end, unsigned int const threadIndex) {
+			std::vector<size_t> &nextWave = nextWaves[threadIndex];
+
+			for (size_t w = begin; w < end; ++w) {
+				size_t const v = wave[w];
+
+				// recover (i, j, k) from the packed index...
+				unsigned int const k = v % m_nV1;
+				unsigned int const j = (v / strideV2) % m_nV2;
+				unsigned int const i = (unsigned int)(v / strideV3);
+
+				if (k > 0 && claim(v - 1)) nextWave.push_back(v - 1);
+				if (k + 1 < m_nV1 && claim(v + 1)) nextWave.push_back(v + 1);
+				if (j > 0 && claim(v - strideV2)) nextWave.push_back(v - strideV2);
+				if (j + 1 < m_nV2 && claim(v + strideV2)) nextWave.push_back(v + strideV2);
+				if (i > 0 && claim(v - strideV3)) nextWave.push_back(v - strideV3);
+				if (i + 1 < m_nV3 && claim(v + strideV3)) nextWave.push_back(v + strideV3);
+			}
+		}, 256);
+
+		wave.clear();
+		for (std::vector<size_t> const& nextWave : nextWaves) wave.insert(wave.end(), nextWave.begin(), nextWave.end());
+	}
+
+	// 3. anything that wasn't reached (and isn't a feature voxel) is enclosed by the model...
+	ParallelTools::parallelFor(voxelCount, [this, &reached](size_t const v) {
+		if (VoxelClass::FEATURE_CYAN != m_classes[v] && 0 == reached[v].load(std::memory_order_relaxed)) m_classes[v] = VoxelClass::INNER_MAGENTA;
+	}, 1 << 16);
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+
+// voxel classes (BLACK =:= OUTER (default), CYAN =:= FEATURE, MAGENTA =:= INNER)
+// those colours can be assigned later if we want to render the voxels
+enum VoxelClass : unsigned char {
+	OUTER_BLACK = 0,
+	FEATURE_CYAN = 1,
+	INNER_MAGENTA = 2,
+};
+
+
+// packed 3D grid of voxel classes
+//NOTE: voxel (i, j, k) is i on V3, j on V2, k on V1 (same convention as the obb space) and is stored at ((i * nV2) + j) * nV1 + k, so k is the fastest varying index
+class VoxelGrid {
+
+public:
+	VoxelGrid(unsigned int const nV1, unsigned int const nV2, unsigned int const nV3);
+
+	unsigned int getNV1() const { return m_nV1; }
+	unsigned int getNV2() const { return m_nV2; }
+	unsigned int getNV3() const { return m_nV3; }
+	size_t getVoxelCount() const { return m_classes.size(); }
+
+	size_t toIndex(unsigned int const i, unsigned int const j, unsigned int const k) const { return ((size_t)i * m_nV2 + j) * m_nV1 + k; }
+
+	VoxelClass get(unsigned int const i, unsigned int const j, unsigned int const k) const { return m_classes[toIndex(i, j, k)]; }
+	void set(unsigned int const i, unsigned int const j, unsigned int const k, VoxelClass const voxelClass) { m_classes[toIndex(i, j, k)] = voxelClass; }
+
+	std::vector<VoxelClass> const& getClasses() const { return m_classes; }
+
+	// marks every non-feature voxel that cannot be reached from the grid boundary (without passing through a feature voxel) as INNER
+	//NOTE: assumes the feature voxels have already been marked and that everything else is still OUTER
+	void classifyInnerVoxels();
+
+private:
+	unsigned int m_nV1 = 0;
+	unsigned int m_nV2 = 0;
+	unsigned int m_nV3 = 0;
+
+	std::vector<VoxelClass> m_classes;
+};
@@ -0,0 +1,147 @@
+#include "WindingNumber.h"
+
+#include <glm/gtc/constants.hpp>
+
+#include "ParallelTools.h"
+
+namespace {
+	unsigned int const s_MAX_STACK_DEPTH = 65; // BVH depth + 1
+}
+
+
+bool WindingNumber::build(std::vector<glm::vec3> const& verts, std::vector<unsigned int> const& faceIndices, float const accuracy) {
+	m_dipoles.clear();
+	m_accuracy = accuracy;
+	if (!m_bvh.build(verts, faceIndices)) return false;
+
+	std::vector<BVH::Node> const& nodes = m_bvh.getNodes();
+	m_tolerance = 1e-6f * glm::length(nodes.at(0).m_max - nodes.at(0).m_min);
+
+	// dipoles - leaves from their faces (in parallel), then the inner nodes bottom up from their children (children always come after their parent)
+	m_dipoles.resize(nodes.size());
+	ParallelTools::parallelFor(nodes.size(), [&](size_t const n) {
+		BVH::Node const& node = nodes[n];
+		if (!node.isLeaf()) return;
+
+		Dipole dipole;
+		dipole.m_areaNormal = glm::vec3(0.0f);
+		dipole.m_area = 0.0f;
+		glm::vec3 weightedCentre(0.0f);
+		glm::vec3 centroidSum(0.0f);
+		for (unsigned int slot = node.m_offset; slot < node.m_offset + node.m_count; ++slot) {
+			glm::vec3 const& a = m_bvh.getTriangleVert(slot, 0);
+			glm::vec3 const& b = m_bvh.getTriangleVert(slot, 1);
+			glm::vec3 const& c = m_bvh.getTriangleVert(slot, 2);
+			glm::vec3 const n = 0.5f * glm::cross(b - a, c - a);
+			float const area = glm::length(n);
+			glm::vec3 const centroid = (a + b + c) / 3.0f;
+			dipole.m_areaNormal += n;
+			dipole.m_area += area;
+			weightedCentre += area * centroid;
+			centroidSum += centroid;
+		}
+		//NOTE: falls back to the plain centroid for (degenerate) zero area faces
+		dipole.m_centre = dipole.m_area > 0.0f ? weightedCentre / dipole.m_area : centroidSum / (float)node.m_count;
+
+		dipole.m_radius = 0.0f;
+		for (unsigned int slot = node.m_offset; slot < node.m_offset + node.m_count; ++slot) {
+			for (unsigned int c = 0; c < 3; ++c) dipole.m_radius = glm::max(dipole.m_radius, glm::length(m_bvh.getTriangleVert(slot, c) - dipole.m_centre));
+		}
+		m_dipoles[n] = dipole;
+	});
+
+	for (size_t n = nodes.size(); n-- > 0;) {
+		BVH::Node const& node = nodes[n];
+		if (node.isLeaf()) continue;
+
+		Dipole const& d0 = m_dipoles[node.m_offset];
+		Dipole const& d1 = m_dipoles[node.m_offset + 1];
+		Dipole &dipole = m_dipoles[n];
+		dipole.m_areaNormal = d0.m_areaNormal + d1.m_areaNormal;
+		dipole.m_area = d0.m_area + d1.m_area;
+		dipole.m_centre = dipole.m_area > 0.0f ? (d0.m_area * d0.m_centre + d1.m_area * d1.m_centre) / dipole.m_area : 0.5f * (d0.m_centre + d1.m_centre);
+		dipole.m_radius = glm::max(glm::length(d0.m_centre - dipole.m_centre) + d0.m_radius, glm::length(d1.m_centre - dipole.m_centre) + d1.m_radius);
+	}
+	return true;
+}
+
+
+// reference: Van Oosterom, Strackee - The Solid Angle of a Plane Triangle (1983)
+float WindingNumber::computeSolidAngle(unsigned int const slot, glm::vec3 const& q, bool &out_isOnSurface) const {
+	glm::vec3 const a = m_bvh.getTriangleVert(slot, 0) - q;
+	glm::vec3 const b = m_bvh.getTriangleVert(slot, 1) - q;
+	glm::vec3 const c = m_bvh.getTriangleVert(slot, 2) - q;
+
+	// q on the face (the formula below is discontinuous there)...
+	glm::vec3 const n = glm::cross(b - a, c - a);
+	float const nLength = glm::length(n);
+	if (nLength > 0.0f && glm::abs(glm::dot(a, n)) <= m_tolerance * nLength) {
+		if (glm::dot(glm::cross(a, b), n) >= 0.0f && glm::dot(glm::cross(b, c), n) >= 0.0f && glm::dot(glm::cross(c, a), n) >= 0.0f) {
+			out_isOnSurface = true;
+			return 0.0f;
+		}
+	}
+
+	float const la = glm::length(a);
+	float const lb = glm::length(b);
+	float const lc = glm::length(c);
+	if (la <= m_tolerance || lb <= m_tolerance || lc <= m_tolerance) { // q on a vert (also catches zero area faces)
+		out_isOnSurface = true;
+		return 0.0f;
+	}
+
+	float const det = glm::dot(a, glm::cross(b, c));
+	float const denominator = la * lb * lc + glm::dot(a, b) * lc + glm::dot(b, c) * la + glm::dot(c, a) * lb;
+	return 2.0f * glm::atan(det, denominator);
+}
+
+
+float WindingNumber::evaluate(glm::vec3 const& q, bool &out_isOnSurface) const {
+	out_isOnSurface = false;
+	if (m_bvh.isEmpty()) return 0.0f;
+
+	std::vector<BVH::Node> const& nodes = m_bvh.getNodes();
+	float solidAngle = 0.0f;
+
+	unsigned int stack[s_MAX_STACK_DEPTH];
+	unsigned int stackSize = 0;
+	stack[stackSize++] = 0;
+	while (stackSize > 0) {
+		unsigned int const nodeIndex = stack[--stackSize];
+		BVH::Node const& node = nodes[nodeIndex];
+		Dipole const& dipole = m_dipoles[nodeIndex];
+
+		glm::vec3 const d = dipole.m_centre - q;
+		float const distanceSq = glm::dot(d, d);
+		float const farDistance = m_accuracy * dipole.m_radius;
+
+		// far field - dipole term of the node's faces
+		if (distanceSq > farDistance * farDistance) {
+			solidAngle += glm::dot(d, dipole.m_areaNormal) / (distanceSq * glm::sqrt(distanceSq));
+			continue;
+		}
+
+		if (node.isLeaf()) {
+			for (unsigned int slot = node.m_offset; slot < node.m_offset + node.m_count; ++slot) solidAngle += computeSolidAngle(slot, q, out_isOnSurface);
+			continue;
+		}
+
+		stack[stackSize++] = node.m_offset + 1;
+		stack[stackSize++] = node.m_offset;
+	}
+
+	//NOTE: the winding number jumps from 1 to 0 across the surface, so points on it get the average of both sides
+	return out_isOnSurface ? 0.5f : solidAngle / (4.0f * glm::pi<float>());
+}
+
+
+void WindingNumber::evaluateAll(std::vector<glm::vec3> const& points, std::vector<float> &out_windingNumbers, std::vector<unsigned char> &out_isOnSurface) const {
+	out_windingNumbers.resize(points.size());
+	out_isOnSurface.resize(points.size());
+
+	ParallelTools::parallelFor(points.size(), [&](size_t const i) {
+		bool isOnSurface = false;
+		out_windingNumbers[i] = evaluate(points[i], isOnSurface);
+		out_isOnSurface[i] = isOnSurface ? 1 : 0;
+	}, 4096);
+}
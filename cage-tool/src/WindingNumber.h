@@ -0,0 +1,45 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "BVH.h"
+
+
+// generalized winding number of a triangle mesh - 1 inside, 0 outside (fractional around holes, 0.5 exactly on the surface)
+// reference: Jacobson, Kavan, Sorkine-Hornung - Robust Inside-Outside Segmentation using Generalized Winding Numbers (2013)
+// reference: Barill, Dickson, Schmidt, Levin, Jacobson - Fast Winding Numbers for Soups and Clouds (2018)
+// 1. a BVH over the faces, every node additionally stores the dipole of its faces (area weighted normal sum + centre) and a bounding radius
+// 2. nodes far enough from the query (distance > m_accuracy * radius) contribute through their dipole, close ones are descended into (leaves sum the exact solid angles of their faces)
+//NOTE: queries only read the tree, so evaluateAll just splits the points over the hardware threads
+class WindingNumber {
+
+public:
+	// RETURNS false if there are no faces
+	//NOTE: faces are 3 indices in a row into verts (CCW when seen from outside)
+	//NOTE: accuracy trades speed for precision (2 is the value recommended by Barill et al., larger is more precise)
+	bool build(std::vector<glm::vec3> const& verts, std::vector<unsigned int> const& faceIndices, float const accuracy = 2.0f);
+
+	// out_isOnSurface is set if q lies on a face (within a tolerance relative to the mesh size), the RETURN is then exactly 0.5
+	float evaluate(glm::vec3 const& q, bool &out_isOnSurface) const;
+
+	// evaluates every point in parallel (out_isOnSurface holds 1 for points on a face, 0 otherwise)
+	void evaluateAll(std::vector<glm::vec3> const& points, std::vector<float> &out_windingNumbers, std::vector<unsigned char> &out_isOnSurface) const;
+
+private:
+	// indexed like the BVH nodes
+	struct Dipole {
+		glm::vec3 m_centre; // area weighted centroid of the node's faces (expansion point of the dipole)
+		glm::vec3 m_areaNormal; // sum of the face normals scaled by their areas
+		float m_area;
+		float m_radius; // distance from m_centre to the farthest vert of the node's faces
+	};
+
+	BVH m_bvh;
+	std::vector<Dipole> m_dipoles;
+	float m_accuracy = 2.0f;
+	float m_tolerance = 0.0f; // on surface distance
+
+	// solid angle of the triangle in BVH slot seen from q, 0 (and out_isOnSurface set) if q lies on the triangle
+	float computeSolidAngle(unsigned int const slot, glm::vec3 const& q, bool &out_isOnSurface) const;
+};
@@ -1,6 +1,23 @@
 #include "Program.h"
 
-int main() {
+#include <charconv>
+#include <cstring>
+
+#include "StreamingDeformer.h"
+
+int main(int argc, char* argv[]) {
+
+	// headless (no window): cage-tool --deform model.ply restCage.obj posedCage.obj output.ply [vertsPerChunk]
+	if (argc > 1 && 0 == std::strcmp(argv[1], "--deform")) {
+		size_t chunkVertCount = StreamingDeformer::s_DEFAULT_CHUNK_VERT_COUNT;
+		bool const isChunkValid = argc < 7 || std::from_chars(argv[6], argv[6] + std::strlen(argv[6]), chunkVertCount).ptr == argv[6] + std::strlen(argv[6]);
+		if ((6 != argc && 7 != argc) || !isChunkValid || 0 == chunkVertCount) {
+			std::cout << "usage: cage-tool --deform model.ply restCage.obj posedCage.obj output.ply [vertsPerChunk]" << std::endl;
+			return 1;
+		}
+		return StreamingDeformer::deformPLY(argv[2], argv[3], argv[4], argv[5], chunkVertCount) ? 0 : 1;
+	}
+
 	Program p = Program();
 	p.start();
 	return 0;